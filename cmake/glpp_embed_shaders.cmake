@@ -0,0 +1,47 @@
+# Script mode part of glpp_embed_shaders(), run at build time:
+#   cmake -DOUTPUT=<header> -DNAME=<identifier> -DNAMESPACE=<namespace>
+#         -DBASE_DIRECTORY=<directory> -DFILES=<file>|<file>...
+#         -P glpp_embed_shaders.cmake
+
+string(REPLACE "|" ";" files "${FILES}")
+
+set(data "")
+set(table "")
+set(index 0)
+foreach(file IN LISTS files)
+  file(READ "${file}" hex HEX)
+  file(SIZE "${file}" size)
+  # Character literals, as integers above 0x7f would narrow to char.
+  string(REGEX REPLACE "([0-9a-f][0-9a-f])" "'\\\\x\\1'," bytes "${hex}")
+  file(RELATIVE_PATH path "${BASE_DIRECTORY}" "${file}")
+  string(REPLACE "\\" "\\\\" path "${path}")
+  string(REPLACE "\"" "\\\"" path "${path}")
+
+  # Null terminated, as empty arrays are not allowed.
+  string(APPEND data "        inline constexpr char file_${index}[] = {${bytes}'\\0'};\n")
+  string(APPEND table "        glpp::EmbeddedShaderFile{\"${path}\", {${NAME}_data::file_${index}, ${size}}},\n")
+  math(EXPR index "${index} + 1")
+endforeach()
+
+set(header "// Generated by glpp_embed_shaders(), do not edit.
+#pragma once
+
+#include <array>
+
+#include <glpp/embedded_shader_filesystem.hpp>
+
+namespace ${NAMESPACE}
+{
+    namespace ${NAME}_data
+    {
+${data}    }
+
+    inline constexpr auto ${NAME} = std::array{
+${table}    };
+}
+")
+
+# Only touched when the contents change, so dependents are not rebuilt.
+file(WRITE "${OUTPUT}.tmp" "${header}")
+configure_file("${OUTPUT}.tmp" "${OUTPUT}" COPYONLY)
+file(REMOVE "${OUTPUT}.tmp")
@@ -0,0 +1,130 @@
+set(GLPP_EMBED_SHADERS_SCRIPT "${CMAKE_CURRENT_LIST_DIR}/glpp_embed_shaders.cmake")
+# Where glpp_bundle_shaders is when this module is installed in lib/cmake/glpp.
+get_filename_component(GLPP_INSTALLED_BIN_DIR "${CMAKE_CURRENT_LIST_DIR}/../../../bin" ABSOLUTE)
+
+# glpp_add_shader_bundle(
+#   <target>
+#   OUTPUT <bundle file>
+#   CONFIGS <shader program config>...
+#   [WORKING_DIRECTORY <directory>]
+# )
+#
+# Adds a target writing the shader programs into a bundle,
+# see glpp::ShaderBundle; requires BUILD_CONFIG. Source paths in the configs are relative
+# to the working directory, the project root by default.
+function(glpp_add_shader_bundle target)
+  cmake_parse_arguments(
+    PARSE_ARGV 1 BUNDLE
+    ""
+    "OUTPUT;WORKING_DIRECTORY"
+    "CONFIGS"
+  )
+  if(NOT BUNDLE_OUTPUT OR NOT BUNDLE_CONFIGS)
+    message(FATAL_ERROR "glpp_add_shader_bundle: OUTPUT and CONFIGS are required")
+  endif()
+  if(NOT BUNDLE_WORKING_DIRECTORY)
+    set(BUNDLE_WORKING_DIRECTORY "${PROJECT_SOURCE_DIR}")
+  endif()
+
+  # The tool is a target within the glpp build, and installed
+  # next to this module otherwise.
+  if(TARGET glpp_bundle_shaders)
+    set(tool glpp_bundle_shaders)
+  else()
+    find_program(
+      GLPP_BUNDLE_SHADERS_EXECUTABLE glpp_bundle_shaders
+      HINTS "${GLPP_INSTALLED_BIN_DIR}"
+    )
+    if(NOT GLPP_BUNDLE_SHADERS_EXECUTABLE)
+      message(FATAL_ERROR "glpp_add_shader_bundle: glpp_bundle_shaders not found")
+    endif()
+    set(tool "${GLPP_BUNDLE_SHADERS_EXECUTABLE}")
+  endif()
+
+  get_filename_component(output "${BUNDLE_OUTPUT}" ABSOLUTE BASE_DIR "${CMAKE_CURRENT_BINARY_DIR}")
+  set(configs)
+  foreach(config IN LISTS BUNDLE_CONFIGS)
+    get_filename_component(config "${config}" ABSOLUTE BASE_DIR "${BUNDLE_WORKING_DIRECTORY}")
+    list(APPEND configs "${config}")
+  endforeach()
+
+  # Included sources are only known to the tool; it reports them
+  # in a depfile where the generator supports one.
+  set(depfile_args)
+  set(depfile_option)
+  if(CMAKE_GENERATOR MATCHES "Ninja" OR CMAKE_VERSION VERSION_GREATER_EQUAL 3.20)
+    set(depfile "${CMAKE_CURRENT_BINARY_DIR}/${target}.d")
+    set(depfile_args DEPFILE "${depfile}")
+    set(depfile_option --depfile "${depfile}")
+  endif()
+
+  add_custom_command(
+    OUTPUT "${output}"
+    COMMAND "${tool}" "${output}" ${depfile_option} ${configs}
+    DEPENDS "${tool}" ${configs}
+    ${depfile_args}
+    WORKING_DIRECTORY "${BUNDLE_WORKING_DIRECTORY}"
+    COMMENT "Bundling shaders into ${BUNDLE_OUTPUT}"
+    VERBATIM
+  )
+  add_custom_target("${target}" DEPENDS "${output}")
+endfunction()
+
+# glpp_embed_shaders(
+#   <target>
+#   NAME <identifier>
+#   FILES <file>...
+#   [NAMESPACE <namespace>]
+#   [BASE_DIRECTORY <directory>]
+# )
+#
+# Compiles the files into the target, as a constexpr std::array of
+# glpp::EmbeddedShaderFile named <namespace>::<identifier> (glpp::embedded
+# by default) in the generated header <identifier>.hpp; see
+# glpp::EmbeddedShaderFilesystem. Included files have to be listed too.
+# Embedded paths are relative to the base directory, the project root
+# by default, so that shader configs resolve the same as from disk.
+function(glpp_embed_shaders target)
+  cmake_parse_arguments(
+    PARSE_ARGV 1 EMBED
+    ""
+    "NAME;NAMESPACE;BASE_DIRECTORY"
+    "FILES"
+  )
+  if(NOT EMBED_NAME OR NOT EMBED_FILES)
+    message(FATAL_ERROR "glpp_embed_shaders: NAME and FILES are required")
+  endif()
+  if(NOT EMBED_NAMESPACE)
+    set(EMBED_NAMESPACE glpp::embedded)
+  endif()
+  if(NOT EMBED_BASE_DIRECTORY)
+    set(EMBED_BASE_DIRECTORY "${PROJECT_SOURCE_DIR}")
+  endif()
+
+  set(files)
+  foreach(file IN LISTS EMBED_FILES)
+    get_filename_component(file "${file}" ABSOLUTE)
+    list(APPEND files "${file}")
+  endforeach()
+  string(REPLACE ";" "|" files_argument "${files}")
+
+  set(directory "${CMAKE_CURRENT_BINARY_DIR}/glpp_embedded/${target}")
+  set(header "${directory}/${EMBED_NAME}.hpp")
+  file(MAKE_DIRECTORY "${directory}")
+
+  add_custom_command(
+    OUTPUT "${header}"
+    COMMAND "${CMAKE_COMMAND}"
+      "-DOUTPUT=${header}"
+      "-DNAME=${EMBED_NAME}"
+      "-DNAMESPACE=${EMBED_NAMESPACE}"
+      "-DBASE_DIRECTORY=${EMBED_BASE_DIRECTORY}"
+      "-DFILES=${files_argument}"
+      -P "${GLPP_EMBED_SHADERS_SCRIPT}"
+    DEPENDS ${files} "${GLPP_EMBED_SHADERS_SCRIPT}"
+    COMMENT "Embedding shaders into ${EMBED_NAME}.hpp"
+    VERBATIM
+  )
+  target_sources("${target}" PRIVATE "${header}")
+  target_include_directories("${target}" PRIVATE "${directory}")
+endfunction()
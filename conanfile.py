@@ -15,22 +15,31 @@ class Glpp(ConanFile):
         "shared": [True, False],
         "fPIC": [True, False],
         "with_glfw": [True, False],
+        "with_headless": [True, False],
+        "with_image": [True, False],
         "with_config": [True, False],
         "with_imgui": [True, False],
         "with_examples": [True, False],
+        "with_benchmarks": [True, False],
     }
     default_options = {
         "shared": False,
         "fPIC": True,
         "with_glfw": True,
+        "with_headless": False,
+        "with_image": False,
         "with_config": True,
         "with_imgui": True,
         "with_examples": True,
+        "with_benchmarks": False,
         "glad:gl_version": "4.5",
+        "glad:extensions": "GL_KHR_parallel_shader_compile,GL_ARB_parallel_shader_compile,GL_ARB_gl_spirv",
     }
     exports_sources = (
         "src/*",
         "examples/*",
+        "tools/*",
+        "cmake/*",
         "CMakeLists.txt",
     )
     requires = (
@@ -47,6 +56,13 @@ class Glpp(ConanFile):
             self.requires("boost/1.77.0")
             self.requires("glfw/3.3.2")
 
+        if self.options.with_headless:
+            self.requires("egl/system")
+
+        if self.options.with_image:
+            self.requires("libjpeg/9d")
+            self.requires("libpng/1.6.37")
+
         if self.options.with_config:
             self.requires("nlohmann_json/3.9.1")
 
@@ -70,8 +86,11 @@ class Glpp(ConanFile):
 
         tc = CMakeToolchain(self)
         tc.variables["BUILD_EXAMPLES"] = self.options.with_examples
+        tc.variables["BUILD_BENCHMARKS"] = self.options.with_benchmarks
         tc.variables["BUILD_CONFIG"] = self.options.with_config
         tc.variables["BUILD_GLFW"] = self.options.with_glfw
+        tc.variables["BUILD_HEADLESS"] = self.options.with_headless
+        tc.variables["BUILD_IMAGE"] = self.options.with_image
         tc.variables["BUILD_IMGUI"] = self.options.with_imgui
         tc.generate()
 
@@ -86,8 +105,13 @@ class Glpp(ConanFile):
 
     def package_id(self):
         del self.info.options.with_examples
+        del self.info.options.with_benchmarks
 
     def package_info(self):
+        # glpp_add_shader_bundle() and glpp_embed_shaders()
+        self.cpp_info.set_property("cmake_build_modules", ["lib/cmake/glpp/glpp_shaders.cmake"])
+        self.cpp_info.builddirs.append("lib/cmake/glpp")
+
         self.cpp_info.components["core"].libs = ["glpp_core"]
         self.cpp_info.components["core"].requires = [
             "fmt::fmt",
@@ -102,6 +126,14 @@ class Glpp(ConanFile):
             self.cpp_info.components["glfw"].libs = ["glpp_glfw"]
             self.cpp_info.components["glfw"].requires = ["boost::boost", "glfw::glfw", "core"]
 
+        if self.options.with_headless:
+            self.cpp_info.components["headless"].libs = ["glpp_headless"]
+            self.cpp_info.components["headless"].requires = ["egl::egl", "core"]
+
+        if self.options.with_image:
+            self.cpp_info.components["image"].libs = ["glpp_image"]
+            self.cpp_info.components["image"].requires = ["libjpeg::libjpeg", "libpng::libpng", "core"]
+
         if self.options.with_config:
             self.cpp_info.components["config"].libs = ["glpp_config"]
             self.cpp_info.components["config"].requires = ["nlohmann_json::nlohmann_json", "core"]
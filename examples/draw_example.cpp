@@ -1,6 +1,5 @@
 #include <array>
 #include <filesystem>
-#include <fstream>
 #include <iostream>
 #include <stdexcept>
 #include <thread>
@@ -9,6 +8,7 @@
 #include <glpp/buffer.hpp>
 #include <glpp/config/config.hpp>
 #include <glpp/draw.hpp>
+#include <glpp/embedded_shader_filesystem.hpp>
 #include <glpp/glfw/glfw.hpp>
 #include <glpp/glfw/window.hpp>
 #include <glpp/scoped_bind.hpp>
@@ -17,6 +17,8 @@
 #include <glpp/vertex_array.hpp>
 #include <nlohmann/json.hpp>
 
+#include "draw_example_shaders.hpp"
+
 namespace
 {
     auto const shader_cfg_path = std::filesystem::path{
@@ -30,16 +32,11 @@ auto main() noexcept -> int
 
     try
     {
-        // Load the shader program config file
-        auto shader_cfg_file = std::ifstream{shader_cfg_path};
-        if (!shader_cfg_file.is_open())
-        {
-            std::cerr << "Could not open shader config.\n"
-                         "Run this example from the project root.\n";
-            return 1;
-        }
-        auto shader_cfg_json = nlohmann::json();
-        shader_cfg_file >> shader_cfg_json;
+        // The shader sources and config are embedded in the executable
+        auto const shader_files = glpp::EmbeddedShaderFilesystem{
+            glpp::embedded::draw_example_shaders,
+        };
+        auto const shader_cfg_json = nlohmann::json::parse(shader_files.contents(shader_cfg_path));
 
         // Create the window
         auto glfw = glpp::glfw::Glfw{};
@@ -55,7 +52,9 @@ auto main() noexcept -> int
         };
 
         // Create GL structures
-        auto shader_program = glpp::config::make_shader_program(shader_cfg_json);
+        auto shader_program = glpp::config::make_shader_program(
+            shader_cfg_json.get<glpp::config::ShaderProgramConfig>(),
+            shader_files);
         auto vertex_pos_buffer = glpp::StaticAttribBuffer<float>{};
         auto vertex_array = glpp::VertexArray{};
         vertex_array.bind_attribute_buffer(
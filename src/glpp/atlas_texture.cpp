@@ -0,0 +1,331 @@
+#include "glpp/atlas_texture.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace glpp
+{
+    SkylinePacker::SkylinePacker(Size const width, Size const height)
+      : width_{width}, height_{height}
+    {
+        clear();
+    }
+
+    auto SkylinePacker::insert(Size const width, Size const height)
+        -> std::optional<AtlasRect>
+    {
+        auto best_index = std::optional<std::size_t>{};
+        auto best_rect = AtlasRect{};
+        auto best_segment_width = Size{};
+
+        for (auto i = std::size_t{0}; i < skyline_.size(); ++i)
+        {
+            if (auto const y = fit(i, width, height))
+            {
+                auto const better
+                    = !best_index
+                      || *y + height < best_rect.y + best_rect.height
+                      || (*y + height == best_rect.y + best_rect.height
+                          && skyline_[i].width < best_segment_width);
+                if (better)
+                {
+                    best_index = i;
+                    best_rect = AtlasRect{skyline_[i].x, *y, width, height};
+                    best_segment_width = skyline_[i].width;
+                }
+            }
+        }
+
+        if (!best_index)
+        {
+            return std::nullopt;
+        }
+
+        add_segment(*best_index, best_rect);
+        return best_rect;
+    }
+
+    void SkylinePacker::clear()
+    {
+        skyline_.clear();
+        skyline_.push_back(Segment{0, 0, width_});
+    }
+
+    auto SkylinePacker::fit(
+        std::size_t index,
+        Size const width,
+        Size const height) const
+        -> std::optional<Int32>
+    {
+        auto const x = skyline_[index].x;
+        if (x + width > width_)
+        {
+            return std::nullopt;
+        }
+
+        auto y = Int32{0};
+        auto width_left = width;
+        for (; width_left > 0; ++index)
+        {
+            assert(index < skyline_.size());
+
+            y = std::max(y, skyline_[index].y);
+            if (y + height > height_)
+            {
+                return std::nullopt;
+            }
+            width_left -= skyline_[index].width;
+        }
+
+        return y;
+    }
+
+    void SkylinePacker::add_segment(std::size_t const index, AtlasRect const rect)
+    {
+        skyline_.insert(
+            skyline_.begin() + static_cast<std::ptrdiff_t>(index),
+            Segment{rect.x, rect.y + rect.height, rect.width});
+
+        // Shrink or remove the segments now covered by the new one.
+        auto const right = rect.x + rect.width;
+        auto next = index + 1;
+        while (next < skyline_.size() && skyline_[next].x < right)
+        {
+            auto& segment = skyline_[next];
+            auto const segment_right = segment.x + segment.width;
+            if (segment_right <= right)
+            {
+                skyline_.erase(skyline_.begin() + static_cast<std::ptrdiff_t>(next));
+            }
+            else
+            {
+                segment.width = segment_right - right;
+                segment.x = right;
+                break;
+            }
+        }
+
+        // Merge neighbouring segments of equal height.
+        for (auto i = std::size_t{0}; i + 1 < skyline_.size();)
+        {
+            if (skyline_[i].y == skyline_[i + 1].y)
+            {
+                skyline_[i].width += skyline_[i + 1].width;
+                skyline_.erase(skyline_.begin() + static_cast<std::ptrdiff_t>(i + 1));
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+
+    AtlasTexture::AtlasTexture(
+        Size const width,
+        Size const height,
+        Options const options)
+      : options_{options}
+      , texture_{allocate_texture(width, height)}
+      , packer_{width, height}
+    {
+        if (options_.max_size == 0)
+        {
+            glGetIntegerv(GL_MAX_TEXTURE_SIZE, &options_.max_size);
+        }
+    }
+
+    auto AtlasTexture::add(Texture::Data const data) -> std::optional<AtlasEntry>
+    {
+        auto padded_rect = packer_.insert(padded(data.width), padded(data.height));
+
+        // Try to reclaim space of removed entries first, then grow.
+        // Repacking at the current size is pointless unless removals
+        // freed at least as much space as the image needs.
+        auto const pending_area = Int64{padded(data.width)} * padded(data.height);
+        auto width = packer_.width();
+        auto height = packer_.height();
+        while (!padded_rect)
+        {
+            auto const grown = width != packer_.width() || height != packer_.height();
+            if (grown || freed_area_ >= pending_area)
+            {
+                padded_rect = repack(width, height, padded(data.width), padded(data.height));
+                if (padded_rect)
+                {
+                    break;
+                }
+            }
+
+            if (width >= options_.max_size && height >= options_.max_size)
+            {
+                return std::nullopt;
+            }
+
+            if (width <= height)
+            {
+                width = std::min(width * 2, options_.max_size);
+            }
+            else
+            {
+                height = std::min(height * 2, options_.max_size);
+            }
+        }
+
+        auto const rect = AtlasRect{
+            padded_rect->x + options_.padding,
+            padded_rect->y + options_.padding,
+            data.width,
+            data.height,
+        };
+        texture_.update(data, rect.x, rect.y);
+
+        auto const entry = AtlasEntry{next_entry_++};
+        entries_.emplace(entry.value, rect);
+
+        return entry;
+    }
+
+    void AtlasTexture::remove(AtlasEntry const entry)
+    {
+        // The freed space is reclaimed on the next repack.
+        auto const iter = entries_.find(entry.value);
+        if (iter != entries_.end())
+        {
+            freed_area_ += Int64{padded(iter->second.width)} * padded(iter->second.height);
+            entries_.erase(iter);
+        }
+    }
+
+    auto AtlasTexture::contains(AtlasEntry const entry) const -> bool
+    {
+        return entries_.find(entry.value) != entries_.end();
+    }
+
+    auto AtlasTexture::rect(AtlasEntry const entry) const -> AtlasRect
+    {
+        auto const iter = entries_.find(entry.value);
+        assert(iter != entries_.end());
+
+        return iter->second;
+    }
+
+    auto AtlasTexture::uv_rect(AtlasEntry const entry) const -> UvRect
+    {
+        auto const entry_rect = rect(entry);
+        auto const width = static_cast<float>(texture_.width());
+        auto const height = static_cast<float>(texture_.height());
+
+        return UvRect{
+            glm::vec2{
+                static_cast<float>(entry_rect.x) / width,
+                static_cast<float>(entry_rect.y) / height,
+            },
+            glm::vec2{
+                static_cast<float>(entry_rect.x + entry_rect.width) / width,
+                static_cast<float>(entry_rect.y + entry_rect.height) / height,
+            },
+        };
+    }
+
+    auto AtlasTexture::allocate_texture(Size const width, Size const height) const
+        -> Texture
+    {
+        // Mipmaps would bleed neighbouring entries into each other.
+        return Texture{
+            Texture::Data{width, height, options_.format},
+            options_.internal_format,
+            Texture::Filter{
+                Texture::BasicFilterType::linear,
+                Texture::BasicFilterType::linear,
+            },
+            Texture::WrapBehaviour{
+                Texture::WrapBehaviourType::clamp_to_edge,
+                Texture::WrapBehaviourType::clamp_to_edge,
+            },
+            Texture::SwizzleMask{},
+        };
+    }
+
+    auto AtlasTexture::repack(
+        Size const atlas_width,
+        Size const atlas_height,
+        Size const pending_width,
+        Size const pending_height)
+        -> std::optional<AtlasRect>
+    {
+        // Tallest first gives the skyline packer the flattest horizon.
+        auto order = std::vector<std::pair<UInt32, AtlasRect>>{
+            entries_.begin(),
+            entries_.end(),
+        };
+        std::sort(
+            order.begin(),
+            order.end(),
+            [](auto const& lhs, auto const& rhs) {
+                return std::pair{lhs.second.height, lhs.second.width}
+                       > std::pair{rhs.second.height, rhs.second.width};
+            });
+
+        auto packer = SkylinePacker{atlas_width, atlas_height};
+        auto placed = std::vector<AtlasRect>{};
+        placed.reserve(order.size());
+        for (auto const& [value, entry_rect] : order)
+        {
+            auto const padded_rect = packer.insert(
+                padded(entry_rect.width),
+                padded(entry_rect.height));
+            if (!padded_rect)
+            {
+                return std::nullopt;
+            }
+            placed.push_back(*padded_rect);
+        }
+
+        auto const pending_rect = packer.insert(pending_width, pending_height);
+        if (!pending_rect)
+        {
+            return std::nullopt;
+        }
+
+        // Overlapping copies within one texture are undefined,
+        // so entries are always moved into a fresh texture.
+        auto texture = allocate_texture(atlas_width, atlas_height);
+        for (auto i = std::size_t{0}; i < order.size(); ++i)
+        {
+            auto const& [value, old_rect] = order[i];
+            auto const new_rect = AtlasRect{
+                placed[i].x + options_.padding,
+                placed[i].y + options_.padding,
+                old_rect.width,
+                old_rect.height,
+            };
+
+            glCopyImageSubData(
+                texture_.id(),
+                GL_TEXTURE_2D,
+                0,
+                old_rect.x,
+                old_rect.y,
+                0,
+                texture.id(),
+                GL_TEXTURE_2D,
+                0,
+                new_rect.x,
+                new_rect.y,
+                0,
+                old_rect.width,
+                old_rect.height,
+                1);
+
+            entries_[value] = new_rect;
+        }
+
+        texture_ = std::move(texture);
+        packer_ = std::move(packer);
+        freed_area_ = 0;
+        ++generation_;
+
+        return pending_rect;
+    }
+}  // namespace glpp
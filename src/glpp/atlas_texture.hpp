@@ -0,0 +1,151 @@
+#pragma once
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "glpp/primitive_types.hpp"
+#include "glpp/texture.hpp"
+#include "glpp/uniform.hpp"
+
+namespace glpp
+{
+    struct AtlasRect
+    {
+        Int32 x;
+        Int32 y;
+        Size width;
+        Size height;
+    };
+
+    struct UvRect
+    {
+        glm::vec2 min;
+        glm::vec2 max;
+    };
+
+    // Bottom-left skyline rectangle packer.
+    // Does not support removal; freed space is reclaimed by repacking.
+    class SkylinePacker
+    {
+      public:
+        SkylinePacker(Size width, Size height);
+
+        [[nodiscard]] auto insert(Size width, Size height)
+            -> std::optional<AtlasRect>;
+
+        void clear();
+
+        [[nodiscard]] auto width() const noexcept -> Size { return width_; }
+
+        [[nodiscard]] auto height() const noexcept -> Size { return height_; }
+
+      private:
+        struct Segment
+        {
+            Int32 x;
+            Int32 y;
+            Size width;
+        };
+
+        Size width_;
+        Size height_;
+        std::vector<Segment> skyline_;
+
+        [[nodiscard]] auto fit(std::size_t index, Size width, Size height) const
+            -> std::optional<Int32>;
+
+        void add_segment(std::size_t index, AtlasRect rect);
+    };
+
+    struct AtlasEntry
+    {
+        UInt32 value;
+    };
+
+    // A texture packing many small images.
+    // When an image does not fit, the atlas is repacked if removed entries
+    // freed enough space, and otherwise or if that fails grown
+    // (doubling its size up to max_size); both happen on the GPU,
+    // image contents are never re-uploaded.
+    // Repacking moves entries - uv rects must be re-queried
+    // whenever generation() changes.
+    class AtlasTexture
+    {
+      public:
+        struct Options
+        {
+            Texture::BasicFormat format = Texture::BasicFormat::rgba;
+            Texture::SizedInternalFormat internal_format
+                = Texture::SizedInternalFormat::rgba8;
+            // Empty space kept around each image to prevent filtering bleed.
+            Int32 padding = 1;
+            // 0 means GL_MAX_TEXTURE_SIZE.
+            Size max_size = 0;
+        };
+
+        AtlasTexture(Size width, Size height)
+          : AtlasTexture{width, height, Options{}}
+        {
+        }
+
+        AtlasTexture(Size width, Size height, Options options);
+
+        // Returns std::nullopt if the image does not fit even
+        // into an atlas of the maximum size; the atlas is then left unchanged.
+        [[nodiscard]] auto add(Texture::Data data) -> std::optional<AtlasEntry>;
+
+        void remove(AtlasEntry entry);
+
+        [[nodiscard]] auto contains(AtlasEntry entry) const -> bool;
+
+        [[nodiscard]] auto rect(AtlasEntry entry) const -> AtlasRect;
+
+        [[nodiscard]] auto uv_rect(AtlasEntry entry) const -> UvRect;
+
+        // Incremented every time entries are moved.
+        [[nodiscard]] auto generation() const noexcept -> UInt32 { return generation_; }
+
+        [[nodiscard]] auto size() const noexcept -> std::size_t { return entries_.size(); }
+
+        [[nodiscard]] auto texture() const noexcept -> Texture const& { return texture_; }
+
+        void bind(SamplerUnit const sampler_unit = {}) const noexcept
+        {
+            texture_.bind(sampler_unit);
+        }
+
+        static void unbind(SamplerUnit const sampler_unit = {}) noexcept
+        {
+            Texture::unbind(sampler_unit);
+        }
+
+      private:
+        Options options_;
+        Texture texture_;
+        SkylinePacker packer_;
+        std::unordered_map<UInt32, AtlasRect> entries_;
+        UInt32 next_entry_ = 0;
+        UInt32 generation_ = 0;
+        // Padded area of the entries removed since the last repack.
+        Int64 freed_area_ = 0;
+
+        [[nodiscard]] auto allocate_texture(Size width, Size height) const -> Texture;
+
+        // Packs all entries and a pending rect into a new texture
+        // of the given size; returns the pending rect on success.
+        [[nodiscard]] auto repack(
+            Size atlas_width,
+            Size atlas_height,
+            Size pending_width,
+            Size pending_height)
+            -> std::optional<AtlasRect>;
+
+        [[nodiscard]] auto padded(Size size) const noexcept -> Size
+        {
+            return size + 2 * options_.padding;
+        }
+    };
+}  // namespace glpp
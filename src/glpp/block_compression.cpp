@@ -0,0 +1,779 @@
+#include "glpp/block_compression.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+#include "glpp/error.hpp"
+#include "glpp/load_texture.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define GLPP_BLOCK_COMPRESSION_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define GLPP_BLOCK_COMPRESSION_NEON
+#endif
+
+namespace
+{
+    using CompressedInternalFormat = glpp::Texture::CompressedInternalFormat;
+    using Quality = glpp::CompressionQuality;
+
+    constexpr auto block_texels = std::size_t{16};
+
+    // Channel-major block, so that four texels fit one SIMD register.
+    struct Block
+    {
+        alignas(16) std::array<std::array<float, block_texels>, 4> channels;
+    };
+
+    using Color = std::array<float, 4>;
+    using Palette = std::array<Color, 16>;
+    using Indices = std::array<std::uint8_t, block_texels>;
+
+    struct EncodedBlock
+    {
+        std::array<std::byte, 16> bytes = {};
+        // Decoded texels, for measuring the error.
+        std::array<std::array<std::uint8_t, 4>, block_texels> decoded = {};
+    };
+
+    // Picks the nearest palette entry for every texel, comparing
+    // the first channel_count channels; returns the summed squared error.
+    auto select_indices(
+        Block const& block,
+        std::size_t const first_channel,
+        std::size_t const channel_count,
+        Palette const& palette,
+        std::size_t const palette_size,
+        Indices& indices) noexcept
+        -> float
+    {
+        auto total_error = 0.0f;
+
+#if defined(GLPP_BLOCK_COMPRESSION_SSE2)
+        for (auto t = std::size_t{0}; t < block_texels; t += 4)
+        {
+            auto best = _mm_set1_ps(std::numeric_limits<float>::max());
+            auto best_index = _mm_setzero_si128();
+
+            for (auto p = std::size_t{0}; p < palette_size; ++p)
+            {
+                auto distance = _mm_setzero_ps();
+                for (auto c = first_channel; c < first_channel + channel_count; ++c)
+                {
+                    auto const diff = _mm_sub_ps(
+                        _mm_load_ps(&block.channels[c][t]),
+                        _mm_set1_ps(palette[p][c - first_channel]));
+                    distance = _mm_add_ps(distance, _mm_mul_ps(diff, diff));
+                }
+
+                auto const closer = _mm_castps_si128(_mm_cmplt_ps(distance, best));
+                best = _mm_min_ps(distance, best);
+                best_index = _mm_or_si128(
+                    _mm_and_si128(closer, _mm_set1_epi32(static_cast<int>(p))),
+                    _mm_andnot_si128(closer, best_index));
+            }
+
+            alignas(16) auto lane_index = std::array<std::int32_t, 4>{};
+            alignas(16) auto lane_error = std::array<float, 4>{};
+            _mm_store_si128(reinterpret_cast<__m128i*>(lane_index.data()), best_index);
+            _mm_store_ps(lane_error.data(), best);
+            for (auto lane = std::size_t{0}; lane < 4; ++lane)
+            {
+                indices[t + lane] = static_cast<std::uint8_t>(lane_index[lane]);
+                total_error += lane_error[lane];
+            }
+        }
+#elif defined(GLPP_BLOCK_COMPRESSION_NEON)
+        for (auto t = std::size_t{0}; t < block_texels; t += 4)
+        {
+            auto best = vdupq_n_f32(std::numeric_limits<float>::max());
+            auto best_index = vdupq_n_u32(0);
+
+            for (auto p = std::size_t{0}; p < palette_size; ++p)
+            {
+                auto distance = vdupq_n_f32(0.0f);
+                for (auto c = first_channel; c < first_channel + channel_count; ++c)
+                {
+                    auto const diff = vsubq_f32(
+                        vld1q_f32(&block.channels[c][t]),
+                        vdupq_n_f32(palette[p][c - first_channel]));
+                    distance = vmlaq_f32(distance, diff, diff);
+                }
+
+                auto const closer = vcltq_f32(distance, best);
+                best = vminq_f32(distance, best);
+                best_index = vbslq_u32(closer, vdupq_n_u32(static_cast<std::uint32_t>(p)), best_index);
+            }
+
+            auto lane_index = std::array<std::uint32_t, 4>{};
+            auto lane_error = std::array<float, 4>{};
+            vst1q_u32(lane_index.data(), best_index);
+            vst1q_f32(lane_error.data(), best);
+            for (auto lane = std::size_t{0}; lane < 4; ++lane)
+            {
+                indices[t + lane] = static_cast<std::uint8_t>(lane_index[lane]);
+                total_error += lane_error[lane];
+            }
+        }
+#else
+        for (auto t = std::size_t{0}; t < block_texels; ++t)
+        {
+            auto best = std::numeric_limits<float>::max();
+            for (auto p = std::size_t{0}; p < palette_size; ++p)
+            {
+                auto distance = 0.0f;
+                for (auto c = first_channel; c < first_channel + channel_count; ++c)
+                {
+                    auto const diff = block.channels[c][t] - palette[p][c - first_channel];
+                    distance += diff * diff;
+                }
+                if (distance < best)
+                {
+                    best = distance;
+                    indices[t] = static_cast<std::uint8_t>(p);
+                }
+            }
+            total_error += best;
+        }
+#endif
+
+        return total_error;
+    }
+
+    class BitWriter
+    {
+      public:
+        explicit BitWriter(std::span<std::byte> const bytes) noexcept
+          : bytes_{bytes} {}
+
+        void write(std::uint32_t const value, std::size_t const bit_count) noexcept
+        {
+            for (auto bit = std::size_t{0}; bit < bit_count; ++bit, ++position_)
+            {
+                if ((value >> bit) & 1u)
+                {
+                    bytes_[position_ / 8] |= std::byte{1} << (position_ % 8);
+                }
+            }
+        }
+
+      private:
+        std::span<std::byte> bytes_;
+        std::size_t position_ = 0;
+    };
+
+    // BC4 (RGTC1), one channel; interpolated as specified, in float.
+
+    [[nodiscard]] auto bc4_palette(int const e0, int const e1) noexcept -> Palette
+    {
+        auto palette = Palette{};
+        palette[0][0] = static_cast<float>(e0);
+        palette[1][0] = static_cast<float>(e1);
+
+        if (e0 > e1)
+        {
+            for (auto i = 1; i <= 6; ++i)
+            {
+                palette[1 + i][0] = static_cast<float>((7 - i) * e0 + i * e1) / 7.0f;
+            }
+        }
+        else
+        {
+            for (auto i = 1; i <= 4; ++i)
+            {
+                palette[1 + i][0] = static_cast<float>((5 - i) * e0 + i * e1) / 5.0f;
+            }
+            palette[6][0] = 0.0f;
+            palette[7][0] = 255.0f;
+        }
+
+        return palette;
+    }
+
+    struct Bc4Candidate
+    {
+        int e0;
+        int e1;
+        Indices indices;
+        float error;
+    };
+
+    void try_bc4_endpoints(
+        Block const& block,
+        std::size_t const channel,
+        int const e0,
+        int const e1,
+        Bc4Candidate& best) noexcept
+    {
+        auto indices = Indices{};
+        auto const error = select_indices(block, channel, 1, bc4_palette(e0, e1), 8, indices);
+        if (error < best.error)
+        {
+            best = Bc4Candidate{e0, e1, indices, error};
+        }
+    }
+
+    void encode_bc4(
+        Block const& block,
+        std::size_t const channel,
+        Quality const quality,
+        std::span<std::byte, 8> const bytes,
+        EncodedBlock& encoded) noexcept
+    {
+        auto const& values = block.channels[channel];
+        auto const [min_iter, max_iter] = std::minmax_element(values.begin(), values.end());
+        auto const min = static_cast<int>(*min_iter);
+        auto const max = static_cast<int>(*max_iter);
+
+        auto best = Bc4Candidate{0, 0, {}, std::numeric_limits<float>::max()};
+        // Equal endpoints select the six value mode, which is exact here.
+        try_bc4_endpoints(block, channel, max, min, best);
+
+        if (quality != Quality::fast)
+        {
+            // The six value mode has exact 0 and 255 entries,
+            // leaving the endpoints to cover the remaining values.
+            auto inner_min = 255;
+            auto inner_max = 0;
+            for (auto const value : values)
+            {
+                if (value > 0.0f && value < 255.0f)
+                {
+                    inner_min = std::min(inner_min, static_cast<int>(value));
+                    inner_max = std::max(inner_max, static_cast<int>(value));
+                }
+            }
+            if (inner_min <= inner_max)
+            {
+                try_bc4_endpoints(block, channel, inner_min, inner_max, best);
+            }
+        }
+
+        if (quality == Quality::high)
+        {
+            auto const center0 = best.e0;
+            auto const center1 = best.e1;
+            constexpr auto radius = 3;
+            for (auto d0 = -radius; d0 <= radius; ++d0)
+            {
+                for (auto d1 = -radius; d1 <= radius; ++d1)
+                {
+                    auto const e0 = std::clamp(center0 + d0, 0, 255);
+                    auto const e1 = std::clamp(center1 + d1, 0, 255);
+                    // Keep the mode of the candidate being refined.
+                    if ((e0 > e1) == (center0 > center1))
+                    {
+                        try_bc4_endpoints(block, channel, e0, e1, best);
+                    }
+                }
+            }
+        }
+
+        bytes[0] = static_cast<std::byte>(best.e0);
+        bytes[1] = static_cast<std::byte>(best.e1);
+        auto writer = BitWriter{bytes.subspan<2>()};
+        for (auto const index : best.indices)
+        {
+            writer.write(index, 3);
+        }
+
+        auto const palette = bc4_palette(best.e0, best.e1);
+        for (auto t = std::size_t{0}; t < block_texels; ++t)
+        {
+            encoded.decoded[t][channel] = static_cast<std::uint8_t>(
+                std::lround(palette[best.indices[t]][0]));
+        }
+    }
+
+    // BC7 mode 6: one subset, RGBA, 7 bit endpoints with
+    // a p-bit each and 4 bit indices.
+
+    constexpr auto bc7_weights = std::array{
+        0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64,
+    };
+
+    struct Bc7Endpoints
+    {
+        // 7 bit values per channel.
+        std::array<std::array<int, 4>, 2> color;
+        std::array<int, 2> p_bit;
+
+        [[nodiscard]] auto value(std::size_t const endpoint, std::size_t const channel) const noexcept
+            -> int
+        {
+            return color[endpoint][channel] << 1 | p_bit[endpoint];
+        }
+    };
+
+    [[nodiscard]] auto bc7_palette(Bc7Endpoints const& endpoints) noexcept -> Palette
+    {
+        auto palette = Palette{};
+        for (auto i = std::size_t{0}; i < bc7_weights.size(); ++i)
+        {
+            for (auto c = std::size_t{0}; c < 4; ++c)
+            {
+                palette[i][c] = static_cast<float>(
+                    ((64 - bc7_weights[i]) * endpoints.value(0, c)
+                     + bc7_weights[i] * endpoints.value(1, c) + 32)
+                    >> 6);
+            }
+        }
+        return palette;
+    }
+
+    struct Bc7Candidate
+    {
+        Bc7Endpoints endpoints;
+        Indices indices;
+        float error;
+    };
+
+    // Quantizes float endpoints trying all p-bit combinations.
+    [[nodiscard]] auto quantize_bc7(
+        Block const& block,
+        Color const& e0,
+        Color const& e1) noexcept
+        -> Bc7Candidate
+    {
+        auto best = Bc7Candidate{{}, {}, std::numeric_limits<float>::max()};
+
+        for (auto p0 = 0; p0 < 2; ++p0)
+        {
+            for (auto p1 = 0; p1 < 2; ++p1)
+            {
+                auto endpoints = Bc7Endpoints{{}, {p0, p1}};
+                for (auto c = std::size_t{0}; c < 4; ++c)
+                {
+                    endpoints.color[0][c] = std::clamp(
+                        static_cast<int>(std::lround((e0[c] - static_cast<float>(p0)) / 2.0f)), 0, 127);
+                    endpoints.color[1][c] = std::clamp(
+                        static_cast<int>(std::lround((e1[c] - static_cast<float>(p1)) / 2.0f)), 0, 127);
+                }
+
+                auto indices = Indices{};
+                auto const error = select_indices(block, 0, 4, bc7_palette(endpoints), 16, indices);
+                if (error < best.error)
+                {
+                    best = Bc7Candidate{endpoints, indices, error};
+                }
+            }
+        }
+
+        return best;
+    }
+
+    // Least squares endpoints for a fixed index assignment.
+    [[nodiscard]] auto refit_bc7(
+        Block const& block,
+        Indices const& indices,
+        Color& e0,
+        Color& e1) noexcept
+        -> bool
+    {
+        auto aa = 0.0f;
+        auto ab = 0.0f;
+        auto bb = 0.0f;
+        auto ax = Color{};
+        auto bx = Color{};
+        for (auto t = std::size_t{0}; t < block_texels; ++t)
+        {
+            auto const b = static_cast<float>(bc7_weights[indices[t]]) / 64.0f;
+            auto const a = 1.0f - b;
+            aa += a * a;
+            ab += a * b;
+            bb += b * b;
+            for (auto c = std::size_t{0}; c < 4; ++c)
+            {
+                ax[c] += a * block.channels[c][t];
+                bx[c] += b * block.channels[c][t];
+            }
+        }
+
+        auto const determinant = aa * bb - ab * ab;
+        if (std::abs(determinant) < 1e-6f)
+        {
+            return false;
+        }
+
+        for (auto c = std::size_t{0}; c < 4; ++c)
+        {
+            e0[c] = std::clamp((bb * ax[c] - ab * bx[c]) / determinant, 0.0f, 255.0f);
+            e1[c] = std::clamp((aa * bx[c] - ab * ax[c]) / determinant, 0.0f, 255.0f);
+        }
+        return true;
+    }
+
+    [[nodiscard]] auto principal_axis_endpoints(Block const& block) noexcept
+        -> std::pair<Color, Color>
+    {
+        auto mean = Color{};
+        for (auto c = std::size_t{0}; c < 4; ++c)
+        {
+            for (auto const value : block.channels[c])
+            {
+                mean[c] += value;
+            }
+            mean[c] /= static_cast<float>(block_texels);
+        }
+
+        auto covariance = std::array<Color, 4>{};
+        for (auto t = std::size_t{0}; t < block_texels; ++t)
+        {
+            for (auto i = std::size_t{0}; i < 4; ++i)
+            {
+                for (auto j = std::size_t{0}; j < 4; ++j)
+                {
+                    covariance[i][j] += (block.channels[i][t] - mean[i])
+                                        * (block.channels[j][t] - mean[j]);
+                }
+            }
+        }
+
+        // Power iteration converges quickly for the 4x4 covariance.
+        auto axis = Color{1.0f, 1.0f, 1.0f, 1.0f};
+        for (auto iteration = 0; iteration < 8; ++iteration)
+        {
+            auto next = Color{};
+            for (auto i = std::size_t{0}; i < 4; ++i)
+            {
+                for (auto j = std::size_t{0}; j < 4; ++j)
+                {
+                    next[i] += covariance[i][j] * axis[j];
+                }
+            }
+
+            auto const length = std::sqrt(
+                next[0] * next[0] + next[1] * next[1] + next[2] * next[2] + next[3] * next[3]);
+            if (length < 1e-6f)
+            {
+                break;
+            }
+            for (auto c = std::size_t{0}; c < 4; ++c)
+            {
+                axis[c] = next[c] / length;
+            }
+        }
+
+        auto min_projection = std::numeric_limits<float>::max();
+        auto max_projection = std::numeric_limits<float>::lowest();
+        for (auto t = std::size_t{0}; t < block_texels; ++t)
+        {
+            auto projection = 0.0f;
+            for (auto c = std::size_t{0}; c < 4; ++c)
+            {
+                projection += (block.channels[c][t] - mean[c]) * axis[c];
+            }
+            min_projection = std::min(min_projection, projection);
+            max_projection = std::max(max_projection, projection);
+        }
+
+        auto e0 = Color{};
+        auto e1 = Color{};
+        for (auto c = std::size_t{0}; c < 4; ++c)
+        {
+            e0[c] = std::clamp(mean[c] + axis[c] * min_projection, 0.0f, 255.0f);
+            e1[c] = std::clamp(mean[c] + axis[c] * max_projection, 0.0f, 255.0f);
+        }
+        return {e0, e1};
+    }
+
+    [[nodiscard]] auto bounding_box_endpoints(Block const& block) noexcept
+        -> std::pair<Color, Color>
+    {
+        auto e0 = Color{};
+        auto e1 = Color{};
+        for (auto c = std::size_t{0}; c < 4; ++c)
+        {
+            auto const [min, max] = std::minmax_element(
+                block.channels[c].begin(),
+                block.channels[c].end());
+            e0[c] = *min;
+            e1[c] = *max;
+        }
+        return {e0, e1};
+    }
+
+    void encode_bc7(
+        Block const& block,
+        Quality const quality,
+        EncodedBlock& encoded) noexcept
+    {
+        auto [e0, e1] = quality == Quality::fast
+                            ? bounding_box_endpoints(block)
+                            : principal_axis_endpoints(block);
+        auto best = quantize_bc7(block, e0, e1);
+
+        if (quality == Quality::high)
+        {
+            auto const [box0, box1] = bounding_box_endpoints(block);
+            if (auto candidate = quantize_bc7(block, box0, box1); candidate.error < best.error)
+            {
+                best = candidate;
+            }
+        }
+
+        auto const refinements = quality == Quality::fast ? 0 : quality == Quality::normal ? 1 : 4;
+        for (auto iteration = 0; iteration < refinements && best.error > 0.0f; ++iteration)
+        {
+            if (!refit_bc7(block, best.indices, e0, e1))
+            {
+                break;
+            }
+            auto candidate = quantize_bc7(block, e0, e1);
+            if (candidate.error >= best.error)
+            {
+                break;
+            }
+            best = candidate;
+        }
+
+        // The anchor index has an implicit zero top bit.
+        auto& [endpoints, indices, error] = best;
+        if (indices[0] & 0x8)
+        {
+            std::swap(endpoints.color[0], endpoints.color[1]);
+            std::swap(endpoints.p_bit[0], endpoints.p_bit[1]);
+            for (auto& index : indices)
+            {
+                index = static_cast<std::uint8_t>(15 - index);
+            }
+        }
+
+        auto writer = BitWriter{encoded.bytes};
+        writer.write(1u << 6, 7);
+        for (auto c = std::size_t{0}; c < 4; ++c)
+        {
+            writer.write(static_cast<std::uint32_t>(endpoints.color[0][c]), 7);
+            writer.write(static_cast<std::uint32_t>(endpoints.color[1][c]), 7);
+        }
+        writer.write(static_cast<std::uint32_t>(endpoints.p_bit[0]), 1);
+        writer.write(static_cast<std::uint32_t>(endpoints.p_bit[1]), 1);
+        writer.write(indices[0], 3);
+        for (auto t = std::size_t{1}; t < block_texels; ++t)
+        {
+            writer.write(indices[t], 4);
+        }
+
+        auto const palette = bc7_palette(endpoints);
+        for (auto t = std::size_t{0}; t < block_texels; ++t)
+        {
+            for (auto c = std::size_t{0}; c < 4; ++c)
+            {
+                encoded.decoded[t][c] = static_cast<std::uint8_t>(palette[indices[t]][c]);
+            }
+        }
+    }
+
+    [[nodiscard]] auto encoded_channel_count(CompressedInternalFormat const format)
+        -> std::size_t
+    {
+        switch (format)
+        {
+            case CompressedInternalFormat::compressed_red_rgtc1:
+                return 1;
+            case CompressedInternalFormat::compressed_rg_rgtc2:
+                return 2;
+            case CompressedInternalFormat::compressed_rgba_bptc_unorm:
+            case CompressedInternalFormat::compressed_srgb_alpha_bptc_unorm:
+                return 4;
+            default:
+                throw glpp::Error{"Unsupported block compression format"};
+        }
+    }
+
+    [[nodiscard]] auto dxgi_format(CompressedInternalFormat const format)
+        -> std::uint32_t
+    {
+        switch (format)
+        {
+            case CompressedInternalFormat::compressed_red_rgtc1: return 80;
+            case CompressedInternalFormat::compressed_signed_red_rgtc1: return 81;
+            case CompressedInternalFormat::compressed_rg_rgtc2: return 83;
+            case CompressedInternalFormat::compressed_signed_rg_rgtc2: return 84;
+            case CompressedInternalFormat::compressed_rgb_bptc_unsigned_float: return 95;
+            case CompressedInternalFormat::compressed_rgb_bptc_signed_float: return 96;
+            case CompressedInternalFormat::compressed_rgba_bptc_unorm: return 98;
+            case CompressedInternalFormat::compressed_srgb_alpha_bptc_unorm: return 99;
+            default: throw glpp::Error{"Format cannot be stored in a DDS file"};
+        }
+    }
+}  // namespace
+
+namespace glpp
+{
+    auto compress_texture(
+        Texture::Data const data,
+        Texture::CompressedInternalFormat const format,
+        ThreadPool& pool,
+        BlockCompressionOptions const options)
+        -> EncodedImage
+    {
+        if (data.format != Texture::BasicFormat::rgba
+            || data.data.enumerator() != GL_UNSIGNED_BYTE
+            || !data.data)
+        {
+            throw Error{"Block compression requires RGBA8 data"};
+        }
+
+        auto const channel_count = encoded_channel_count(format);
+        auto const block_size = compressed_block_size(format);
+        auto const width = static_cast<std::size_t>(data.width);
+        auto const height = static_cast<std::size_t>(data.height);
+        auto const blocks_x = (width + 3) / 4;
+        auto const blocks_y = (height + 3) / 4;
+        auto const stride = data.row_stride(4);
+        auto const* const pixels = static_cast<UInt8 const*>(data.data.get()) + data.pixel_offset(4);
+
+        auto image = EncodedImage{
+            format,
+            data.width,
+            data.height,
+            std::vector<std::byte>(blocks_x * blocks_y * block_size),
+            std::nullopt,
+        };
+        // Each block row writes only its own error slot.
+        auto row_errors = std::vector<double>(blocks_y);
+
+        pool.parallel_for(blocks_y, [&](std::size_t const begin, std::size_t const end) {
+            for (auto by = begin; by < end; ++by)
+            {
+                for (auto bx = std::size_t{0}; bx < blocks_x; ++bx)
+                {
+                    // Edge blocks replicate the last row / column.
+                    auto block = Block{};
+                    for (auto t = std::size_t{0}; t < block_texels; ++t)
+                    {
+                        auto const x = std::min(bx * 4 + t % 4, width - 1);
+                        auto const y = std::min(by * 4 + t / 4, height - 1);
+                        auto const* const texel = pixels + y * stride + x * 4;
+                        for (auto c = std::size_t{0}; c < 4; ++c)
+                        {
+                            block.channels[c][t] = static_cast<float>(texel[c]);
+                        }
+                    }
+
+                    auto encoded = EncodedBlock{};
+                    if (channel_count == 4)
+                    {
+                        encode_bc7(block, options.quality, encoded);
+                    }
+                    else
+                    {
+                        for (auto c = std::size_t{0}; c < channel_count; ++c)
+                        {
+                            encode_bc4(
+                                block,
+                                c,
+                                options.quality,
+                                std::span{encoded.bytes}.subspan(c * 8).first<8>(),
+                                encoded);
+                        }
+                    }
+
+                    std::memcpy(
+                        image.data.data() + (by * blocks_x + bx) * block_size,
+                        encoded.bytes.data(),
+                        block_size);
+
+                    if (!options.report_psnr)
+                    {
+                        continue;
+                    }
+                    for (auto t = std::size_t{0}; t < block_texels; ++t)
+                    {
+                        if (bx * 4 + t % 4 >= width || by * 4 + t / 4 >= height)
+                        {
+                            continue;
+                        }
+                        for (auto c = std::size_t{0}; c < channel_count; ++c)
+                        {
+                            auto const diff = static_cast<double>(block.channels[c][t])
+                                              - static_cast<double>(encoded.decoded[t][c]);
+                            row_errors[by] += diff * diff;
+                        }
+                    }
+                }
+            }
+        });
+
+        if (options.report_psnr)
+        {
+            auto total_error = 0.0;
+            for (auto const error : row_errors)
+            {
+                total_error += error;
+            }
+
+            // An empty image is reconstructed exactly.
+            auto const texel_count = static_cast<double>(width * height * channel_count);
+            auto const mean_error = texel_count == 0.0 ? 0.0 : total_error / texel_count;
+            image.psnr = mean_error == 0.0
+                             ? std::numeric_limits<double>::infinity()
+                             : 10.0 * std::log10(255.0 * 255.0 / mean_error);
+        }
+
+        return image;
+    }
+
+    void write_dds(
+        std::filesystem::path const& path,
+        std::span<EncodedImage const> const levels)
+    {
+        if (levels.empty())
+        {
+            throw Error{"No levels to write"};
+        }
+
+        auto const& base = levels.front();
+        for (auto level = std::size_t{0}; level < levels.size(); ++level)
+        {
+            if (levels[level].format != base.format
+                || levels[level].width != std::max(Size{1}, base.width >> level)
+                || levels[level].height != std::max(Size{1}, base.height >> level))
+            {
+                throw Error{
+                    fmt::format("Level {0} does not match the mip chain", level),
+                };
+            }
+        }
+
+        // Header field indices, in 32 bit words after the magic.
+        auto header = std::array<std::uint32_t, 31 + 5>{};
+        header[0] = 124;
+        header[1] = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000;
+        header[2] = static_cast<std::uint32_t>(base.height);
+        header[3] = static_cast<std::uint32_t>(base.width);
+        header[4] = static_cast<std::uint32_t>(base.data.size());
+        header[6] = static_cast<std::uint32_t>(levels.size());
+        header[18] = 32;
+        header[19] = 0x4;
+        std::memcpy(&header[20], "DX10", 4);
+        header[26] = 0x1000 | (levels.size() > 1 ? 0x8 | 0x400000 : 0);
+        header[31] = dxgi_format(base.format);
+        header[32] = 3;
+        header[34] = 1;
+
+        auto file = std::ofstream{path, std::ios::binary};
+        file.write("DDS ", 4);
+        file.write(reinterpret_cast<char const*>(header.data()), sizeof(header));
+        for (auto const& level : levels)
+        {
+            file.write(
+                reinterpret_cast<char const*>(level.data.data()),
+                static_cast<std::streamsize>(level.data.size()));
+        }
+
+        if (!file)
+        {
+            throw Error{fmt::format("Failed to write '{0}'", path)};
+        }
+    }
+}  // namespace glpp
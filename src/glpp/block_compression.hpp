@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "glpp/primitive_types.hpp"
+#include "glpp/texture.hpp"
+#include "glpp/thread_pool.hpp"
+
+namespace glpp
+{
+    enum class CompressionQuality : std::uint8_t
+    {
+        // Bounding box endpoints, no refinement.
+        fast,
+        // Principal axis endpoints, one refinement pass.
+        normal,
+        // BC7: the better of the bounding box and principal axis endpoints,
+        // up to four refinement passes. BC4/BC5: a search of the endpoints
+        // within 3 of the normal result.
+        high,
+    };
+
+    struct BlockCompressionOptions
+    {
+        CompressionQuality quality = CompressionQuality::normal;
+        // Measures the peak signal to noise ratio of the result.
+        bool report_psnr = false;
+    };
+
+    struct EncodedImage
+    {
+        Texture::CompressedInternalFormat format;
+        Size width;
+        Size height;
+        std::vector<std::byte> data;
+        // In dB, over the encoded channels; infinite for an exact result.
+        std::optional<double> psnr;
+
+        [[nodiscard]] auto compressed_data() const noexcept -> Texture::CompressedData
+        {
+            return {width, height, format, data};
+        }
+    };
+
+    // Encodes an RGBA8 image (laid out as described by data.unpack) on the CPU, splitting
+    // block rows across the pool. Supported formats are
+    // compressed_red_rgtc1 (red channel), compressed_rg_rgtc2 (red and green),
+    // and compressed_rgba_bptc_unorm / compressed_srgb_alpha_bptc_unorm
+    // (BC7, always using mode 6).
+    //
+    // Throws glpp::Error
+    [[nodiscard]] auto compress_texture(
+        Texture::Data data,
+        Texture::CompressedInternalFormat format,
+        ThreadPool& pool,
+        BlockCompressionOptions options = {})
+        -> EncodedImage;
+
+    // Writes a mip chain (level 0 first) as a DDS file with a DX10 header,
+    // for offline compression; see glpp::load_compressed_texture.
+    //
+    // Throws glpp::Error
+    void write_dds(
+        std::filesystem::path const& path,
+        std::span<EncodedImage const> levels);
+}  // namespace glpp
@@ -9,6 +9,7 @@
 #include <glad/glad.h>
 #include <gsl/gsl_util>
 #include "glpp/id.hpp"
+#include "glpp/scoped_bind.hpp"
 #include "glpp/traits.hpp"
 
 namespace glpp
@@ -17,6 +18,15 @@ namespace glpp
     {
         attrib_buffer = GL_ARRAY_BUFFER,
         index_buffer = GL_ELEMENT_ARRAY_BUFFER,
+        pixel_pack_buffer = GL_PIXEL_PACK_BUFFER,
+        pixel_unpack_buffer = GL_PIXEL_UNPACK_BUFFER,
+        shader_storage_buffer = GL_SHADER_STORAGE_BUFFER,
+    };
+
+    enum class MapAccess : Enum
+    {
+        read = GL_MAP_READ_BIT,
+        write = GL_MAP_WRITE_BIT,
     };
 
     template <typename T, BufferType type>
@@ -139,7 +149,7 @@ namespace glpp
 
         void buffer_subdata(std::span<T const> data, std::ptrdiff_t offset = 0) noexcept
         {
-            assert(offset + data.size() <= this->size());
+            assert(offset + static_cast<std::ptrdiff_t>(data.size()) <= this->size());
             this->bind();
             glBufferSubData(
                 static_cast<Enum>(type),
@@ -167,6 +177,35 @@ namespace glpp
         std::ptrdiff_t capacity_ = 0;
     };
 
+    // Immutable storage that stays mapped (persistent and coherent)
+    // for the lifetime of the buffer. The mapping can be accessed from any
+    // thread; synchronizing with the GL is up to the user (see glpp::Fence).
+    template <typename T, BufferType type>
+    class PersistentBuffer : public BufferBase<T, type>
+    {
+      public:
+        PersistentBuffer(std::ptrdiff_t const size, MapAccess const access) noexcept
+        {
+            auto const flags = static_cast<Enum>(access)
+                               | GL_MAP_PERSISTENT_BIT
+                               | GL_MAP_COHERENT_BIT;
+
+            this->set_size(size);
+
+            auto const binding = ScopedBind{*this};
+            glBufferStorage(static_cast<Enum>(type), size * sizeof(T), nullptr, flags);
+            mapping_ = std::span<T>{
+                static_cast<T*>(glMapBufferRange(static_cast<Enum>(type), 0, size * sizeof(T), flags)),
+                static_cast<std::size_t>(size),
+            };
+        }
+
+        [[nodiscard]] auto mapping() const noexcept -> std::span<T> { return mapping_; }
+
+      private:
+        std::span<T> mapping_;
+    };
+
     template <typename T>
     using AttribBufferView = BufferView<T, BufferType::attrib_buffer>;
 
@@ -184,4 +223,10 @@ namespace glpp
 
     template <typename T>
     using DynamicIndexBuffer = DynamicBuffer<T, BufferType::index_buffer>;
+
+    template <typename T>
+    using PixelPackBuffer = PersistentBuffer<T, BufferType::pixel_pack_buffer>;
+
+    template <typename T>
+    using PixelUnpackBuffer = PersistentBuffer<T, BufferType::pixel_unpack_buffer>;
 }  // namespace glpp
\ No newline at end of file
@@ -2,10 +2,16 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <iterator>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
+#include <variant>
 
+#include <fmt/format.h>
+#include <fmt/ostream.h>
 #include <magic_enum.hpp>
 #include "glpp/config/error.hpp"
 #include "glpp/load_shader.hpp"
@@ -47,6 +53,78 @@ namespace
         return iter->second;
     }
 
+    constexpr auto specialization_type_names = std::array{
+        std::string_view{"bool"},
+        std::string_view{"int"},
+        std::string_view{"uint"},
+        std::string_view{"float"},
+    };
+
+    [[nodiscard]] auto specialization_to_json(glpp::SpecializationConstant const& constant)
+        -> nlohmann::json
+    {
+        auto json = nlohmann::json{
+            {"id", constant.id},
+            {"type", specialization_type_names[constant.value.index()]},
+        };
+        std::visit([&](auto const value) { json["value"] = value; }, constant.value);
+
+        return json;
+    }
+
+    [[nodiscard]] auto specialization_from_json(nlohmann::json const& json)
+        -> glpp::SpecializationConstant
+    {
+        auto constant = glpp::SpecializationConstant{json.at("id").get<glpp::UInt32>(), {}};
+
+        auto const type = json.at("type").get<std::string>();
+        auto const& value = json.at("value");
+        if (type == "bool")
+        {
+            constant.value = value.get<bool>();
+        }
+        else if (type == "int")
+        {
+            constant.value = value.get<glpp::Int32>();
+        }
+        else if (type == "uint")
+        {
+            constant.value = value.get<glpp::UInt32>();
+        }
+        else if (type == "float")
+        {
+            constant.value = value.get<glpp::Float32>();
+        }
+        else
+        {
+            throw glpp::config::ConfigError{"Bad specialization constant type"};
+        }
+
+        return constant;
+    }
+
+    [[nodiscard]] auto read_spirv(
+        std::filesystem::path const& path,
+        glpp::ShaderFilesystem const& filesystem)
+        -> std::vector<std::byte>
+    {
+        auto const file = filesystem.open(path);
+        if (file == nullptr || !*file)
+        {
+            throw glpp::ShaderCompilationError{
+                fmt::format("Failed to open SPIR-V module '{0}'", path),
+            };
+        }
+
+        auto const contents = std::string{
+            std::istreambuf_iterator<char>{*file},
+            std::istreambuf_iterator<char>{},
+        };
+        auto const bytes = std::as_bytes(std::span{contents});
+
+        return std::vector<std::byte>(bytes.begin(), bytes.end());
+    }
+
     [[nodiscard]] auto shader_type_from_string(std::string_view const name)
         -> std::optional<glpp::ShaderType>
     {
@@ -66,6 +144,20 @@ namespace
 
 namespace glpp::config
 {
+    auto is_spirv(ShaderConfig const& shader_config) -> bool
+    {
+        auto const spirv_sources = std::count_if(
+            shader_config.sources.begin(),
+            shader_config.sources.end(),
+            [](auto const& source) { return source.extension() == ".spv"; });
+        if (spirv_sources != 0 && spirv_sources != std::ssize(shader_config.sources))
+        {
+            throw ConfigError{"SPIR-V and GLSL sources can not be mixed"};
+        }
+
+        return spirv_sources != 0;
+    }
+
     void to_json(nlohmann::json& json, ShaderConfig const& shader_config)
     {
         auto sources = nlohmann::json::array();
@@ -78,6 +170,20 @@ namespace glpp::config
             {"shaderType", to_string(shader_config.shader_type)},
             {"sources", std::move(sources)},
         };
+
+        if (!shader_config.specialization_constants.empty())
+        {
+            auto constants = nlohmann::json::array();
+            for (auto const& constant : shader_config.specialization_constants)
+            {
+                constants.push_back(specialization_to_json(constant));
+            }
+            json["specializationConstants"] = std::move(constants);
+        }
+        if (shader_config.entry_point != "main")
+        {
+            json["entryPoint"] = shader_config.entry_point;
+        }
     }
 
     void from_json(nlohmann::json const& json, ShaderConfig& shader_config)
@@ -91,6 +197,17 @@ namespace glpp::config
             {
                 shader_config.sources.push_back(source.get<std::string>());
             }
+
+            shader_config.specialization_constants.clear();
+            if (auto const constants = json.find("specializationConstants"); constants != json.end())
+            {
+                for (auto const& constant : *constants)
+                {
+                    shader_config.specialization_constants.push_back(
+                        specialization_from_json(constant));
+                }
+            }
+            shader_config.entry_point = json.value("entryPoint", std::string{"main"});
         }
         else
         {
@@ -179,18 +296,38 @@ namespace glpp::config
         ShaderConfig const& config,
         GlslVersion version,
         std::vector<MacroDefinition> definitions,
-        std::vector<std::filesystem::path> include_directories)
+        std::vector<std::filesystem::path> include_directories,
+        ShaderFilesystem const& filesystem)
         -> Shader
     {
+        if (is_spirv(config))
+        {
+            if (config.sources.size() != 1)
+            {
+                throw ConfigError{"A SPIR-V shader must have a single source"};
+            }
+
+            return Shader{
+                config.shader_type,
+                read_spirv(config.sources.front(), filesystem),
+                config.specialization_constants,
+                config.entry_point,
+            };
+        }
+
         return load_shader(
             config.shader_type,
             version,
             config.sources,
             include_directories,
-            definitions);
+            definitions,
+            filesystem);
     }
 
-    auto make_shader_program(ShaderProgramConfig const& config) -> ShaderProgram
+    auto make_shader_program(
+        ShaderProgramConfig const& config,
+        ShaderFilesystem const& filesystem)
+        -> ShaderProgram
     {
         auto shaders = std::vector<Shader>{};
 
@@ -203,9 +340,57 @@ namespace glpp::config
                     shader_config,
                     config.glsl_version,
                     config.definitions,
-                    config.include_directories);
+                    config.include_directories,
+                    filesystem);
             });
 
         return ShaderProgram{shaders};
     }
+
+    auto resolve_program_sources(
+        ShaderProgramConfig const& config,
+        ShaderFilesystem const& filesystem,
+        ShaderSourceCache* const source_cache,
+        std::vector<std::filesystem::path>* const dependencies)
+        -> std::vector<ProgramShaderSource>
+    {
+        if (std::any_of(config.shaders.begin(), config.shaders.end(), &is_spirv))
+        {
+            throw ConfigError{"SPIR-V shaders can only be loaded with make_shader()"};
+        }
+
+        auto sources = std::vector<ProgramShaderSource>{};
+
+        std::transform(
+            config.shaders.begin(),
+            config.shaders.end(),
+            std::back_inserter(sources),
+            [&](auto const& shader_config) {
+                return ProgramShaderSource{
+                    shader_config.shader_type,
+                    resolve_shader_sources(
+                        config.glsl_version,
+                        shader_config.sources,
+                        config.include_directories,
+                        config.definitions,
+                        filesystem,
+                        source_cache,
+                        dependencies),
+                };
+            });
+
+        return sources;
+    }
+
+    auto make_shader_program(ShaderProgramConfig const& config, ProgramCache& cache)
+        -> ShaderProgram
+    {
+        return cache.load(resolve_program_sources(config));
+    }
+
+    auto make_shader_program(ShaderProgramConfig const& config, ShaderCompiler& compiler)
+        -> std::future<ShaderProgram>
+    {
+        return compiler.compile(resolve_program_sources(config));
+    }
 }  // namespace glpp::config
\ No newline at end of file
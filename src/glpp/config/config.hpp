@@ -1,10 +1,16 @@
 #pragma once
 
 #include <filesystem>
+#include <future>
+#include <string>
 #include <vector>
 
 #include <nlohmann/json.hpp>
+#include "glpp/load_shader.hpp"
+#include "glpp/program_cache.hpp"
 #include "glpp/shader.hpp"
+#include "glpp/shader_compiler.hpp"
+#include "glpp/shader_source_cache.hpp"
 #include "glpp/shader_program.hpp"
 
 namespace glpp::config
@@ -12,9 +18,16 @@ namespace glpp::config
     struct ShaderConfig
     {
         ShaderType shader_type;
+        // GLSL sources, or a single SPIR-V module (.spv).
         std::vector<std::filesystem::path> sources;
+        // SPIR-V only.
+        std::vector<SpecializationConstant> specialization_constants = {};
+        std::string entry_point = "main";
     };
 
+    // Whether the shader is loaded from a SPIR-V module.
+    [[nodiscard]] auto is_spirv(ShaderConfig const& shader_config) -> bool;
+
     void to_json(nlohmann::json& json, ShaderConfig const& shader_config);
     void from_json(nlohmann::json const& json, ShaderConfig& shader_config);
 
@@ -29,13 +42,41 @@ namespace glpp::config
     void to_json(nlohmann::json& json, ShaderProgramConfig const& shader_program_config);
     void from_json(nlohmann::json const& json, ShaderProgramConfig& shader_program_config);
 
+    // Resolves the sources of every shader of the program,
+    // see glpp::resolve_shader_sources().
+    //
+    // Throws glpp::config::ConfigError for SPIR-V shaders,
+    // glpp::ShaderCompilationError, std::filesystem::filesystem_error
+    [[nodiscard]] auto resolve_program_sources(
+        ShaderProgramConfig const& config,
+        ShaderFilesystem const& filesystem = DefaultShaderFilesystem{},
+        ShaderSourceCache* source_cache = nullptr,
+        std::vector<std::filesystem::path>* dependencies = nullptr)
+        -> std::vector<ProgramShaderSource>;
+
     [[nodiscard]] auto make_shader(
         ShaderConfig const& config,
         GlslVersion version,
         std::vector<MacroDefinition> definitions,
-        std::vector<std::filesystem::path> include_directories)
+        std::vector<std::filesystem::path> include_directories,
+        ShaderFilesystem const& filesystem = DefaultShaderFilesystem{})
         -> Shader;
 
-	[[nodiscard]] auto make_shader_program(ShaderProgramConfig const& config) -> ShaderProgram;
+	[[nodiscard]] auto make_shader_program(
+        ShaderProgramConfig const& config,
+        ShaderFilesystem const& filesystem = DefaultShaderFilesystem{})
+        -> ShaderProgram;
+
+    // Restores the program from the cache if it was linked before.
+    [[nodiscard]] auto make_shader_program(
+        ShaderProgramConfig const& config,
+        ProgramCache& cache)
+        -> ShaderProgram;
+
+    // The returned future is resolved by compiler.poll().
+    [[nodiscard]] auto make_shader_program(
+        ShaderProgramConfig const& config,
+        ShaderCompiler& compiler)
+        -> std::future<ShaderProgram>;
 
 }  // namespace glpp::config
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "glpp/embedded_shader_filesystem.hpp"
+
+#include <streambuf>
+#include <system_error>
+
+namespace
+{
+    [[nodiscard]] auto key(std::filesystem::path const& path) -> std::string
+    {
+        return path.lexically_normal().generic_string();
+    }
+
+    // FNV-1a.
+    [[nodiscard]] auto hash_contents(std::string_view const contents) noexcept -> std::uint64_t
+    {
+        auto hash = std::uint64_t{0xcbf29ce484222325u};
+        for (auto const c : contents)
+        {
+            hash = (hash ^ static_cast<std::uint8_t>(c)) * 0x100000001b3u;
+        }
+
+        return hash;
+    }
+
+    [[noreturn]] void throw_not_found(std::filesystem::path const& path)
+    {
+        throw std::filesystem::filesystem_error{
+            "Embedded shader file not found",
+            path,
+            std::make_error_code(std::errc::no_such_file_or_directory),
+        };
+    }
+
+    // Reads from memory without copying it.
+    class MemoryBuffer : public std::streambuf
+    {
+      public:
+        explicit MemoryBuffer(std::string_view const contents)
+        {
+            auto* const begin = const_cast<char*>(contents.data());
+            setg(begin, begin, begin + contents.size());
+        }
+
+      protected:
+        auto seekoff(
+            off_type const offset,
+            std::ios_base::seekdir const direction,
+            std::ios_base::openmode const which)
+            -> pos_type override
+        {
+            if ((which & std::ios_base::in) == 0)
+            {
+                return pos_type(off_type(-1));
+            }
+
+            auto const base = direction == std::ios_base::beg   ? eback()
+                              : direction == std::ios_base::cur ? gptr()
+                                                                : egptr();
+            auto const position = (base - eback()) + offset;
+            if (position < 0 || position > egptr() - eback())
+            {
+                return pos_type(off_type(-1));
+            }
+
+            setg(eback(), eback() + position, egptr());
+            return pos_type(position);
+        }
+
+        auto seekpos(pos_type const position, std::ios_base::openmode const which)
+            -> pos_type override
+        {
+            return seekoff(off_type(position), std::ios_base::beg, which);
+        }
+    };
+
+    class MemoryStream : public std::istream
+    {
+      public:
+        explicit MemoryStream(std::string_view const contents)
+          : std::istream{nullptr}
+          , buffer_{contents}
+        {
+            rdbuf(&buffer_);
+        }
+
+      private:
+        MemoryBuffer buffer_;
+    };
+}  // namespace
+
+namespace glpp
+{
+    EmbeddedShaderFilesystem::EmbeddedShaderFilesystem(
+        std::span<EmbeddedShaderFile const> const files)
+    {
+        files_.reserve(files.size());
+        for (auto const& file : files)
+        {
+            files_.insert_or_assign(key(file.path), File{file.contents, hash_contents(file.contents)});
+        }
+    }
+
+    auto EmbeddedShaderFilesystem::exists(std::filesystem::path const& path) const -> bool
+    {
+        return find(path) != nullptr;
+    }
+
+    auto EmbeddedShaderFilesystem::canonical(std::filesystem::path const& path) const
+        -> std::filesystem::path
+    {
+        if (find(path) == nullptr)
+        {
+            throw_not_found(path);
+        }
+
+        return key(path);
+    }
+
+    auto EmbeddedShaderFilesystem::open(std::filesystem::path const& path) const
+        -> std::unique_ptr<std::istream>
+    {
+        if (auto const* const file = find(path))
+        {
+            return std::make_unique<MemoryStream>(file->contents);
+        }
+
+        return nullptr;
+    }
+
+    auto EmbeddedShaderFilesystem::stamp(std::filesystem::path const& path) const
+        -> std::optional<ShaderFileStamp>
+    {
+        if (auto const* const file = find(path))
+        {
+            return ShaderFileStamp{{}, file->contents.size(), file->hash};
+        }
+
+        return std::nullopt;
+    }
+
+    auto EmbeddedShaderFilesystem::contents(std::filesystem::path const& path) const
+        -> std::string_view
+    {
+        if (auto const* const file = find(path))
+        {
+            return file->contents;
+        }
+
+        throw_not_found(path);
+    }
+
+    auto EmbeddedShaderFilesystem::find(std::filesystem::path const& path) const
+        -> File const*
+    {
+        auto const found = files_.find(key(path));
+
+        return found != files_.end() ? &found->second : nullptr;
+    }
+}  // namespace glpp
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "glpp/load_shader.hpp"
+
+namespace glpp
+{
+    // A file compiled into the executable, see glpp_embed_shaders()
+    // in cmake/glpp_shaders.cmake.
+    struct EmbeddedShaderFile
+    {
+        // Relative, with forward slashes.
+        std::string_view path;
+        std::string_view contents;
+    };
+
+    // Serves shader sources from memory; load_shader() and the other
+    // consumers of a glpp::ShaderFilesystem then do no I/O at all.
+    // Paths are looked up after lexical normalization, so they have
+    // to be given relative to the same directory as the embedded ones.
+    class EmbeddedShaderFilesystem : public ShaderFilesystem
+    {
+      public:
+        // The contents are not copied, and have to outlive
+        // the filesystem.
+        explicit EmbeddedShaderFilesystem(std::span<EmbeddedShaderFile const> files);
+
+        [[nodiscard]] auto exists(
+            std::filesystem::path const& path) const
+            -> bool override;
+
+        // Throws std::filesystem::filesystem_error if there is no such file
+        [[nodiscard]] auto canonical(
+            std::filesystem::path const& path) const
+            -> std::filesystem::path override;
+
+        [[nodiscard]] auto open(
+            std::filesystem::path const& path) const
+            -> std::unique_ptr<std::istream> override;
+
+        // A hash of the contents, as embedded files have no write
+        // times; files at the same path in different filesystems
+        // differ in the stamp, so they can share a source cache.
+        [[nodiscard]] auto stamp(
+            std::filesystem::path const& path) const
+            -> std::optional<ShaderFileStamp> override;
+
+        // Throws std::filesystem::filesystem_error if there is no such file
+        [[nodiscard]] auto contents(
+            std::filesystem::path const& path) const
+            -> std::string_view;
+
+      private:
+        struct File
+        {
+            std::string_view contents;
+            std::uint64_t hash;
+        };
+
+        std::unordered_map<std::string, File> files_;
+
+        [[nodiscard]] auto find(std::filesystem::path const& path) const
+            -> File const*;
+    };
+}  // namespace glpp
@@ -21,4 +21,10 @@ namespace glpp
       public:
         using Error::Error;
     };
+
+    class TextureLoadError : public Error
+    {
+      public:
+        using Error::Error;
+    };
 }  // namespace glpp
\ No newline at end of file
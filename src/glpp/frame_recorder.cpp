@@ -0,0 +1,489 @@
+#include "glpp/frame_recorder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+#include "glpp/error.hpp"
+
+namespace
+{
+    using glpp::Size;
+    using glpp::UInt8;
+
+    // Frames are read back as rgba, bottom row first.
+    constexpr auto readback_components = std::size_t{4};
+
+    [[nodiscard]] auto source_row(
+        std::vector<UInt8> const& pixels,
+        Size const width,
+        Size const height,
+        Size const y) noexcept
+        -> UInt8 const*
+    {
+        return pixels.data()
+               + static_cast<std::size_t>(height - 1 - y)
+                     * static_cast<std::size_t>(width)
+                     * readback_components;
+    }
+
+    constexpr auto crc_table = [] {
+        auto table = std::array<std::uint32_t, 256>{};
+        for (auto i = std::uint32_t{0}; i < table.size(); ++i)
+        {
+            auto crc = i;
+            for (auto bit = 0; bit < 8; ++bit)
+            {
+                crc = (crc & 1) ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+            }
+            table[i] = crc;
+        }
+        return table;
+    }();
+
+    [[nodiscard]] auto update_crc(
+        std::uint32_t crc,
+        UInt8 const* const data,
+        std::size_t const size) noexcept
+        -> std::uint32_t
+    {
+        for (auto i = std::size_t{0}; i < size; ++i)
+        {
+            crc = crc_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return crc;
+    }
+
+    [[nodiscard]] auto adler32(std::vector<UInt8> const& data) noexcept -> std::uint32_t
+    {
+        // Largest run for which the sums can not overflow before the modulo.
+        constexpr auto max_run = std::size_t{5552};
+        constexpr auto modulus = std::uint32_t{65521};
+
+        auto a = std::uint32_t{1};
+        auto b = std::uint32_t{0};
+        for (auto begin = std::size_t{0}; begin < data.size(); begin += max_run)
+        {
+            auto const end = std::min(data.size(), begin + max_run);
+            for (auto i = begin; i < end; ++i)
+            {
+                a += data[i];
+                b += a;
+            }
+            a %= modulus;
+            b %= modulus;
+        }
+        return (b << 16) | a;
+    }
+
+    void append_u32_be(std::vector<UInt8>& out, std::uint32_t const value)
+    {
+        out.push_back(static_cast<UInt8>(value >> 24));
+        out.push_back(static_cast<UInt8>(value >> 16));
+        out.push_back(static_cast<UInt8>(value >> 8));
+        out.push_back(static_cast<UInt8>(value));
+    }
+
+    void append_chunk(
+        std::vector<UInt8>& out,
+        std::string_view const type,
+        std::vector<UInt8> const& data)
+    {
+        append_u32_be(out, static_cast<std::uint32_t>(data.size()));
+        auto const type_begin = out.size();
+        out.insert(out.end(), type.begin(), type.end());
+        out.insert(out.end(), data.begin(), data.end());
+
+        auto const crc = update_crc(
+            0xFFFFFFFFu,
+            out.data() + type_begin,
+            out.size() - type_begin);
+        append_u32_be(out, crc ^ 0xFFFFFFFFu);
+    }
+
+    // Deflate is used in stored mode only: at full frame rate, encoding
+    // speed matters more than file size, and it keeps glpp free of zlib.
+    [[nodiscard]] auto encode_png(
+        std::vector<UInt8> const& pixels,
+        Size const width,
+        Size const height)
+        -> std::vector<UInt8>
+    {
+        constexpr auto max_stored_block = std::size_t{65535};
+
+        auto const row_size = 1 + static_cast<std::size_t>(width) * 3;
+        auto scanlines = std::vector<UInt8>(row_size * static_cast<std::size_t>(height));
+        for (auto y = Size{0}; y < height; ++y)
+        {
+            auto const* src = source_row(pixels, width, height, y);
+            auto* dst = scanlines.data() + static_cast<std::size_t>(y) * row_size;
+
+            // Filter type none.
+            *dst++ = 0;
+            for (auto x = Size{0}; x < width; ++x, src += readback_components)
+            {
+                *dst++ = src[0];
+                *dst++ = src[1];
+                *dst++ = src[2];
+            }
+        }
+
+        auto zlib = std::vector<UInt8>{};
+        zlib.reserve(scanlines.size() + scanlines.size() / max_stored_block * 5 + 16);
+        zlib.push_back(0x78);
+        zlib.push_back(0x01);
+        for (auto begin = std::size_t{0}; begin < scanlines.size() || begin == 0;
+             begin += max_stored_block)
+        {
+            auto const size = std::min(max_stored_block, scanlines.size() - begin);
+            auto const is_final = begin + size == scanlines.size();
+            zlib.push_back(is_final ? 1 : 0);
+            zlib.push_back(static_cast<UInt8>(size));
+            zlib.push_back(static_cast<UInt8>(size >> 8));
+            zlib.push_back(static_cast<UInt8>(~size));
+            zlib.push_back(static_cast<UInt8>(~size >> 8));
+            zlib.insert(
+                zlib.end(),
+                scanlines.begin() + static_cast<std::ptrdiff_t>(begin),
+                scanlines.begin() + static_cast<std::ptrdiff_t>(begin + size));
+            if (is_final)
+            {
+                break;
+            }
+        }
+        append_u32_be(zlib, adler32(scanlines));
+
+        auto header = std::vector<UInt8>{};
+        append_u32_be(header, static_cast<std::uint32_t>(width));
+        append_u32_be(header, static_cast<std::uint32_t>(height));
+        // Bit depth 8, truecolor, deflate, default filtering, no interlacing.
+        header.insert(header.end(), {8, 2, 0, 0, 0});
+
+        auto png = std::vector<UInt8>{0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        png.reserve(zlib.size() + 64);
+        append_chunk(png, "IHDR", header);
+        append_chunk(png, "IDAT", zlib);
+        append_chunk(png, "IEND", {});
+
+        return png;
+    }
+
+    // Full range BT.601 (JPEG) YCbCr, chroma subsampled 2x2 in both directions.
+    [[nodiscard]] auto encode_y4m_frame(
+        std::vector<UInt8> const& pixels,
+        Size const width,
+        Size const height)
+        -> std::vector<UInt8>
+    {
+        constexpr auto frame_header = std::string_view{"FRAME\n"};
+
+        auto const luma_size = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+        auto const chroma_width = (width + 1) / 2;
+        auto const chroma_height = (height + 1) / 2;
+        auto const chroma_size
+            = static_cast<std::size_t>(chroma_width) * static_cast<std::size_t>(chroma_height);
+
+        auto frame = std::vector<UInt8>(frame_header.size() + luma_size + 2 * chroma_size);
+        std::copy(frame_header.begin(), frame_header.end(), frame.begin());
+        auto* const luma = frame.data() + frame_header.size();
+        auto* const cb = luma + luma_size;
+        auto* const cr = cb + chroma_size;
+
+        for (auto y = Size{0}; y < height; ++y)
+        {
+            auto const* src = source_row(pixels, width, height, y);
+            auto* dst = luma + static_cast<std::size_t>(y) * static_cast<std::size_t>(width);
+            for (auto x = Size{0}; x < width; ++x, src += readback_components)
+            {
+                *dst++ = static_cast<UInt8>((77 * src[0] + 150 * src[1] + 29 * src[2] + 128) >> 8);
+            }
+        }
+
+        for (auto y = Size{0}; y < chroma_height; ++y)
+        {
+            auto const rows = std::array{
+                source_row(pixels, width, height, 2 * y),
+                source_row(pixels, width, height, std::min(2 * y + 1, height - 1)),
+            };
+            auto const row_offset = static_cast<std::size_t>(y) * static_cast<std::size_t>(chroma_width);
+
+            for (auto x = Size{0}; x < chroma_width; ++x)
+            {
+                auto const x0 = static_cast<std::size_t>(2 * x) * readback_components;
+                auto const x1 = static_cast<std::size_t>(std::min(2 * x + 1, width - 1))
+                                * readback_components;
+
+                auto rgb = std::array<int, 3>{};
+                for (auto c = std::size_t{0}; c < 3; ++c)
+                {
+                    rgb[c] = (rows[0][x0 + c] + rows[0][x1 + c] + rows[1][x0 + c] + rows[1][x1 + c] + 2) / 4;
+                }
+                auto const [r, g, b] = rgb;
+
+                cb[row_offset + x] = static_cast<UInt8>(((-43 * r - 85 * g + 128 * b + 128) >> 8) + 128);
+                cr[row_offset + x] = static_cast<UInt8>(((128 * r - 107 * g - 21 * b + 128) >> 8) + 128);
+            }
+        }
+
+        return frame;
+    }
+}  // namespace
+
+namespace glpp
+{
+    FrameRecorder::FrameRecorder(
+        std::filesystem::path output,
+        Size const width,
+        Size const height,
+        ThreadPool& thread_pool,
+        Options const options)
+      : output_{std::move(output)}
+      , width_{width}
+      , height_{height}
+      , thread_pool_{thread_pool}
+      , options_{options}
+      , texture_{
+            Texture::Data{width, height, Texture::BasicFormat::rgba},
+            Texture::SizedInternalFormat::rgba8,
+        }
+      // One pack buffer per queued frame, so that readbacks
+      // only stall once the queue itself is full.
+      , reader_{std::max(std::size_t{1}, options.max_queued_frames)}
+    {
+        auto const attachment = TextureAttachment{texture_, FragOutputLocation{0}};
+        framebuffer_.set_frag_output_textures({&attachment, 1});
+        framebuffer_.set_viewport_size(ViewportSize{0, 0, width, height});
+
+        switch (options_.format)
+        {
+            case FrameFormat::png:
+                std::filesystem::create_directories(output_);
+                break;
+            case FrameFormat::y4m:
+                stream_.open(output_, std::ios::binary);
+                stream_ << fmt::format(
+                    "YUV4MPEG2 W{0} H{1} F{2}:1 Ip A1:1 C420jpeg\n",
+                    width,
+                    height,
+                    options_.frame_rate);
+                if (!stream_)
+                {
+                    throw Error{fmt::format("Failed to open '{0}'", output_)};
+                }
+                break;
+        }
+    }
+
+    FrameRecorder::~FrameRecorder() noexcept
+    {
+        // Errors can only be reported by finish().
+        try
+        {
+            dispatch_completed_readbacks(true);
+        }
+        catch (...)
+        {
+        }
+
+        auto lock = std::unique_lock{mutex_};
+        frame_written_.wait(lock, [&] { return encoding_frames_ == 0; });
+    }
+
+    auto FrameRecorder::capture() -> bool
+    {
+        poll();
+
+        // Requires mutex_ to be held.
+        auto const is_full = [&] {
+            return readbacks_.size() + encoding_frames_ >= options_.max_queued_frames;
+        };
+
+        auto const was_full = [&] {
+            auto const lock = std::lock_guard{mutex_};
+            return is_full();
+        }();
+
+        if (was_full)
+        {
+            if (options_.queue_full_policy == QueueFullPolicy::drop)
+            {
+                ++dropped_frames_;
+                return false;
+            }
+
+            dispatch_completed_readbacks(true);
+
+            auto lock = std::unique_lock{mutex_};
+            frame_written_.wait(lock, [&] { return !is_full() || error_; });
+        }
+        rethrow_error();
+
+        readbacks_.push_back(Readback{
+            next_frame_++,
+            reader_.read_pixels_async(
+                framebuffer_,
+                PixelRect{0, 0, width_, height_},
+                Texture::BasicFormat::rgba),
+        });
+
+        return true;
+    }
+
+    void FrameRecorder::poll()
+    {
+        dispatch_completed_readbacks(false);
+        rethrow_error();
+    }
+
+    void FrameRecorder::finish()
+    {
+        dispatch_completed_readbacks(true);
+        {
+            auto lock = std::unique_lock{mutex_};
+            frame_written_.wait(lock, [&] { return encoding_frames_ == 0; });
+        }
+
+        if (stream_.is_open())
+        {
+            stream_.flush();
+        }
+        rethrow_error();
+    }
+
+    void FrameRecorder::dispatch_completed_readbacks(bool const wait)
+    {
+        if (wait)
+        {
+            reader_.finish();
+        }
+        else
+        {
+            static_cast<void>(reader_.poll());
+        }
+
+        while (!readbacks_.empty()
+               && readbacks_.front().pixels.wait_for(std::chrono::seconds{0})
+                      == std::future_status::ready)
+        {
+            auto readback = std::move(readbacks_.front());
+            readbacks_.pop_front();
+            auto pixels = readback.pixels.get();
+
+            {
+                auto const lock = std::lock_guard{mutex_};
+                ++encoding_frames_;
+            }
+
+            try
+            {
+                thread_pool_.submit(
+                    [this, frame = readback.frame, pixels = std::move(pixels)]() mutable {
+                        encode(frame, std::move(pixels));
+                    });
+            }
+            catch (...)
+            {
+                auto const lock = std::lock_guard{mutex_};
+                --encoding_frames_;
+                throw;
+            }
+        }
+    }
+
+    void FrameRecorder::encode(std::size_t const frame, std::vector<UInt8> pixels)
+    {
+        try
+        {
+            switch (options_.format)
+            {
+                case FrameFormat::png:
+                {
+                    auto const path = output_ / fmt::format("frame_{0:06}.png", frame);
+                    auto const png = encode_png(pixels, width_, height_);
+
+                    auto file = std::ofstream{path, std::ios::binary};
+                    file.write(
+                        reinterpret_cast<char const*>(png.data()),
+                        static_cast<std::streamsize>(png.size()));
+                    if (!file)
+                    {
+                        throw Error{fmt::format("Failed to write '{0}'", path)};
+                    }
+                    break;
+                }
+                case FrameFormat::y4m:
+                {
+                    // A frame that fails to encode is written as nothing,
+                    // so that the frames after it are not held back.
+                    auto encoded = std::vector<UInt8>{};
+                    auto encode_error = std::exception_ptr{};
+                    try
+                    {
+                        encoded = encode_y4m_frame(pixels, width_, height_);
+                    }
+                    catch (...)
+                    {
+                        encode_error = std::current_exception();
+                    }
+
+                    write_stream_frames(frame, std::move(encoded));
+                    if (encode_error)
+                    {
+                        std::rethrow_exception(encode_error);
+                    }
+                    break;
+                }
+            }
+        }
+        catch (...)
+        {
+            auto const lock = std::lock_guard{mutex_};
+            if (!error_)
+            {
+                error_ = std::current_exception();
+            }
+        }
+
+        // Notified under the lock, the recorder may be destroyed
+        // as soon as the last frame is accounted for.
+        auto const lock = std::lock_guard{mutex_};
+        --encoding_frames_;
+        frame_written_.notify_all();
+    }
+
+    void FrameRecorder::write_stream_frames(std::size_t const frame, std::vector<UInt8> encoded)
+    {
+        auto const lock = std::lock_guard{stream_mutex_};
+
+        encoded_frames_.emplace(frame, std::move(encoded));
+        while (!encoded_frames_.empty() && encoded_frames_.begin()->first == next_written_frame_)
+        {
+            // Taken out before writing, so that a failed write
+            // does not hold back the frames after it.
+            auto const node = encoded_frames_.extract(encoded_frames_.begin());
+            ++next_written_frame_;
+
+            auto const& data = node.mapped();
+            stream_.write(
+                reinterpret_cast<char const*>(data.data()),
+                static_cast<std::streamsize>(data.size()));
+            if (!stream_)
+            {
+                throw Error{fmt::format("Failed to write '{0}'", output_)};
+            }
+        }
+    }
+
+    void FrameRecorder::rethrow_error()
+    {
+        auto const lock = std::lock_guard{mutex_};
+        if (error_)
+        {
+            std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+    }
+}  // namespace glpp
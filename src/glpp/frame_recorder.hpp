@@ -0,0 +1,161 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "glpp/framebuffer.hpp"
+#include "glpp/pixel_reader.hpp"
+#include "glpp/primitive_types.hpp"
+#include "glpp/texture.hpp"
+#include "glpp/thread_pool.hpp"
+
+namespace glpp
+{
+    enum class FrameFormat
+    {
+        // One file per frame, frame_000000.png etc.
+        png,
+        // A single raw YUV 4:2:0 stream.
+        y4m,
+    };
+
+    enum class QueueFullPolicy
+    {
+        // capture() blocks until a frame has been written.
+        block,
+        // capture() drops the frame.
+        drop,
+    };
+
+    // Records frames rendered into its framebuffer to disk.
+    // Frames are read back asynchronously (see glpp::PixelReader)
+    // and converted and encoded by a thread pool, so capture()
+    // does not stall the GL pipeline unless the queue is full.
+    //
+    // All member functions must be called on the GL thread.
+    class FrameRecorder
+    {
+      public:
+        struct Options
+        {
+            FrameFormat format = FrameFormat::png;
+            // Frames that are read back or encoded at the same time;
+            // also the number of pixel pack buffers.
+            std::size_t max_queued_frames = 8;
+            QueueFullPolicy queue_full_policy = QueueFullPolicy::block;
+            // Only stored in the Y4M header.
+            UInt32 frame_rate = 30;
+        };
+
+        // For png, output is a directory (created if needed);
+        // for y4m, the stream file.
+        // Throws glpp::Error if the output file can not be opened.
+        FrameRecorder(
+            std::filesystem::path output,
+            Size width,
+            Size height,
+            ThreadPool& thread_pool)
+          : FrameRecorder{std::move(output), width, height, thread_pool, Options{}}
+        {
+        }
+
+        FrameRecorder(
+            std::filesystem::path output,
+            Size width,
+            Size height,
+            ThreadPool& thread_pool,
+            Options options);
+
+        FrameRecorder(FrameRecorder const&) = delete;
+        FrameRecorder(FrameRecorder&&) = delete;
+
+        // Waits for all captured frames to be written; errors are
+        // dropped, call finish() first to have them reported.
+        ~FrameRecorder() noexcept;
+
+        auto operator=(FrameRecorder const&) = delete;
+        auto operator=(FrameRecorder&&) = delete;
+
+        // Render target of the recorded frames; its color
+        // attachment is an rgba8 texture of the recorded size.
+        [[nodiscard]] auto framebuffer() noexcept -> Framebuffer& { return framebuffer_; }
+
+        [[nodiscard]] auto texture() const noexcept -> Texture const& { return texture_; }
+
+        // Captures the current contents of the framebuffer.
+        // Returns false if the frame was dropped.
+        // Also does the work of poll().
+        auto capture() -> bool;
+
+        // Hands completed readbacks over to the thread pool.
+        // Should be called regularly, e.g. once per frame.
+        // Rethrows the first error that occurred while writing frames.
+        void poll();
+
+        // Blocks until all captured frames are written.
+        // Rethrows the first error that occurred while writing frames.
+        void finish();
+
+        [[nodiscard]] auto width() const noexcept -> Size { return width_; }
+
+        [[nodiscard]] auto height() const noexcept -> Size { return height_; }
+
+        [[nodiscard]] auto captured_frames() const noexcept -> std::size_t
+        {
+            return next_frame_;
+        }
+
+        [[nodiscard]] auto dropped_frames() const noexcept -> std::size_t
+        {
+            return dropped_frames_;
+        }
+
+      private:
+        struct Readback
+        {
+            std::size_t frame;
+            std::future<std::vector<UInt8>> pixels;
+        };
+
+        std::filesystem::path output_;
+        Size width_;
+        Size height_;
+        ThreadPool& thread_pool_;
+        Options options_;
+        Texture texture_;
+        Framebuffer framebuffer_;
+        PixelReader<UInt8> reader_;
+        std::deque<Readback> readbacks_;
+        std::size_t next_frame_ = 0;
+        std::size_t dropped_frames_ = 0;
+
+        // Shared with the encoding tasks.
+        std::mutex mutex_;
+        std::condition_variable frame_written_;
+        std::size_t encoding_frames_ = 0;
+        std::exception_ptr error_;
+
+        // Y4M frames are encoded out of order but written in order.
+        std::mutex stream_mutex_;
+        std::ofstream stream_;
+        std::map<std::size_t, std::vector<UInt8>> encoded_frames_;
+        std::size_t next_written_frame_ = 0;
+
+        void dispatch_completed_readbacks(bool wait);
+
+        void encode(std::size_t frame, std::vector<UInt8> pixels);
+
+        void write_stream_frames(std::size_t frame, std::vector<UInt8> encoded);
+
+        void rethrow_error();
+    };
+}  // namespace glpp
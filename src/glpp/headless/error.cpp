@@ -0,0 +1,18 @@
+#include "glpp/headless/error.hpp"
+
+#include <EGL/egl.h>
+#include <fmt/format.h>
+
+namespace glpp::headless
+{
+    EglError::EglError(std::string_view const call, Int32 const error_code)
+      : Error{fmt::format("{0} failed (EGL error {1:#x})", call, error_code)}
+      , error_code_{error_code}
+    {
+    }
+
+    void throw_egl_error(std::string_view const call)
+    {
+        throw EglError{call, eglGetError()};
+    }
+}  // namespace glpp::headless
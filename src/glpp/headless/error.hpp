@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string_view>
+
+#include "glpp/error.hpp"
+#include "glpp/primitive_types.hpp"
+
+namespace glpp::headless
+{
+    class EglError : public Error
+    {
+      public:
+        // Formats the message from the failed call and the error code.
+        EglError(std::string_view call, Int32 error_code);
+
+        [[nodiscard]] auto error_code() const noexcept -> Int32
+        {
+            return error_code_;
+        }
+
+      private:
+        Int32 error_code_;
+    };
+
+    // Throws glpp::headless::EglError with the error code from eglGetError().
+    [[noreturn]] void throw_egl_error(std::string_view call);
+}  // namespace glpp::headless
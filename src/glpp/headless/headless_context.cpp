@@ -0,0 +1,210 @@
+#include "glpp/headless/headless_context.hpp"
+
+#include <algorithm>
+#include <array>
+#include <string_view>
+#include <type_traits>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <glad/glad.h>
+#include "glpp/error.hpp"
+#include "glpp/headless/error.hpp"
+
+namespace
+{
+    static_assert(std::is_same_v<EGLDisplay, glpp::headless::EglDisplay>);
+    static_assert(std::is_same_v<EGLContext, glpp::headless::EglContext>);
+    static_assert(std::is_same_v<EGLSurface, glpp::headless::EglSurface>);
+    static_assert(std::is_same_v<EGLint, glpp::Int32>);
+
+    [[nodiscard]] auto has_extension(
+        EGLDisplay const display,
+        std::string_view const extension) noexcept
+        -> bool
+    {
+        auto const* const extensions = eglQueryString(display, EGL_EXTENSIONS);
+        if (extensions == nullptr)
+        {
+            // Client extensions are not supported (EGL < 1.5 without
+            // EGL_EXT_client_extensions); the query sets an error.
+            eglGetError();
+            return false;
+        }
+
+        auto const list = std::string_view{extensions};
+        for (auto begin = std::size_t{0}; begin < list.size();)
+        {
+            auto const end = std::min(list.find(' ', begin), list.size());
+            if (list.substr(begin, end - begin) == extension)
+            {
+                return true;
+            }
+            begin = end + 1;
+        }
+        return false;
+    }
+
+    [[nodiscard]] auto get_display() -> EGLDisplay
+    {
+        if (has_extension(EGL_NO_DISPLAY, "EGL_MESA_platform_surfaceless"))
+        {
+            auto const get_platform_display = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+                eglGetProcAddress("eglGetPlatformDisplayEXT"));
+
+            if (get_platform_display != nullptr)
+            {
+                auto const display = get_platform_display(
+                    EGL_PLATFORM_SURFACELESS_MESA,
+                    EGL_DEFAULT_DISPLAY,
+                    nullptr);
+                if (display != EGL_NO_DISPLAY)
+                {
+                    return display;
+                }
+            }
+        }
+
+        auto const display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        if (display == EGL_NO_DISPLAY)
+        {
+            glpp::headless::throw_egl_error("eglGetDisplay");
+        }
+        return display;
+    }
+}  // namespace
+
+namespace glpp::headless
+{
+    HeadlessContext::HeadlessContext(ContextOptions const options)
+    {
+        try
+        {
+            init(options);
+        }
+        catch (...)
+        {
+            // Undo actions before throw as the destructor will not be called.
+            destroy();
+            throw;
+        }
+    }
+
+    HeadlessContext::~HeadlessContext() noexcept
+    {
+        destroy();
+    }
+
+    void HeadlessContext::make_context_current()
+    {
+        if (!eglMakeCurrent(display_, surface_, surface_, context_))
+        {
+            throw_egl_error("eglMakeCurrent");
+        }
+    }
+
+    void HeadlessContext::init(ContextOptions const& options)
+    {
+        display_ = get_display();
+
+        auto major = EGLint{};
+        auto minor = EGLint{};
+        if (!eglInitialize(display_, &major, &minor))
+        {
+            // Leave nothing for destroy() to terminate.
+            display_ = EGL_NO_DISPLAY;
+            throw_egl_error("eglInitialize");
+        }
+
+        if (!eglBindAPI(EGL_OPENGL_API))
+        {
+            throw_egl_error("eglBindAPI");
+        }
+
+        auto const surfaceless = options.width == 0
+                                 && options.height == 0
+                                 && has_extension(display_, "EGL_KHR_surfaceless_context");
+
+        auto const config_attribs = std::array<EGLint, 15>{
+            EGL_SURFACE_TYPE, surfaceless ? 0 : EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_RED_SIZE, 8,
+            EGL_GREEN_SIZE, 8,
+            EGL_BLUE_SIZE, 8,
+            EGL_ALPHA_SIZE, 8,
+            EGL_DEPTH_SIZE, 24,
+            EGL_NONE,
+        };
+        auto config = EGLConfig{};
+        auto config_count = EGLint{};
+        if (!eglChooseConfig(display_, config_attribs.data(), &config, 1, &config_count))
+        {
+            throw_egl_error("eglChooseConfig");
+        }
+        if (config_count == 0)
+        {
+            throw InitError{"No EGL config supports OpenGL rendering"};
+        }
+
+        auto const context_attribs = std::array<EGLint, 9>{
+            EGL_CONTEXT_MAJOR_VERSION, options.major_version,
+            EGL_CONTEXT_MINOR_VERSION, options.minor_version,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_CONTEXT_OPENGL_DEBUG, options.debug ? EGL_TRUE : EGL_FALSE,
+            EGL_NONE,
+        };
+        context_ = eglCreateContext(display_, config, EGL_NO_CONTEXT, context_attribs.data());
+        if (context_ == EGL_NO_CONTEXT)
+        {
+            throw_egl_error("eglCreateContext");
+        }
+
+        if (!surfaceless)
+        {
+            auto const surface_attribs = std::array<EGLint, 5>{
+                EGL_WIDTH, std::max(options.width, Size{1}),
+                EGL_HEIGHT, std::max(options.height, Size{1}),
+                EGL_NONE,
+            };
+            surface_ = eglCreatePbufferSurface(display_, config, surface_attribs.data());
+            if (surface_ == EGL_NO_SURFACE)
+            {
+                throw_egl_error("eglCreatePbufferSurface");
+            }
+        }
+
+        make_context_current();
+        load_gl();
+    }
+
+    void HeadlessContext::destroy() noexcept
+    {
+        if (display_ == EGL_NO_DISPLAY)
+        {
+            return;
+        }
+
+        eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (surface_ != EGL_NO_SURFACE)
+        {
+            eglDestroySurface(display_, surface_);
+        }
+        if (context_ != EGL_NO_CONTEXT)
+        {
+            eglDestroyContext(display_, context_);
+        }
+        eglTerminate(display_);
+
+        display_ = EGL_NO_DISPLAY;
+        context_ = EGL_NO_CONTEXT;
+        surface_ = EGL_NO_SURFACE;
+    }
+
+    void HeadlessContext::load_gl()
+    {
+        if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(eglGetProcAddress)))
+        {
+            throw InitError{"Failed to load OpenGL"};
+        }
+    }
+}  // namespace glpp::headless
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "glpp/headless/error.hpp"
+#include "glpp/primitive_types.hpp"
+
+namespace glpp::headless
+{
+    // EGL handles, so that consumers do not need the EGL headers;
+    // the same types as EGLDisplay, EGLContext and EGLSurface.
+    using EglDisplay = void*;
+    using EglContext = void*;
+    using EglSurface = void*;
+
+    struct ContextOptions
+    {
+        int major_version = 4;
+        int minor_version = 5;
+        bool debug = false;
+        // Size of the default framebuffer. 0 by 0 creates a surfaceless
+        // context where supported (render into glpp::Framebuffer instead);
+        // otherwise a 1 by 1 pbuffer is used.
+        Size width = 0;
+        Size height = 0;
+    };
+
+    // An OpenGL core profile context without a window or display,
+    // created through EGL. Prefers the Mesa surfaceless platform,
+    // so it works on display-less nodes with llvmpipe;
+    // falls back to the default EGL display.
+    class HeadlessContext
+    {
+      public:
+        // Creates the context, makes it current and loads OpenGL.
+        //
+        // Throws glpp::InitError, glpp::headless::EglError
+        HeadlessContext()
+          : HeadlessContext{ContextOptions{}}
+        {
+        }
+
+        explicit HeadlessContext(ContextOptions options);
+
+        HeadlessContext(HeadlessContext const&) = delete;
+        HeadlessContext(HeadlessContext&&) = delete;
+
+        ~HeadlessContext() noexcept;
+
+        auto operator=(HeadlessContext const&) -> HeadlessContext& = delete;
+        auto operator=(HeadlessContext&&) -> HeadlessContext& = delete;
+
+        // Throws glpp::headless::EglError
+        void make_context_current();
+
+        [[nodiscard]] auto is_surfaceless() const noexcept -> bool
+        {
+            return surface_ == nullptr;
+        }
+
+        [[nodiscard]] auto display() const noexcept -> EglDisplay { return display_; }
+
+        [[nodiscard]] auto context() const noexcept -> EglContext { return context_; }
+
+      private:
+        EglDisplay display_ = nullptr;
+        EglContext context_ = nullptr;
+        EglSurface surface_ = nullptr;
+
+        void init(ContextOptions const& options);
+
+        void destroy() noexcept;
+
+        // Throws glpp::InitError
+        static void load_gl();
+    };
+}  // namespace glpp::headless
@@ -0,0 +1,360 @@
+#include "glpp/image/decode.hpp"
+
+#include <algorithm>
+#include <array>
+#include <csetjmp>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+// jpeglib.h needs FILE and size_t declared first.
+#include <jpeglib.h>
+#include <png.h>
+#include "glpp/error.hpp"
+#include "glpp/mapped_file.hpp"
+
+namespace
+{
+    using glpp::image::DecodedImage;
+    using glpp::image::DecodeOptions;
+
+    constexpr auto png_signature = std::array<unsigned char, 8>{
+        0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A,
+    };
+    constexpr auto jpeg_signature = std::array<unsigned char, 3>{0xFF, 0xD8, 0xFF};
+
+    template <std::size_t n>
+    [[nodiscard]] auto has_signature(
+        std::span<std::byte const> const file,
+        std::array<unsigned char, n> const& signature) noexcept
+        -> bool
+    {
+        return file.size() >= n && std::memcmp(file.data(), signature.data(), n) == 0;
+    }
+
+    // Number of halvings needed to fit the size into the limits.
+    [[nodiscard]] auto downscale_steps(
+        glpp::Size width,
+        glpp::Size height,
+        DecodeOptions const& options) noexcept
+        -> int
+    {
+        auto steps = 0;
+        while ((options.max_width > 0 && width > options.max_width)
+               || (options.max_height > 0 && height > options.max_height))
+        {
+            if (width == 1 && height == 1)
+            {
+                break;
+            }
+            width = std::max(glpp::Size{1}, width / 2);
+            height = std::max(glpp::Size{1}, height / 2);
+            ++steps;
+        }
+        return steps;
+    }
+
+    [[nodiscard]] auto downscale(DecodedImage image, DecodeOptions const& options) -> DecodedImage
+    {
+        for (auto steps = downscale_steps(image.width, image.height, options); steps > 0; --steps)
+        {
+            image = downscale_half(image);
+        }
+        return image;
+    }
+
+    class PngImage
+    {
+      public:
+        PngImage() noexcept
+        {
+            image_.version = PNG_IMAGE_VERSION;
+        }
+
+        PngImage(PngImage const&) = delete;
+        PngImage(PngImage&&) = delete;
+
+        // Frees the decoder state if finish_read() was not reached.
+        ~PngImage() noexcept { png_image_free(&image_); }
+
+        auto operator=(PngImage const&) = delete;
+        auto operator=(PngImage&&) = delete;
+
+        [[nodiscard]] auto get() noexcept -> png_image& { return image_; }
+
+        [[noreturn]] void fail() const
+        {
+            throw glpp::TextureLoadError{
+                fmt::format("Failed to decode PNG: {0}", image_.message),
+            };
+        }
+
+      private:
+        png_image image_ = {};
+    };
+
+    // libjpeg reports errors through a callback that must not return;
+    // it jumps back into the step that failed. Steps hold no objects
+    // with destructors, which the jump would skip.
+    struct JpegErrorManager
+    {
+        jpeg_error_mgr manager;
+        std::jmp_buf jump;
+        std::array<char, JMSG_LENGTH_MAX> message;
+    };
+
+    [[noreturn]] void on_jpeg_error(j_common_ptr const info)
+    {
+        auto* const error = reinterpret_cast<JpegErrorManager*>(info->err);
+        error->manager.format_message(info, error->message.data());
+        std::longjmp(error->jump, 1);
+    }
+
+    void on_jpeg_message(j_common_ptr) noexcept
+    {
+        // Warnings about recoverable corruption are ignored.
+    }
+
+    class JpegDecompressor
+    {
+      public:
+        JpegDecompressor() noexcept
+        {
+            info_.err = jpeg_std_error(&error_.manager);
+            error_.manager.error_exit = on_jpeg_error;
+            error_.manager.output_message = on_jpeg_message;
+        }
+
+        JpegDecompressor(JpegDecompressor const&) = delete;
+        JpegDecompressor(JpegDecompressor&&) = delete;
+
+        // Safe on a zeroed struct, in case creation failed.
+        ~JpegDecompressor() noexcept { jpeg_destroy_decompress(&info_); }
+
+        auto operator=(JpegDecompressor const&) = delete;
+        auto operator=(JpegDecompressor&&) = delete;
+
+        [[nodiscard]] auto read_header(std::span<std::byte const> const file) noexcept -> bool
+        {
+            if (setjmp(error_.jump))
+            {
+                return false;
+            }
+
+            jpeg_create_decompress(&info_);
+            jpeg_mem_src(
+                &info_,
+                reinterpret_cast<unsigned char const*>(file.data()),
+                static_cast<unsigned long>(file.size()));
+            jpeg_read_header(&info_, TRUE);
+
+            return true;
+        }
+
+        [[nodiscard]] auto start(unsigned const scale_denom) noexcept -> bool
+        {
+            if (setjmp(error_.jump))
+            {
+                return false;
+            }
+
+            info_.out_color_space = info_.jpeg_color_space == JCS_GRAYSCALE ? JCS_GRAYSCALE : JCS_RGB;
+            info_.scale_num = 1;
+            info_.scale_denom = scale_denom;
+            jpeg_start_decompress(&info_);
+
+            return true;
+        }
+
+        [[nodiscard]] auto read_rows(glpp::UInt8* const pixels, std::size_t const row_stride) noexcept
+            -> bool
+        {
+            if (setjmp(error_.jump))
+            {
+                return false;
+            }
+
+            while (info_.output_scanline < info_.output_height)
+            {
+                JSAMPROW row = pixels + static_cast<std::size_t>(info_.output_scanline) * row_stride;
+                jpeg_read_scanlines(&info_, &row, 1);
+            }
+            jpeg_finish_decompress(&info_);
+
+            return true;
+        }
+
+        [[nodiscard]] auto info() const noexcept -> jpeg_decompress_struct const& { return info_; }
+
+        [[noreturn]] void fail() const
+        {
+            throw glpp::TextureLoadError{
+                fmt::format("Failed to decode JPEG: {0}", error_.message.data()),
+            };
+        }
+
+      private:
+        jpeg_decompress_struct info_ = {};
+        JpegErrorManager error_ = {};
+    };
+}  // namespace
+
+namespace glpp::image
+{
+    auto decode_png(
+        std::span<std::byte const> const file,
+        DecodeOptions const& options)
+        -> DecodedImage
+    {
+        auto png = PngImage{};
+        if (!png_image_begin_read_from_memory(&png.get(), file.data(), file.size()))
+        {
+            png.fail();
+        }
+        // Without this, 16 bit files lacking a gAMA or sRGB chunk are
+        // taken as linear, and gamma encoded when reduced to 8 bits.
+        png.get().flags |= PNG_IMAGE_FLAG_16BIT_sRGB;
+
+        auto const has_color = (png.get().format & PNG_FORMAT_FLAG_COLOR) != 0;
+        auto const has_alpha = (png.get().format & PNG_FORMAT_FLAG_ALPHA) != 0;
+
+        auto format = Texture::BasicFormat{};
+        if (has_color)
+        {
+            png.get().format = has_alpha ? PNG_FORMAT_RGBA : PNG_FORMAT_RGB;
+            format = has_alpha ? Texture::BasicFormat::rgba : Texture::BasicFormat::rgb;
+        }
+        else
+        {
+            png.get().format = has_alpha ? PNG_FORMAT_GA : PNG_FORMAT_GRAY;
+            format = has_alpha ? Texture::BasicFormat::rg : Texture::BasicFormat::r;
+        }
+
+        auto image = allocate_image(
+            static_cast<Size>(png.get().width),
+            static_cast<Size>(png.get().height),
+            format);
+        if (!png_image_finish_read(
+                &png.get(),
+                nullptr,
+                image.pixels.get(),
+                static_cast<png_int_32>(image.row_stride),
+                nullptr))
+        {
+            png.fail();
+        }
+
+        return downscale(std::move(image), options);
+    }
+
+    auto decode_jpeg(
+        std::span<std::byte const> const file,
+        DecodeOptions const& options)
+        -> DecodedImage
+    {
+        auto jpeg = JpegDecompressor{};
+
+        if (!jpeg.read_header(file))
+        {
+            jpeg.fail();
+        }
+
+        // libjpeg scales by 1/2, 1/4 and 1/8 in the DCT; cheaper than
+        // decoding at full size. Any further halving is done afterwards.
+        auto const steps = downscale_steps(
+            static_cast<Size>(jpeg.info().image_width),
+            static_cast<Size>(jpeg.info().image_height),
+            options);
+        if (!jpeg.start(1u << std::min(steps, 3)))
+        {
+            jpeg.fail();
+        }
+
+        auto image = allocate_image(
+            static_cast<Size>(jpeg.info().output_width),
+            static_cast<Size>(jpeg.info().output_height),
+            jpeg.info().output_components == 1 ? Texture::BasicFormat::r : Texture::BasicFormat::rgb);
+        if (!jpeg.read_rows(image.pixels.get(), image.row_stride))
+        {
+            jpeg.fail();
+        }
+
+        return downscale(std::move(image), options);
+    }
+
+    auto decode_raw(
+        std::span<std::byte const> const file,
+        RawLayout const& layout,
+        DecodeOptions const& options)
+        -> DecodedImage
+    {
+        auto const row_size = static_cast<std::size_t>(layout.width)
+                              * static_cast<std::size_t>(Texture::component_count(layout.format));
+        // Divided rather than multiplied, which could overflow.
+        auto const matches_layout = row_size == 0
+                                        ? file.empty()
+                                        : file.size() % row_size == 0
+                                              && file.size() / row_size == static_cast<std::size_t>(layout.height);
+        if (!matches_layout)
+        {
+            throw TextureLoadError{
+                fmt::format(
+                    "Raw file size {0} does not match a {1}x{2} image",
+                    file.size(),
+                    layout.width,
+                    layout.height),
+            };
+        }
+
+        // Allocated once the size is known to match, so that
+        // the layout can not request more than the file holds.
+        auto image = allocate_image(layout.width, layout.height, layout.format);
+        for (auto y = std::size_t{0}; y < static_cast<std::size_t>(layout.height); ++y)
+        {
+            std::memcpy(image.pixels.get() + y * image.row_stride, file.data() + y * row_size, row_size);
+        }
+
+        return downscale(std::move(image), options);
+    }
+
+    auto decode_image(
+        std::span<std::byte const> const file,
+        DecodeOptions const& options)
+        -> DecodedImage
+    {
+        if (has_signature(file, png_signature))
+        {
+            return decode_png(file, options);
+        }
+        if (has_signature(file, jpeg_signature))
+        {
+            return decode_jpeg(file, options);
+        }
+
+        throw TextureLoadError{"Unknown image file format"};
+    }
+
+    auto decode_file(
+        std::filesystem::path const& path,
+        DecodeOptions const& options,
+        std::optional<RawLayout> const& raw_layout)
+        -> DecodedImage
+    {
+        auto const file = MappedFile{path};
+
+        try
+        {
+            return raw_layout
+                       ? decode_raw(file.data(), *raw_layout, options)
+                       : decode_image(file.data(), options);
+        }
+        catch (TextureLoadError const& error)
+        {
+            throw TextureLoadError{
+                fmt::format("In file '{0}': {1}", path, error.what()),
+            };
+        }
+    }
+}  // namespace glpp::image
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <span>
+
+#include "glpp/image/decoded_image.hpp"
+#include "glpp/primitive_types.hpp"
+#include "glpp/texture.hpp"
+
+namespace glpp::image
+{
+    struct DecodeOptions
+    {
+        // Images larger than this are downscaled by powers of two until
+        // they fit; 0 means no limit. JPEG files are scaled while decoding
+        // (up to 1/8), which is much faster than decoding at full size.
+        Size max_width = 0;
+        Size max_height = 0;
+    };
+
+    // Layout of a raw file: tightly packed 8 bit rows without a header.
+    struct RawLayout
+    {
+        Size width;
+        Size height;
+        Texture::BasicFormat format = Texture::BasicFormat::rgba;
+    };
+
+    // Keeps the channels of the file (gray, gray + alpha, RGB or RGBA);
+    // palettes are expanded and 16 bit channels reduced to 8 bits.
+    //
+    // Throws glpp::TextureLoadError
+    [[nodiscard]] auto decode_png(
+        std::span<std::byte const> file,
+        DecodeOptions const& options = {})
+        -> DecodedImage;
+
+    // Decodes to RGB, or to a single channel for grayscale files.
+    //
+    // Throws glpp::TextureLoadError
+    [[nodiscard]] auto decode_jpeg(
+        std::span<std::byte const> file,
+        DecodeOptions const& options = {})
+        -> DecodedImage;
+
+    // Throws glpp::TextureLoadError
+    [[nodiscard]] auto decode_raw(
+        std::span<std::byte const> file,
+        RawLayout const& layout,
+        DecodeOptions const& options = {})
+        -> DecodedImage;
+
+    // Detects PNG and JPEG files from their signature.
+    //
+    // Throws glpp::TextureLoadError
+    [[nodiscard]] auto decode_image(
+        std::span<std::byte const> file,
+        DecodeOptions const& options = {})
+        -> DecodedImage;
+
+    // Memory-maps and decodes a file; raw files need their layout.
+    //
+    // Throws glpp::TextureLoadError, std::filesystem::filesystem_error
+    [[nodiscard]] auto decode_file(
+        std::filesystem::path const& path,
+        DecodeOptions const& options = {},
+        std::optional<RawLayout> const& raw_layout = std::nullopt)
+        -> DecodedImage;
+}  // namespace glpp::image
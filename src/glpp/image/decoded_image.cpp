@@ -0,0 +1,95 @@
+#include "glpp/image/decoded_image.hpp"
+
+#include <algorithm>
+#include <new>
+
+#include <fmt/format.h>
+#include "glpp/error.hpp"
+
+namespace
+{
+    // Larger images would not fit any texture anyway;
+    // also keeps the size computations from overflowing.
+    constexpr auto max_extent = glpp::Size{1} << 16;
+
+    [[nodiscard]] auto row_stride(
+        glpp::Size const width,
+        glpp::Texture::BasicFormat const format) noexcept
+        -> std::size_t
+    {
+        constexpr auto alignment = std::size_t{4};
+
+        auto const row_size = static_cast<std::size_t>(width)
+                              * static_cast<std::size_t>(glpp::Texture::component_count(format));
+        return (row_size + alignment - 1) / alignment * alignment;
+    }
+}  // namespace
+
+namespace glpp::image
+{
+    void AlignedDelete::operator()(UInt8* const pixels) const noexcept
+    {
+        ::operator delete[](pixels, std::align_val_t{pixel_alignment});
+    }
+
+    auto allocate_image(
+        Size const width,
+        Size const height,
+        Texture::BasicFormat const format)
+        -> DecodedImage
+    {
+        if (width <= 0 || height <= 0 || width > max_extent || height > max_extent)
+        {
+            throw TextureLoadError{
+                fmt::format("Invalid image size {0}x{1}", width, height),
+            };
+        }
+        if (format == Texture::BasicFormat::depth_component
+            || format == Texture::BasicFormat::depth_stencil)
+        {
+            throw TextureLoadError{"Depth formats can not be decoded into"};
+        }
+
+        auto image = DecodedImage{width, height, format, row_stride(width, format), {}};
+        image.pixels = PixelBuffer{
+            static_cast<UInt8*>(::operator new[](image.size_bytes(), std::align_val_t{pixel_alignment})),
+        };
+
+        return image;
+    }
+
+    auto downscale_half(DecodedImage const& image) -> DecodedImage
+    {
+        auto result = allocate_image(
+            std::max(Size{1}, image.width / 2),
+            std::max(Size{1}, image.height / 2),
+            image.format);
+
+        auto const components = static_cast<std::size_t>(Texture::component_count(image.format));
+        auto const last_x = static_cast<std::size_t>(image.width) - 1;
+        auto const last_y = static_cast<std::size_t>(image.height) - 1;
+
+        for (auto y = std::size_t{0}; y < static_cast<std::size_t>(result.height); ++y)
+        {
+            // Single texel rows and columns are repeated.
+            auto const* const row_0 = image.pixels.get() + std::min(y * 2, last_y) * image.row_stride;
+            auto const* const row_1 = image.pixels.get() + std::min(y * 2 + 1, last_y) * image.row_stride;
+            auto* const out = result.pixels.get() + y * result.row_stride;
+
+            for (auto x = std::size_t{0}; x < static_cast<std::size_t>(result.width); ++x)
+            {
+                auto const left = std::min(x * 2, last_x) * components;
+                auto const right = std::min(x * 2 + 1, last_x) * components;
+
+                for (auto c = std::size_t{0}; c < components; ++c)
+                {
+                    auto const sum = unsigned{row_0[left + c]} + row_0[right + c]
+                                     + row_1[left + c] + row_1[right + c];
+                    out[x * components + c] = static_cast<UInt8>((sum + 2) / 4);
+                }
+            }
+        }
+
+        return result;
+    }
+}  // namespace glpp::image
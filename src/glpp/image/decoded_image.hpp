@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include "glpp/primitive_types.hpp"
+#include "glpp/texture.hpp"
+
+namespace glpp::image
+{
+    // Alignment of decoded pixel memory; a cache line,
+    // so that rows can be processed with aligned SIMD loads.
+    inline constexpr auto pixel_alignment = std::size_t{64};
+
+    struct AlignedDelete
+    {
+        void operator()(UInt8* pixels) const noexcept;
+    };
+
+    using PixelBuffer = std::unique_ptr<UInt8[], AlignedDelete>;
+
+    // An 8 bit image in memory, ready to be uploaded.
+    // Rows are padded to the default unpack alignment of 4 bytes.
+    struct DecodedImage
+    {
+        Size width = 0;
+        Size height = 0;
+        Texture::BasicFormat format = Texture::BasicFormat::rgba;
+        std::size_t row_stride = 0;
+        PixelBuffer pixels;
+
+        [[nodiscard]] auto data() const noexcept -> Texture::Data
+        {
+            return {width, height, format, static_cast<UInt8 const*>(pixels.get())};
+        }
+
+        [[nodiscard]] auto size_bytes() const noexcept -> std::size_t
+        {
+            return row_stride * static_cast<std::size_t>(height);
+        }
+    };
+
+    // Allocates uninitialized pixel memory for an image of the given size.
+    //
+    // Throws glpp::TextureLoadError for empty or oversized images
+    [[nodiscard]] auto allocate_image(
+        Size width,
+        Size height,
+        Texture::BasicFormat format)
+        -> DecodedImage;
+
+    // Halves both dimensions (rounding down, to at least 1) with a box filter.
+    [[nodiscard]] auto downscale_half(DecodedImage const& image) -> DecodedImage;
+}  // namespace glpp::image
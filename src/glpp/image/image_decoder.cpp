@@ -0,0 +1,188 @@
+#include "glpp/image/image_decoder.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace
+{
+    using glpp::image::DecodeTicket;
+
+    struct QueueKey
+    {
+        int priority;
+        DecodeTicket ticket;
+    };
+
+    // Highest priority first, then oldest first.
+    struct QueueOrder
+    {
+        [[nodiscard]] auto operator()(QueueKey const& left, QueueKey const& right) const noexcept
+            -> bool
+        {
+            if (left.priority != right.priority)
+            {
+                return left.priority > right.priority;
+            }
+            return left.ticket < right.ticket;
+        }
+    };
+}  // namespace
+
+namespace glpp::image
+{
+    struct ImageDecoder::State
+    {
+        std::mutex mutex;
+        std::map<QueueKey, DecodeRequest, QueueOrder> queue;
+        std::unordered_map<DecodeTicket, int> queued_priorities;
+        std::unordered_set<DecodeTicket> decoding;
+        std::deque<DecodeResult> finished;
+        DecodeTicket next_ticket = 0;
+
+        // Runs on the pool; takes the highest priority request, if any is left.
+        void decode_next() noexcept
+        {
+            auto ticket = DecodeTicket{};
+            auto request = DecodeRequest{};
+            {
+                auto const lock = std::lock_guard{mutex};
+                if (queue.empty())
+                {
+                    // Cancelled; every request has one task.
+                    return;
+                }
+
+                auto node = queue.extract(queue.begin());
+                ticket = node.key().ticket;
+                request = std::move(node.mapped());
+                queued_priorities.erase(ticket);
+                decoding.insert(ticket);
+            }
+
+            auto result = DecodeResult{ticket, std::move(request.path), {}, nullptr};
+            try
+            {
+                result.image = decode_file(result.path, request.options, request.raw_layout);
+            }
+            catch (...)
+            {
+                result.error = std::current_exception();
+            }
+
+            auto const lock = std::lock_guard{mutex};
+            if (decoding.erase(ticket) > 0)
+            {
+                finished.push_back(std::move(result));
+            }
+        }
+    };
+
+    ImageDecoder::ImageDecoder(ThreadPool& pool)
+      : pool_{pool}
+      , state_{std::make_shared<State>()}
+    {
+    }
+
+    ImageDecoder::~ImageDecoder() noexcept
+    {
+        auto const lock = std::lock_guard{state_->mutex};
+
+        state_->queue.clear();
+        state_->queued_priorities.clear();
+        state_->decoding.clear();
+        state_->finished.clear();
+    }
+
+    auto ImageDecoder::enqueue(DecodeRequest request) -> DecodeTicket
+    {
+        auto ticket = DecodeTicket{};
+        {
+            auto const lock = std::lock_guard{state_->mutex};
+
+            ticket = state_->next_ticket++;
+            state_->queued_priorities.emplace(ticket, request.priority);
+            state_->queue.emplace(QueueKey{request.priority, ticket}, std::move(request));
+        }
+
+        pool_.submit([state = state_] { state->decode_next(); });
+
+        return ticket;
+    }
+
+    auto ImageDecoder::cancel(DecodeTicket const ticket) -> bool
+    {
+        auto const lock = std::lock_guard{state_->mutex};
+
+        if (auto const queued = state_->queued_priorities.find(ticket);
+            queued != state_->queued_priorities.end())
+        {
+            state_->queue.erase(QueueKey{queued->second, ticket});
+            state_->queued_priorities.erase(queued);
+            return true;
+        }
+
+        if (state_->decoding.erase(ticket) > 0)
+        {
+            return true;
+        }
+
+        auto const finished = std::find_if(
+            state_->finished.begin(),
+            state_->finished.end(),
+            [&](DecodeResult const& result) { return result.ticket == ticket; });
+        if (finished != state_->finished.end())
+        {
+            state_->finished.erase(finished);
+            return true;
+        }
+
+        return false;
+    }
+
+    auto ImageDecoder::set_priority(DecodeTicket const ticket, int const priority) -> bool
+    {
+        auto const lock = std::lock_guard{state_->mutex};
+
+        auto const queued = state_->queued_priorities.find(ticket);
+        if (queued == state_->queued_priorities.end())
+        {
+            return false;
+        }
+
+        auto node = state_->queue.extract(QueueKey{queued->second, ticket});
+        node.key().priority = priority;
+        state_->queue.insert(std::move(node));
+        queued->second = priority;
+
+        return true;
+    }
+
+    auto ImageDecoder::poll(std::size_t const max_results) -> std::vector<DecodeResult>
+    {
+        auto const lock = std::lock_guard{state_->mutex};
+
+        auto const count = std::min(max_results, state_->finished.size());
+        auto results = std::vector<DecodeResult>{};
+        results.reserve(count);
+
+        for (auto i = std::size_t{0}; i < count; ++i)
+        {
+            results.push_back(std::move(state_->finished.front()));
+            state_->finished.pop_front();
+        }
+
+        return results;
+    }
+
+    auto ImageDecoder::pending() const -> std::size_t
+    {
+        auto const lock = std::lock_guard{state_->mutex};
+
+        return state_->queue.size() + state_->decoding.size() + state_->finished.size();
+    }
+}  // namespace glpp::image
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "glpp/image/decode.hpp"
+#include "glpp/image/decoded_image.hpp"
+#include "glpp/thread_pool.hpp"
+
+namespace glpp::image
+{
+    using DecodeTicket = std::uint64_t;
+
+    struct DecodeRequest
+    {
+        std::filesystem::path path;
+        // Higher priorities are decoded first;
+        // equal priorities in the order they were enqueued.
+        int priority = 0;
+        DecodeOptions options = {};
+        // Set for raw files, see glpp::image::decode_file.
+        std::optional<RawLayout> raw_layout = std::nullopt;
+    };
+
+    struct DecodeResult
+    {
+        DecodeTicket ticket;
+        std::filesystem::path path;
+        // Empty if the decode failed.
+        DecodedImage image;
+        std::exception_ptr error;
+    };
+
+    // Decodes image files on a thread pool and hands the results
+    // to the GL thread, which uploads them, e.g. with
+    // texture.load(result.image.data()).
+    //
+    // Requests wait in a priority queue; every pool task decodes
+    // whichever request has the highest priority when it starts,
+    // so reprioritizing (e.g. on scroll) takes effect immediately.
+    class ImageDecoder
+    {
+      public:
+        explicit ImageDecoder(ThreadPool& pool);
+
+        ImageDecoder(ImageDecoder const&) = delete;
+        ImageDecoder(ImageDecoder&&) = delete;
+
+        // Cancels all requests; decodes in progress finish
+        // on the pool and their results are dropped.
+        ~ImageDecoder() noexcept;
+
+        auto operator=(ImageDecoder const&) -> ImageDecoder& = delete;
+        auto operator=(ImageDecoder&&) -> ImageDecoder& = delete;
+
+        // Callable from any thread.
+        auto enqueue(DecodeRequest request) -> DecodeTicket;
+
+        // Callable from any thread. The result of a cancelled request is
+        // never returned by poll(), even if the decode already started.
+        // Returns false if the result was already returned or cancelled.
+        auto cancel(DecodeTicket ticket) -> bool;
+
+        // Callable from any thread. Returns false if the
+        // decode already started or the ticket is unknown.
+        auto set_priority(DecodeTicket ticket, int priority) -> bool;
+
+        // Returns up to max_results finished decodes in completion order;
+        // limiting the count spreads uploads over several frames.
+        [[nodiscard]] auto poll(
+            std::size_t max_results = std::numeric_limits<std::size_t>::max())
+            -> std::vector<DecodeResult>;
+
+        // Number of requests whose results were not returned by poll() yet.
+        [[nodiscard]] auto pending() const -> std::size_t;
+
+      private:
+        // Shared with the pool tasks, which may outlive the decoder.
+        struct State;
+
+        ThreadPool& pool_;
+        std::shared_ptr<State> state_;
+    };
+}  // namespace glpp::image
@@ -1,7 +1,9 @@
 #include "glpp/load_shader.hpp"
 
 #include <algorithm>
+#include <array>
 #include <fstream>
+#include <memory>
 #include <sstream>
 #include <unordered_set>
 #include <vector>
@@ -9,6 +11,7 @@
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 #include <magic_enum.hpp>
+#include "glpp/shader_source_cache.hpp"
 
 namespace
 {
@@ -67,134 +70,111 @@ namespace
         return std::nullopt;
     }
 
+    // Names files in the legend of the resolved source, which has to be
+    // the same wherever it is resolved (for program caches and bundles):
+    // sources relative to an include directory containing them, or by
+    // their file name.
+    [[nodiscard]] auto source_legend_name(
+        std::filesystem::path const& source,
+        std::span<std::filesystem::path const> const include_directories)
+        -> std::string
+    {
+        for (auto const& include_dir : include_directories)
+        {
+            auto const relative = source.lexically_relative(include_dir);
+            if (!relative.empty() && *relative.begin() != "..")
+            {
+                return relative.generic_string();
+            }
+        }
+
+        return source.filename().generic_string();
+    }
+
+    struct ResolvedFile
+    {
+        std::filesystem::path path;
+        // In the legend; an included file as written in the #include.
+        std::string legend_name;
+        std::filesystem::path canonical_path;
+        std::shared_ptr<glpp::ShaderSourceFile const> file;
+    };
+
     void resolve_includes(
         std::filesystem::path const& source,
+        std::string legend_name,
         std::span<std::filesystem::path const> const include_directories,
-        std::vector<std::string>& source_fragments,
+        std::vector<ResolvedFile>& resolved,
         std::unordered_set<std::string>& open_files,
         std::unordered_set<std::string>& resolved_files,
-        glpp::ShaderFilesystem const& filesystem)
+        glpp::ShaderFilesystem const& filesystem,
+        glpp::ShaderSourceCache* const source_cache)
     {
-        auto source_canonical = filesystem.canonical(source).string();
-        if (resolved_files.find(source_canonical) != resolved_files.end())
+        auto const source_canonical = filesystem.canonical(source);
+        auto const source_key = source_canonical.string();
+        if (resolved_files.find(source_key) != resolved_files.end())
         {
             return;
         }
 
-        if (open_files.find(source_canonical) != open_files.end())
+        if (open_files.find(source_key) != open_files.end())
         {
             throw glpp::ShaderCompilationError{
                 fmt::format("Cyclical dependency to file '{0}'", source),
             };
         }
-        open_files.insert(std::move(source_canonical));
-
-        auto const file = filesystem.open(source);
-        if (file == nullptr || !*file)
-        {
-            throw glpp::ShaderCompilationError{
-                fmt::format("Failed to open shader source '{0}'", source),
-            };
-        }
-
-        auto line = std::string{};
-        auto token = std::string{};
-        auto fragment = std::string{};
+        open_files.insert(source_key);
 
-        bool prologue_end = false;
-        int line_no = 1;
+        auto const file = source_cache != nullptr
+                              ? source_cache->get(source_canonical, filesystem)
+                              : std::make_shared<glpp::ShaderSourceFile const>(
+                                  glpp::read_shader_source_file(source, filesystem));
 
-        while (std::getline(*file, line))
+        for (auto const& include : file->includes)
         {
-            auto line_stream = std::istringstream{line};
-            if (line_stream >> token)
+            if (auto include_full_path
+                = find_include(
+                    include.path,
+                    include_directories,
+                    filesystem))
             {
-                if (token == "#include")
-                {
-                    if (prologue_end)
-                    {
-                        throw glpp::ShaderCompilationError{
-                            fmt::format(
-                                "In file '{0}' at line {1}: "
-                                "Invalid #include directive after non-empty line",
-                                source,
-                                line_no),
-                        };
-                    }
-
-                    if (line_stream >> token
-                        && token.front() == '"'
-                        && token.back() == '"')
-                    {
-                        auto include_file = std::filesystem::path{
-                            token.substr(1, token.size() - 2),
-                        };
-                        if (auto include_full_path
-                            = find_include(
-                                include_file, 
-                                include_directories,
-                                filesystem))
-                        {
-                            resolve_includes(
-                                *include_full_path,
-                                include_directories,
-                                source_fragments,
-                                open_files,
-                                resolved_files,
-                                filesystem);
-                            line.clear();
-                        }
-                        else
-                        {
-                            throw glpp::ShaderCompilationError{
-                                fmt::format(
-                                    "In file '{0}' at line {1}: "
-                                    "Failed to open shader include '{2}'",
-                                    source,
-                                    line_no,
-                                    include_file),
-                            };
-                        }
-                    }
-                    else
-                    {
-                        throw glpp::ShaderCompilationError{
-                            fmt::format(
-                                "In file '{0}' at line {1}: "
-                                "Invalid #include directive: '{2}'",
-                                source,
-                                line_no,
-                                line),
-                        };
-                    }
-                }
-                else
-                {
-                    prologue_end = true;
-                }
+                resolve_includes(
+                    *include_full_path,
+                    include.path.generic_string(),
+                    include_directories,
+                    resolved,
+                    open_files,
+                    resolved_files,
+                    filesystem,
+                    source_cache);
+            }
+            else
+            {
+                throw glpp::ShaderCompilationError{
+                    fmt::format(
+                        "In file '{0}' at line {1}: "
+                        "Failed to open shader include '{2}'",
+                        source,
+                        include.line,
+                        include.path),
+                };
             }
-
-            fragment += line;
-            fragment += "\n";
-            line_no++;
         }
 
-        source_fragments.push_back(fragment);
-        resolved_files.insert(source_canonical);
+        resolved.push_back(ResolvedFile{source, std::move(legend_name), source_canonical, file});
+        open_files.erase(source_key);
+        resolved_files.insert(source_key);
     }
 
-    [[nodiscard]] auto resolve_source_fragments(
-        glpp::GlslVersion const version,
+    // Every source and include file once, in dependency order.
+    [[nodiscard]] auto resolve_files(
         std::span<std::filesystem::path const> const sources,
         std::span<std::filesystem::path const> const include_directories,
-        std::span<glpp::MacroDefinition const> const definitions,
-        glpp::ShaderFilesystem const& filesystem)
-        -> std::vector<std::string>
+        glpp::ShaderFilesystem const& filesystem,
+        glpp::ShaderSourceCache* const source_cache)
+        -> std::vector<ResolvedFile>
     {
-        auto source_fragments = std::vector<std::string>{};
-        source_fragments.push_back(
-            prelude_fragment(version, definitions));
-
+        auto resolved = std::vector<ResolvedFile>{};
         auto open_files = std::unordered_set<std::string>{};
         auto resolved_files = std::unordered_set<std::string>{};
 
@@ -202,36 +182,111 @@ namespace
         {
             resolve_includes(
                 source,
+                source_legend_name(source, include_directories),
                 include_directories,
-                source_fragments,
+                resolved,
                 open_files,
                 resolved_files,
-                filesystem);
+                filesystem,
+                source_cache);
+        }
+
+        return resolved;
+    }
+
+    // Files are numbered from 1 in #line directives, so that compile
+    // errors ("file:line") point into them; 0 is the prelude.
+    // Before GLSL 3.30, "#line n" numbers the following line n + 1.
+    [[nodiscard]] auto line_directive(
+        glpp::GlslVersion const version,
+        std::size_t const file_index)
+        -> std::string
+    {
+        auto const first_line = version.version_number < glpp::GlslVersionNumber::glsl_330 ? 0 : 1;
+
+        return fmt::format("#line {0} {1}\n", first_line, file_index);
+    }
+
+    // Joins the files into a single fragment, after a legend of their
+    // numbers, which compile errors end with.
+    [[nodiscard]] auto assemble(
+        glpp::GlslVersion const version,
+        std::span<ResolvedFile const> const files)
+        -> std::string
+    {
+        auto file_names = std::vector<std::string>{};
+        file_names.reserve(files.size());
+        for (auto const& file : files)
+        {
+            file_names.push_back(file.legend_name);
+        }
+        auto const legend = glpp::source_file_legend(file_names);
+
+        auto directives = std::vector<std::string>{};
+        auto size = legend.size();
+        for (auto index = std::size_t{0}; index < files.size(); ++index)
+        {
+            directives.push_back(line_directive(version, index + 1));
+            size += directives.back().size() + files[index].file->fragment.size();
         }
 
-        return source_fragments;
+        auto body = std::string{};
+        body.reserve(size);
+        body += legend;
+        for (auto index = std::size_t{0}; index < files.size(); ++index)
+        {
+            body += directives[index];
+            body += files[index].file->fragment;
+        }
+
+        return body;
     }
+
 }  // namespace
 
 namespace glpp
 {
+    auto resolve_shader_sources(
+        GlslVersion const version,
+        std::span<std::filesystem::path const> const sources,
+        std::span<std::filesystem::path const> const include_directories,
+        std::span<MacroDefinition const> const definitions,
+        ShaderFilesystem const& filesystem,
+        ShaderSourceCache* const source_cache,
+        std::vector<std::filesystem::path>* const dependencies)
+        -> std::vector<std::string>
+    {
+        auto const files = resolve_files(sources, include_directories, filesystem, source_cache);
+        if (dependencies != nullptr)
+        {
+            for (auto const& file : files)
+            {
+                dependencies->push_back(file.canonical_path);
+            }
+        }
+
+        return {
+            prelude_fragment(version, definitions),
+            assemble(version, files),
+        };
+    }
+
     [[nodiscard]] auto load_shader(
         ShaderType const type,
         GlslVersion const version,
         std::span<std::filesystem::path const> const sources,
         std::span<std::filesystem::path const> const include_directories,
         std::span<MacroDefinition const> const definitions,
-        ShaderFilesystem const& filesystem)
+        ShaderFilesystem const& filesystem,
+        ShaderSourceCache* const source_cache)
         -> Shader
     {
-        return Shader{
-            type,
-            resolve_source_fragments(
-                version,
-                sources,
-                include_directories,
-                definitions,
-                filesystem),
+        auto const files = resolve_files(sources, include_directories, filesystem, source_cache);
+        auto const fragments = std::array{
+            prelude_fragment(version, definitions),
+            assemble(version, files),
         };
+
+        return Shader{type, fragments};
     }
 }  // namespace glpp
@@ -1,14 +1,31 @@
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <memory>
+#include <optional>
 #include <span>
+#include <string>
+#include <vector>
 
 #include "glpp/shader.hpp"
 
 namespace glpp
 {
+    class ShaderSourceCache;
+
+    // Identifies the contents of a file; see glpp::ShaderSourceCache.
+    struct ShaderFileStamp
+    {
+        std::filesystem::file_time_type last_write_time;
+        std::uintmax_t size;
+        // For filesystems without meaningful write times; 0 if unused.
+        std::uint64_t content_hash = 0;
+
+        [[nodiscard]] auto operator==(ShaderFileStamp const&) const noexcept -> bool = default;
+    };
+
     class ShaderFilesystem
     {
       public:
@@ -25,6 +42,14 @@ namespace glpp
             std::filesystem::path const& path) const
             -> std::unique_ptr<std::istream> = 0;
 
+        // Files without a stamp are never cached.
+        [[nodiscard]] virtual auto stamp(
+            std::filesystem::path const& /*path*/) const
+            -> std::optional<ShaderFileStamp>
+        {
+            return std::nullopt;
+        }
+
       protected:
         ~ShaderFilesystem() noexcept = default;
     };
@@ -50,10 +75,53 @@ namespace glpp
             std::filesystem::path const& path) const
             -> std::unique_ptr<std::istream> override
         {
-            return std::make_unique<std::ifstream>(path);
+            // Binary, so that SPIR-V modules can be read too.
+            return std::make_unique<std::ifstream>(path, std::ios::binary);
+        }
+
+        [[nodiscard]] auto stamp(
+            std::filesystem::path const& path) const
+            -> std::optional<ShaderFileStamp> override
+        {
+            return ShaderFileStamp{
+                std::filesystem::last_write_time(path),
+                std::filesystem::file_size(path),
+            };
         }
     };
 
+    // The source files of one shader of a program.
+    struct ShaderStage
+    {
+        ShaderType type;
+        std::vector<std::filesystem::path> sources;
+    };
+
+    // Resolves the sources of a shader as load_shader() does,
+    // returning the source fragments it would compile: a prelude
+    // with the version and macro definitions, then a fragment with
+    // every source and include file once. Each file starts with
+    // a #line directive, numbering the files from 1 in dependency
+    // order, so compile errors refer to "file:line"; the fragment
+    // starts with a glpp::source_file_legend() of the numbers. So that
+    // the resolved sources do not depend on the working directory,
+    // the legend names included files as written in their #include,
+    // and sources relative to the include directory containing them,
+    // or by their file name.
+    // The canonical paths of all the files are appended to dependencies.
+    //
+    // Throws glpp::ShaderCompilationError,
+    // std::filesystem::filesystem_error
+    [[nodiscard]] auto resolve_shader_sources(
+        GlslVersion version,
+        std::span<std::filesystem::path const> sources,
+        std::span<std::filesystem::path const> include_directories = {},
+        std::span<MacroDefinition const> definitions = {},
+        ShaderFilesystem const& filesystem = DefaultShaderFilesystem{},
+        ShaderSourceCache* source_cache = nullptr,
+        std::vector<std::filesystem::path>* dependencies = nullptr)
+        -> std::vector<std::string>;
+
     // Compiles a shader from source files.
     // Sources can use non-standard #include "" directive;
     // includes are resolved from the include directories.
@@ -62,6 +130,11 @@ namespace glpp
     // Multiple includes of the same file are ignored.
     // Sources should not declare GLSL version, instead the version
     // is passed as parameter to this function.
+    // With a source cache, files are only read and parsed again
+    // when they change.
+    // Compilation errors end with a legend of the file numbers
+    // (see resolve_shader_sources()), as they do when the sources
+    // are compiled in other ways, e.g. by a glpp::ShaderCompiler.
     //
     // Throws glpp::Error, glpp::ShaderCompilationError,
     // std::filesystem::filesystem_error
@@ -71,6 +144,7 @@ namespace glpp
         std::span<std::filesystem::path const> sources,
         std::span<std::filesystem::path const> include_directories = {},
         std::span<MacroDefinition const> definitions = {},
-        ShaderFilesystem const& filesystem = DefaultShaderFilesystem{})
+        ShaderFilesystem const& filesystem = DefaultShaderFilesystem{},
+        ShaderSourceCache* source_cache = nullptr)
         -> Shader;
 }  // namespace glpp
\ No newline at end of file
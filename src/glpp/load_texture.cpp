@@ -0,0 +1,408 @@
+#include "glpp/load_texture.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+#include "glpp/error.hpp"
+#include "glpp/scoped_bind.hpp"
+
+namespace
+{
+    using CompressedInternalFormat = glpp::Texture::CompressedInternalFormat;
+
+    // Container fields are little endian, as is every supported platform.
+    template <typename T>
+    [[nodiscard]] auto read(
+        std::span<std::byte const> const file,
+        std::size_t const offset)
+        -> T
+    {
+        if (offset > file.size() || file.size() - offset < sizeof(T))
+        {
+            throw glpp::TextureLoadError{"Truncated texture container"};
+        }
+
+        auto value = T{};
+        std::memcpy(&value, file.data() + offset, sizeof(T));
+        return value;
+    }
+
+    [[nodiscard]] constexpr auto four_cc(char const (&code)[5]) -> std::uint32_t
+    {
+        return static_cast<std::uint32_t>(static_cast<unsigned char>(code[0]))
+               | static_cast<std::uint32_t>(static_cast<unsigned char>(code[1])) << 8
+               | static_cast<std::uint32_t>(static_cast<unsigned char>(code[2])) << 16
+               | static_cast<std::uint32_t>(static_cast<unsigned char>(code[3])) << 24;
+    }
+
+    [[nodiscard]] auto level_extent(glpp::Size const size, std::size_t const level)
+        -> glpp::Size
+    {
+        return std::max(glpp::Size{1}, size >> level);
+    }
+
+    // Slices tightly packed levels starting at offset.
+    [[nodiscard]] auto packed_levels(
+        std::span<std::byte const> const file,
+        std::size_t offset,
+        CompressedInternalFormat const format,
+        glpp::Size const width,
+        glpp::Size const height,
+        std::size_t const level_count)
+        -> std::vector<std::span<std::byte const>>
+    {
+        auto levels = std::vector<std::span<std::byte const>>{};
+        levels.reserve(level_count);
+
+        for (auto level = std::size_t{0}; level < level_count; ++level)
+        {
+            auto const size = glpp::compressed_image_size(
+                format,
+                level_extent(width, level),
+                level_extent(height, level));
+            if (offset > file.size() || file.size() - offset < size)
+            {
+                throw glpp::TextureLoadError{"Truncated texture container"};
+            }
+
+            levels.push_back(file.subspan(offset, size));
+            offset += size;
+        }
+
+        return levels;
+    }
+
+    namespace dds
+    {
+        constexpr auto magic = four_cc("DDS ");
+        constexpr auto header_size = std::uint32_t{124};
+        constexpr auto data_offset = std::size_t{128};
+        constexpr auto dx10_data_offset = std::size_t{148};
+
+        constexpr auto flag_mipmap_count = std::uint32_t{0x20000};
+        constexpr auto pixel_format_flag_four_cc = std::uint32_t{0x4};
+        constexpr auto caps2_cube_map = std::uint32_t{0x200};
+        constexpr auto caps2_volume = std::uint32_t{0x200000};
+        constexpr auto dx10_misc_cube_map = std::uint32_t{0x4};
+        constexpr auto dx10_dimension_texture_2d = std::uint32_t{3};
+
+        [[nodiscard]] auto format_from_four_cc(std::uint32_t const code)
+            -> std::optional<CompressedInternalFormat>
+        {
+            if (code == four_cc("ATI1") || code == four_cc("BC4U"))
+            {
+                return CompressedInternalFormat::compressed_red_rgtc1;
+            }
+            if (code == four_cc("BC4S"))
+            {
+                return CompressedInternalFormat::compressed_signed_red_rgtc1;
+            }
+            if (code == four_cc("ATI2") || code == four_cc("BC5U"))
+            {
+                return CompressedInternalFormat::compressed_rg_rgtc2;
+            }
+            if (code == four_cc("BC5S"))
+            {
+                return CompressedInternalFormat::compressed_signed_rg_rgtc2;
+            }
+            return std::nullopt;
+        }
+
+        [[nodiscard]] auto format_from_dxgi(std::uint32_t const dxgi_format)
+            -> std::optional<CompressedInternalFormat>
+        {
+            switch (dxgi_format)
+            {
+                case 80: return CompressedInternalFormat::compressed_red_rgtc1;
+                case 81: return CompressedInternalFormat::compressed_signed_red_rgtc1;
+                case 83: return CompressedInternalFormat::compressed_rg_rgtc2;
+                case 84: return CompressedInternalFormat::compressed_signed_rg_rgtc2;
+                case 95: return CompressedInternalFormat::compressed_rgb_bptc_unsigned_float;
+                case 96: return CompressedInternalFormat::compressed_rgb_bptc_signed_float;
+                case 98: return CompressedInternalFormat::compressed_rgba_bptc_unorm;
+                case 99: return CompressedInternalFormat::compressed_srgb_alpha_bptc_unorm;
+                default: return std::nullopt;
+            }
+        }
+    }  // namespace dds
+
+    namespace ktx2
+    {
+        constexpr auto identifier = std::array<unsigned char, 12>{
+            0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A,
+        };
+        constexpr auto level_index_offset = std::size_t{80};
+        constexpr auto level_index_entry_size = std::size_t{24};
+
+        [[nodiscard]] auto format_from_vk(std::uint32_t const vk_format)
+            -> std::optional<CompressedInternalFormat>
+        {
+            switch (vk_format)
+            {
+                case 139: return CompressedInternalFormat::compressed_red_rgtc1;
+                case 140: return CompressedInternalFormat::compressed_signed_red_rgtc1;
+                case 141: return CompressedInternalFormat::compressed_rg_rgtc2;
+                case 142: return CompressedInternalFormat::compressed_signed_rg_rgtc2;
+                case 143: return CompressedInternalFormat::compressed_rgb_bptc_unsigned_float;
+                case 144: return CompressedInternalFormat::compressed_rgb_bptc_signed_float;
+                case 145: return CompressedInternalFormat::compressed_rgba_bptc_unorm;
+                case 146: return CompressedInternalFormat::compressed_srgb_alpha_bptc_unorm;
+                default: return std::nullopt;
+            }
+        }
+
+        [[nodiscard]] auto has_identifier(std::span<std::byte const> const file) -> bool
+        {
+            return file.size() >= identifier.size()
+                   && std::memcmp(file.data(), identifier.data(), identifier.size()) == 0;
+        }
+    }  // namespace ktx2
+
+    [[nodiscard]] auto checked_extent(std::uint32_t const extent) -> glpp::Size
+    {
+        // Also rules out sizes whose level chain would overflow.
+        if (extent == 0 || extent > (1u << 16))
+        {
+            throw glpp::TextureLoadError{
+                fmt::format("Invalid texture extent {0}", extent),
+            };
+        }
+        return static_cast<glpp::Size>(extent);
+    }
+
+    [[nodiscard]] auto checked_level_count(
+        std::uint32_t const level_count,
+        glpp::Size const width,
+        glpp::Size const height)
+        -> std::size_t
+    {
+        auto max_levels = std::size_t{1};
+        while ((std::max(width, height) >> max_levels) > 0)
+        {
+            ++max_levels;
+        }
+
+        if (level_count > max_levels)
+        {
+            throw glpp::TextureLoadError{
+                fmt::format("Invalid mip level count {0}", level_count),
+            };
+        }
+        return std::max(std::size_t{1}, std::size_t{level_count});
+    }
+}  // namespace
+
+namespace glpp
+{
+    auto compressed_block_size(Texture::CompressedInternalFormat const format)
+        -> std::size_t
+    {
+        switch (format)
+        {
+            case CompressedInternalFormat::compressed_red_rgtc1:
+            case CompressedInternalFormat::compressed_signed_red_rgtc1:
+                return 8;
+            case CompressedInternalFormat::compressed_rg_rgtc2:
+            case CompressedInternalFormat::compressed_signed_rg_rgtc2:
+            case CompressedInternalFormat::compressed_rgba_bptc_unorm:
+            case CompressedInternalFormat::compressed_srgb_alpha_bptc_unorm:
+            case CompressedInternalFormat::compressed_rgb_bptc_signed_float:
+            case CompressedInternalFormat::compressed_rgb_bptc_unsigned_float:
+                return 16;
+            default:
+                throw TextureLoadError{"Generic compressed formats have no block size"};
+        }
+    }
+
+    auto compressed_image_size(
+        Texture::CompressedInternalFormat const format,
+        Size const width,
+        Size const height)
+        -> std::size_t
+    {
+        auto const blocks_x = static_cast<std::size_t>((width + 3) / 4);
+        auto const blocks_y = static_cast<std::size_t>((height + 3) / 4);
+
+        return blocks_x * blocks_y * compressed_block_size(format);
+    }
+
+    auto parse_dds(std::span<std::byte const> const file)
+        -> CompressedImage
+    {
+        if (read<std::uint32_t>(file, 0) != dds::magic
+            || read<std::uint32_t>(file, 4) != dds::header_size)
+        {
+            throw TextureLoadError{"Not a DDS file"};
+        }
+
+        auto const flags = read<std::uint32_t>(file, 8);
+        auto const height = checked_extent(read<std::uint32_t>(file, 12));
+        auto const width = checked_extent(read<std::uint32_t>(file, 16));
+        auto const level_count = checked_level_count(
+            (flags & dds::flag_mipmap_count) ? read<std::uint32_t>(file, 28) : 1,
+            width,
+            height);
+        auto const pixel_format_flags = read<std::uint32_t>(file, 80);
+        auto const code = read<std::uint32_t>(file, 84);
+        auto const caps2 = read<std::uint32_t>(file, 112);
+
+        if (caps2 & (dds::caps2_cube_map | dds::caps2_volume))
+        {
+            throw TextureLoadError{"DDS cube maps and volumes are not supported"};
+        }
+        if (!(pixel_format_flags & dds::pixel_format_flag_four_cc))
+        {
+            throw TextureLoadError{"Uncompressed DDS files are not supported"};
+        }
+
+        auto format = std::optional<CompressedInternalFormat>{};
+        auto data_offset = dds::data_offset;
+        if (code == four_cc("DX10"))
+        {
+            format = dds::format_from_dxgi(read<std::uint32_t>(file, 128));
+
+            if (read<std::uint32_t>(file, 132) != dds::dx10_dimension_texture_2d
+                || (read<std::uint32_t>(file, 136) & dds::dx10_misc_cube_map)
+                || read<std::uint32_t>(file, 140) > 1)
+            {
+                throw TextureLoadError{"Only single 2D DDS textures are supported"};
+            }
+            data_offset = dds::dx10_data_offset;
+        }
+        else
+        {
+            format = dds::format_from_four_cc(code);
+        }
+
+        if (!format)
+        {
+            throw TextureLoadError{"Unsupported DDS pixel format"};
+        }
+
+        return CompressedImage{
+            *format,
+            width,
+            height,
+            packed_levels(file, data_offset, *format, width, height, level_count),
+        };
+    }
+
+    auto parse_ktx2(std::span<std::byte const> const file)
+        -> CompressedImage
+    {
+        if (!ktx2::has_identifier(file))
+        {
+            throw TextureLoadError{"Not a KTX2 file"};
+        }
+
+        auto const format = ktx2::format_from_vk(read<std::uint32_t>(file, 12));
+        if (!format)
+        {
+            throw TextureLoadError{"Unsupported KTX2 pixel format"};
+        }
+
+        auto const width = checked_extent(read<std::uint32_t>(file, 20));
+        auto const height = checked_extent(read<std::uint32_t>(file, 24));
+        if (read<std::uint32_t>(file, 28) != 0
+            || read<std::uint32_t>(file, 32) > 1
+            || read<std::uint32_t>(file, 36) != 1)
+        {
+            throw TextureLoadError{"Only single 2D KTX2 textures are supported"};
+        }
+
+        auto const level_count = checked_level_count(read<std::uint32_t>(file, 40), width, height);
+        if (read<std::uint32_t>(file, 44) != 0)
+        {
+            throw TextureLoadError{"Supercompressed KTX2 files are not supported"};
+        }
+
+        auto levels = std::vector<std::span<std::byte const>>{};
+        levels.reserve(level_count);
+        for (auto level = std::size_t{0}; level < level_count; ++level)
+        {
+            auto const entry = ktx2::level_index_offset + level * ktx2::level_index_entry_size;
+            auto const offset = read<std::uint64_t>(file, entry);
+            auto const size = read<std::uint64_t>(file, entry + 8);
+
+            auto const expected_size = compressed_image_size(
+                *format,
+                level_extent(width, level),
+                level_extent(height, level));
+            if (size != expected_size
+                || offset > file.size()
+                || file.size() - offset < size)
+            {
+                throw TextureLoadError{
+                    fmt::format("Corrupted KTX2 level {0}", level),
+                };
+            }
+
+            levels.push_back(file.subspan(
+                static_cast<std::size_t>(offset),
+                static_cast<std::size_t>(size)));
+        }
+
+        return CompressedImage{*format, width, height, std::move(levels)};
+    }
+
+    auto parse_compressed_image(std::span<std::byte const> const file)
+        -> CompressedImage
+    {
+        if (ktx2::has_identifier(file))
+        {
+            return parse_ktx2(file);
+        }
+        return parse_dds(file);
+    }
+
+    void load_compressed_image(Texture& texture, CompressedImage const& image) noexcept
+    {
+        for (auto level = std::size_t{0}; level < image.levels.size(); ++level)
+        {
+            texture.load_compressed(
+                Texture::CompressedData{
+                    level_extent(image.width, level),
+                    level_extent(image.height, level),
+                    image.format,
+                    image.levels[level],
+                },
+                static_cast<Int32>(level));
+        }
+
+        texture.set_max_level(static_cast<Int32>(image.levels.size()) - 1);
+    }
+
+    auto load_compressed_texture(
+        std::filesystem::path const& path,
+        Texture::Filter const filter,
+        Texture::WrapBehaviour const wrap_behaviour)
+        -> Texture
+    {
+        auto const file = MappedFile{path};
+
+        auto const image = [&] {
+            try
+            {
+                return parse_compressed_image(file.data());
+            }
+            catch (TextureLoadError const& error)
+            {
+                throw TextureLoadError{
+                    fmt::format("In file '{0}': {1}", path, error.what()),
+                };
+            }
+        }();
+
+        auto texture = Texture{};
+        load_compressed_image(texture, image);
+        texture.set_filter(filter);
+        texture.set_wrap_behaviour(wrap_behaviour);
+
+        return texture;
+    }
+}  // namespace glpp
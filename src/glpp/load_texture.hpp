@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+#include "glpp/mapped_file.hpp"
+#include "glpp/primitive_types.hpp"
+#include "glpp/texture.hpp"
+
+namespace glpp
+{
+    // A block compressed 2D image with its mip chain,
+    // viewing the memory of a parsed container file.
+    struct CompressedImage
+    {
+        Texture::CompressedInternalFormat format;
+        Size width;
+        Size height;
+        // Level 0 first.
+        std::vector<std::span<std::byte const>> levels;
+    };
+
+    // Size in bytes of a single 4x4 block of a block compressed format.
+    //
+    // Throws glpp::TextureLoadError for the generic compressed formats
+    [[nodiscard]] auto compressed_block_size(Texture::CompressedInternalFormat format)
+        -> std::size_t;
+
+    [[nodiscard]] auto compressed_image_size(
+        Texture::CompressedInternalFormat format,
+        Size width,
+        Size height)
+        -> std::size_t;
+
+    // Supports BC4, BC5, BC6H and BC7 2D textures,
+    // both in the legacy and the DX10 header variant.
+    //
+    // Throws glpp::TextureLoadError
+    [[nodiscard]] auto parse_dds(std::span<std::byte const> file)
+        -> CompressedImage;
+
+    // Supports BC4, BC5, BC6H and BC7 2D textures without supercompression.
+    //
+    // Throws glpp::TextureLoadError
+    [[nodiscard]] auto parse_ktx2(std::span<std::byte const> file)
+        -> CompressedImage;
+
+    // Detects the container from its identifier.
+    //
+    // Throws glpp::TextureLoadError
+    [[nodiscard]] auto parse_compressed_image(std::span<std::byte const> file)
+        -> CompressedImage;
+
+    // Uploads every level of the image; the max level
+    // of the texture is set to the last level present.
+    void load_compressed_image(Texture& texture, CompressedImage const& image) noexcept;
+
+    // Memory-maps a KTX2 or DDS file and uploads every
+    // mip level directly, without decoding on the CPU.
+    //
+    // Throws glpp::TextureLoadError, std::filesystem::filesystem_error
+    [[nodiscard]] auto load_compressed_texture(
+        std::filesystem::path const& path,
+        Texture::Filter filter = {},
+        Texture::WrapBehaviour wrap_behaviour = {})
+        -> Texture;
+}  // namespace glpp
@@ -0,0 +1,133 @@
+#include "glpp/mapped_file.hpp"
+
+#include <system_error>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    [[noreturn]] void throw_filesystem_error(
+        std::filesystem::path const& path,
+        int const error)
+    {
+        throw std::filesystem::filesystem_error{
+            "Failed to map file",
+            path,
+            std::error_code{error, std::system_category()},
+        };
+    }
+}  // namespace
+
+namespace glpp
+{
+#ifdef _WIN32
+    MappedFile::MappedFile(std::filesystem::path const& path)
+    {
+        auto const file = CreateFileW(
+            path.c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+            nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            throw_filesystem_error(path, static_cast<int>(GetLastError()));
+        }
+
+        auto size = LARGE_INTEGER{};
+        if (!GetFileSizeEx(file, &size))
+        {
+            auto const error = GetLastError();
+            CloseHandle(file);
+            throw_filesystem_error(path, static_cast<int>(error));
+        }
+        size_ = static_cast<std::size_t>(size.QuadPart);
+
+        if (size_ == 0)
+        {
+            CloseHandle(file);
+            return;
+        }
+
+        auto const mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        auto const error = GetLastError();
+        CloseHandle(file);
+        if (mapping == nullptr)
+        {
+            throw_filesystem_error(path, static_cast<int>(error));
+        }
+
+        data_ = static_cast<std::byte const*>(
+            MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        auto const view_error = GetLastError();
+        // The view keeps the mapping alive.
+        CloseHandle(mapping);
+        if (data_ == nullptr)
+        {
+            throw_filesystem_error(path, static_cast<int>(view_error));
+        }
+    }
+
+    MappedFile::~MappedFile() noexcept
+    {
+        if (data_ != nullptr)
+        {
+            UnmapViewOfFile(data_);
+        }
+    }
+#else
+    MappedFile::MappedFile(std::filesystem::path const& path)
+    {
+        auto const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1)
+        {
+            throw_filesystem_error(path, errno);
+        }
+
+        struct stat status = {};
+        if (::fstat(fd, &status) == -1)
+        {
+            auto const error = errno;
+            ::close(fd);
+            throw_filesystem_error(path, error);
+        }
+        size_ = static_cast<std::size_t>(status.st_size);
+
+        if (size_ == 0)
+        {
+            ::close(fd);
+            return;
+        }
+
+        auto const address = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        auto const error = errno;
+        // The mapping stays valid after closing the descriptor.
+        ::close(fd);
+        if (address == MAP_FAILED)
+        {
+            throw_filesystem_error(path, error);
+        }
+
+        data_ = static_cast<std::byte const*>(address);
+    }
+
+    MappedFile::~MappedFile() noexcept
+    {
+        if (data_ != nullptr)
+        {
+            ::munmap(const_cast<std::byte*>(data_), size_);
+        }
+    }
+#endif
+}  // namespace glpp
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace glpp
+{
+    // Read-only memory mapping of a whole file.
+    class MappedFile
+    {
+      public:
+        // Throws std::filesystem::filesystem_error
+        explicit MappedFile(std::filesystem::path const& path);
+
+        MappedFile(MappedFile const&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept { swap(*this, other); }
+
+        ~MappedFile() noexcept;
+
+        auto operator=(MappedFile other) noexcept -> MappedFile&
+        {
+            swap(*this, other);
+            return *this;
+        }
+
+        friend void swap(MappedFile& left, MappedFile& right) noexcept
+        {
+            using std::swap;
+            swap(left.data_, right.data_);
+            swap(left.size_, right.size_);
+        }
+
+        [[nodiscard]] auto data() const noexcept -> std::span<std::byte const>
+        {
+            return {data_, size_};
+        }
+
+      private:
+        std::byte const* data_ = nullptr;
+        std::size_t size_ = 0;
+    };
+}  // namespace glpp
@@ -0,0 +1,466 @@
+#include "glpp/mip_chain.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+
+#include "glpp/error.hpp"
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define GLPP_MIP_CHAIN_SSE
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define GLPP_MIP_CHAIN_NEON
+#endif
+
+namespace
+{
+    using glpp::MipFilter;
+    using glpp::Size;
+    using glpp::UInt8;
+
+    // Texels are processed as four float channels regardless of the format,
+    // so that one texel fits one SIMD register.
+    constexpr auto channels = std::size_t{4};
+    constexpr auto alpha_channel = std::size_t{3};
+
+    struct Image
+    {
+        Size width;
+        Size height;
+        std::vector<float> texels;
+
+        [[nodiscard]] auto row(Size const y) noexcept -> float*
+        {
+            return texels.data() + static_cast<std::size_t>(y) * static_cast<std::size_t>(width) * channels;
+        }
+
+        [[nodiscard]] auto row(Size const y) const noexcept -> float const*
+        {
+            return texels.data() + static_cast<std::size_t>(y) * static_cast<std::size_t>(width) * channels;
+        }
+    };
+
+    // Source texel range and weights of every destination texel along one axis.
+    struct Weights
+    {
+        std::size_t taps;
+        std::vector<std::int32_t> first;
+        std::vector<float> weights;
+    };
+
+    // dst[i] += weight * src[i] for a multiple of 4 floats.
+    inline void add_scaled(
+        float* const dst,
+        float const* const src,
+        float const weight,
+        std::size_t const count) noexcept
+    {
+#if defined(GLPP_MIP_CHAIN_SSE)
+        auto const w = _mm_set1_ps(weight);
+        for (auto i = std::size_t{0}; i < count; i += 4)
+        {
+            _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(w, _mm_loadu_ps(src + i))));
+        }
+#elif defined(GLPP_MIP_CHAIN_NEON)
+        for (auto i = std::size_t{0}; i < count; i += 4)
+        {
+            vst1q_f32(dst + i, vmlaq_n_f32(vld1q_f32(dst + i), vld1q_f32(src + i), weight));
+        }
+#else
+        for (auto i = std::size_t{0}; i < count; ++i)
+        {
+            dst[i] += weight * src[i];
+        }
+#endif
+    }
+
+    [[nodiscard]] auto sinc(float const x) noexcept -> float
+    {
+        if (std::abs(x) < 1e-5f)
+        {
+            return 1.0f;
+        }
+        auto const px = std::numbers::pi_v<float> * x;
+        return std::sin(px) / px;
+    }
+
+    // Zeroth order modified Bessel function of the first kind.
+    [[nodiscard]] auto bessel_i0(float const x) noexcept -> float
+    {
+        auto sum = 1.0f;
+        auto term = 1.0f;
+        for (auto k = 1; k < 32; ++k)
+        {
+            auto const t = x / (2.0f * static_cast<float>(k));
+            term *= t * t;
+            sum += term;
+            if (term < sum * 1e-8f)
+            {
+                break;
+            }
+        }
+        return sum;
+    }
+
+    // In destination texels.
+    [[nodiscard]] auto filter_radius(MipFilter const filter) noexcept -> float
+    {
+        switch (filter)
+        {
+            case MipFilter::box:
+                return 0.5f;
+            case MipFilter::kaiser:
+            case MipFilter::lanczos:
+                return 3.0f;
+        }
+        return 0.5f;
+    }
+
+    [[nodiscard]] auto filter_weight(MipFilter const filter, float const x) noexcept -> float
+    {
+        constexpr auto kaiser_alpha = 4.0f;
+
+        auto const radius = filter_radius(filter);
+        if (std::abs(x) > radius)
+        {
+            return 0.0f;
+        }
+
+        switch (filter)
+        {
+            case MipFilter::box:
+                return 1.0f;
+            case MipFilter::kaiser:
+            {
+                auto const t = x / radius;
+                return sinc(x) * bessel_i0(kaiser_alpha * std::sqrt(1.0f - t * t)) / bessel_i0(kaiser_alpha);
+            }
+            case MipFilter::lanczos:
+                return sinc(x) * sinc(x / radius);
+        }
+        return 0.0f;
+    }
+
+    [[nodiscard]] auto compute_weights(
+        MipFilter const filter,
+        Size const src_size,
+        Size const dst_size)
+        -> Weights
+    {
+        auto const scale = static_cast<float>(src_size) / static_cast<float>(dst_size);
+        auto const src_radius = filter_radius(filter) * scale;
+        auto const taps = static_cast<std::size_t>(std::ceil(src_radius * 2.0f)) + 1;
+
+        auto result = Weights{
+            taps,
+            std::vector<std::int32_t>(static_cast<std::size_t>(dst_size)),
+            std::vector<float>(static_cast<std::size_t>(dst_size) * taps),
+        };
+
+        for (auto i = Size{0}; i < dst_size; ++i)
+        {
+            auto const center = (static_cast<float>(i) + 0.5f) * scale;
+            auto const begin = static_cast<Size>(std::ceil(center - src_radius - 0.5f));
+            auto const end = static_cast<Size>(std::floor(center + src_radius - 0.5f));
+
+            // Taps outside the image are clamped to the edge texels;
+            // the range of touched texels is at most taps wide.
+            auto const first = std::clamp(begin, Size{0}, std::max(Size{0}, src_size - static_cast<Size>(taps)));
+            auto* const weights = result.weights.data() + static_cast<std::size_t>(i) * taps;
+            auto sum = 0.0f;
+
+            for (auto j = begin; j <= end; ++j)
+            {
+                auto const weight = filter_weight(filter, (static_cast<float>(j) + 0.5f - center) / scale);
+                auto const texel = std::clamp(j, Size{0}, src_size - 1);
+                weights[texel - first] += weight;
+                sum += weight;
+            }
+            for (auto k = std::size_t{0}; k < taps; ++k)
+            {
+                weights[k] /= sum;
+            }
+
+            result.first[static_cast<std::size_t>(i)] = first;
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] auto downsample(
+        Image const& src,
+        MipFilter const filter,
+        glpp::ThreadPool& pool)
+        -> Image
+    {
+        auto const dst_width = std::max(Size{1}, src.width / 2);
+        auto const dst_height = std::max(Size{1}, src.height / 2);
+        auto const horizontal = compute_weights(filter, src.width, dst_width);
+        auto const vertical = compute_weights(filter, src.height, dst_height);
+
+        // Taps may reach past a 1 texel wide image; those weights are zero.
+        auto const horizontal_taps = std::min(horizontal.taps, static_cast<std::size_t>(src.width));
+        auto const vertical_taps = std::min(vertical.taps, static_cast<std::size_t>(src.height));
+
+        auto columns = Image{
+            dst_width,
+            src.height,
+            std::vector<float>(static_cast<std::size_t>(dst_width) * static_cast<std::size_t>(src.height) * channels),
+        };
+        pool.parallel_for(static_cast<std::size_t>(src.height), [&](std::size_t const begin, std::size_t const end) {
+            for (auto y = begin; y < end; ++y)
+            {
+                auto const* const in = src.row(static_cast<Size>(y));
+                auto* out = columns.row(static_cast<Size>(y));
+                for (auto x = std::size_t{0}; x < static_cast<std::size_t>(dst_width); ++x, out += channels)
+                {
+                    auto const* const texel = in + static_cast<std::size_t>(horizontal.first[x]) * channels;
+                    auto const* const weights = horizontal.weights.data() + x * horizontal.taps;
+                    for (auto k = std::size_t{0}; k < horizontal_taps; ++k)
+                    {
+                        add_scaled(out, texel + k * channels, weights[k], channels);
+                    }
+                }
+            }
+        });
+
+        auto result = Image{
+            dst_width,
+            dst_height,
+            std::vector<float>(static_cast<std::size_t>(dst_width) * static_cast<std::size_t>(dst_height) * channels),
+        };
+        auto const row_floats = static_cast<std::size_t>(dst_width) * channels;
+        pool.parallel_for(static_cast<std::size_t>(dst_height), [&](std::size_t const begin, std::size_t const end) {
+            for (auto y = begin; y < end; ++y)
+            {
+                auto* const out = result.row(static_cast<Size>(y));
+                auto const* const weights = vertical.weights.data() + y * vertical.taps;
+                for (auto k = std::size_t{0}; k < vertical_taps; ++k)
+                {
+                    add_scaled(out, columns.row(vertical.first[y] + static_cast<Size>(k)), weights[k], row_floats);
+                }
+            }
+        });
+
+        return result;
+    }
+
+    [[nodiscard]] auto srgb_to_linear(float const value) noexcept -> float
+    {
+        return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+    }
+
+    [[nodiscard]] auto linear_to_srgb(float const value) noexcept -> float
+    {
+        return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    }
+
+    [[nodiscard]] auto row_stride(Size const width, std::size_t const component_count) noexcept
+        -> std::size_t
+    {
+        // The default unpack alignment.
+        constexpr auto alignment = std::size_t{4};
+
+        auto const row_size = static_cast<std::size_t>(width) * component_count;
+        return (row_size + alignment - 1) / alignment * alignment;
+    }
+
+    // Whether component c of the format is alpha, or a color
+    // channel subject to sRGB decoding.
+    [[nodiscard]] auto is_alpha(std::size_t const component_count, std::size_t const c) noexcept
+        -> bool
+    {
+        return component_count == 4 && c == alpha_channel;
+    }
+
+    [[nodiscard]] auto alpha_coverage(Image const& image, float const threshold) noexcept
+        -> float
+    {
+        auto passed = std::size_t{0};
+        for (auto i = alpha_channel; i < image.texels.size(); i += channels)
+        {
+            passed += image.texels[i] > threshold;
+        }
+        return static_cast<float>(passed) / static_cast<float>(image.texels.size() / channels);
+    }
+
+    // Finds the alpha scale giving the wanted coverage: binary searches
+    // for the range of alpha thresholds that give the coverage
+    // and moves the reference to its middle.
+    [[nodiscard]] auto coverage_alpha_scale(
+        Image const& image,
+        float const reference,
+        float const coverage) noexcept
+        -> float
+    {
+        constexpr auto iterations = 12;
+
+        // Largest threshold giving at least, or more than the coverage.
+        auto const search = [&](bool const inclusive) {
+            auto low = 0.0f;
+            auto high = 1.0f;
+            for (auto i = 0; i < iterations; ++i)
+            {
+                auto const threshold = (low + high) / 2.0f;
+                auto const achieved = alpha_coverage(image, threshold);
+                if (inclusive ? achieved >= coverage : achieved > coverage)
+                {
+                    low = threshold;
+                }
+                else
+                {
+                    high = threshold;
+                }
+            }
+            return low;
+        };
+
+        auto const threshold = (search(true) + search(false)) / 2.0f;
+
+        return threshold > 0.0f ? reference / threshold : 1.0f;
+    }
+
+    [[nodiscard]] auto decode(
+        glpp::Texture::Data const data,
+        bool const srgb,
+        glpp::ThreadPool& pool)
+        -> Image
+    {
+        auto const component_count = static_cast<std::size_t>(glpp::Texture::component_count(data.format));
+        auto const stride = data.row_stride(component_count);
+        auto const* const pixels = static_cast<UInt8 const*>(data.data.get()) + data.pixel_offset(component_count);
+
+        auto to_float = std::array<float, 256>{};
+        auto to_linear = std::array<float, 256>{};
+        for (auto i = std::size_t{0}; i < to_float.size(); ++i)
+        {
+            to_float[i] = static_cast<float>(i) / 255.0f;
+            to_linear[i] = srgb ? srgb_to_linear(to_float[i]) : to_float[i];
+        }
+
+        auto image = Image{
+            data.width,
+            data.height,
+            std::vector<float>(static_cast<std::size_t>(data.width) * static_cast<std::size_t>(data.height) * channels),
+        };
+        pool.parallel_for(static_cast<std::size_t>(data.height), [&](std::size_t const begin, std::size_t const end) {
+            for (auto y = begin; y < end; ++y)
+            {
+                auto const* in = pixels + y * stride;
+                auto* out = image.row(static_cast<Size>(y));
+                for (auto x = Size{0}; x < data.width; ++x, in += component_count, out += channels)
+                {
+                    for (auto c = std::size_t{0}; c < component_count; ++c)
+                    {
+                        out[c] = is_alpha(component_count, c) ? to_float[in[c]] : to_linear[in[c]];
+                    }
+                }
+            }
+        });
+
+        return image;
+    }
+
+    [[nodiscard]] auto encode(
+        Image const& image,
+        glpp::Texture::BasicFormat const format,
+        bool const srgb,
+        float const alpha_scale,
+        glpp::ThreadPool& pool)
+        -> glpp::MipLevel
+    {
+        auto const component_count = static_cast<std::size_t>(glpp::Texture::component_count(format));
+        auto const stride = row_stride(image.width, component_count);
+
+        auto level = glpp::MipLevel{
+            image.width,
+            image.height,
+            format,
+            std::vector<UInt8>(stride * static_cast<std::size_t>(image.height)),
+        };
+        pool.parallel_for(static_cast<std::size_t>(image.height), [&](std::size_t const begin, std::size_t const end) {
+            for (auto y = begin; y < end; ++y)
+            {
+                auto const* in = image.row(static_cast<Size>(y));
+                auto* out = level.pixels.data() + y * stride;
+                for (auto x = Size{0}; x < image.width; ++x, in += channels, out += component_count)
+                {
+                    for (auto c = std::size_t{0}; c < component_count; ++c)
+                    {
+                        auto value = std::clamp(in[c], 0.0f, 1.0f);
+                        if (is_alpha(component_count, c))
+                        {
+                            value = std::min(value * alpha_scale, 1.0f);
+                        }
+                        else if (srgb)
+                        {
+                            value = linear_to_srgb(value);
+                        }
+                        out[c] = static_cast<UInt8>(std::lround(value * 255.0f));
+                    }
+                }
+            }
+        });
+
+        return level;
+    }
+}  // namespace
+
+namespace glpp
+{
+    auto generate_mip_chain(
+        Texture::Data const base,
+        ThreadPool& pool,
+        MipChainOptions const options)
+        -> std::vector<MipLevel>
+    {
+        if (base.data.enumerator() != GL_UNSIGNED_BYTE
+            || !base.data
+            || base.format == Texture::BasicFormat::depth_component
+            || base.format == Texture::BasicFormat::depth_stencil)
+        {
+            throw Error{"Mip chain generation requires 8 bit color data"};
+        }
+        if (base.width <= 0 || base.height <= 0)
+        {
+            throw Error{"Mip chain generation requires a non-empty image"};
+        }
+
+        auto image = decode(base, options.srgb, pool);
+
+        auto const preserve_coverage = options.alpha_coverage_reference.has_value()
+                                       && Texture::component_count(base.format) == 4;
+        auto const reference = options.alpha_coverage_reference.value_or(0.0f);
+        auto const coverage = preserve_coverage ? alpha_coverage(image, reference) : 0.0f;
+
+        auto levels = std::vector<MipLevel>{};
+        while (image.width > 1 || image.height > 1)
+        {
+            image = downsample(image, options.filter, pool);
+
+            auto const alpha_scale = preserve_coverage
+                                         ? coverage_alpha_scale(image, reference, coverage)
+                                         : 1.0f;
+            levels.push_back(encode(image, base.format, options.srgb, alpha_scale, pool));
+        }
+
+        return levels;
+    }
+
+    void load_mip_chain(
+        Texture& texture,
+        std::span<MipLevel const> const levels,
+        Texture::InternalFormat const internal_format)
+    {
+        auto level = Int32{0};
+        for (auto const& mip : levels)
+        {
+            texture.load(mip.data(), internal_format, ++level);
+        }
+        texture.set_max_level(level);
+    }
+}  // namespace glpp
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "glpp/primitive_types.hpp"
+#include "glpp/texture.hpp"
+#include "glpp/thread_pool.hpp"
+
+namespace glpp
+{
+    enum class MipFilter : std::uint8_t
+    {
+        // Averages the texels covered by the destination texel.
+        box,
+        // Kaiser windowed sinc with a radius of 3 texels;
+        // sharp with little ringing.
+        kaiser,
+        // Lanczos 3; sharpest, with some ringing around hard edges.
+        lanczos,
+    };
+
+    struct MipChainOptions
+    {
+        MipFilter filter = MipFilter::kaiser;
+        // Color channels are sRGB encoded (e.g. for srgb8_alpha8 textures);
+        // they are filtered in linear space. Alpha is always linear.
+        bool srgb = false;
+        // Scales the alpha of every level so that the fraction of texels
+        // passing an alpha test against this reference value stays the same
+        // as in the base level; keeps alpha-tested foliage from thinning out.
+        std::optional<float> alpha_coverage_reference;
+    };
+
+    struct MipLevel
+    {
+        Size width;
+        Size height;
+        Texture::BasicFormat format;
+        std::vector<UInt8> pixels;
+
+        [[nodiscard]] auto data() const noexcept -> Texture::Data
+        {
+            return {width, height, format, pixels.data()};
+        }
+    };
+
+    // Computes levels 1 up to 1 by 1 of the mip chain of an 8 bit image,
+    // splitting rows across the pool. Each level is filtered from the
+    // unquantized previous level. The input is read as described by
+    // base.unpack; output rows are padded to the default unpack alignment
+    // of 4 bytes.
+    //
+    // Throws glpp::Error
+    [[nodiscard]] auto generate_mip_chain(
+        Texture::Data base,
+        ThreadPool& pool,
+        MipChainOptions options = {})
+        -> std::vector<MipLevel>;
+
+    // Uploads the levels as levels 1, 2, ... of the texture
+    // (level 0 is expected to be loaded already) and limits
+    // the texture's max level to the chain.
+    void load_mip_chain(
+        Texture& texture,
+        std::span<MipLevel const> levels,
+        Texture::InternalFormat internal_format);
+}  // namespace glpp
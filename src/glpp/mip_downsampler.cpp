@@ -0,0 +1,458 @@
+#include "glpp/mip_downsampler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+#include <fmt/format.h>
+#include "glpp/error.hpp"
+#include "glpp/scoped_bind.hpp"
+#include "glpp/shader.hpp"
+#include "glpp/uniform.hpp"
+
+namespace
+{
+    using glpp::Enum;
+    using glpp::Int32;
+
+    constexpr auto max_levels_per_pass = Int32{12};
+    // Levels produced from one workgroup tile.
+    constexpr auto tile_levels = Int32{6};
+    constexpr auto tile_size = Int32{64};
+    // Above this size, level 6 no longer fits the tile
+    // processed by the last workgroup.
+    constexpr auto max_single_pass_size = tile_size << tile_levels;
+
+    constexpr auto base_level_location = glpp::UniformLocation{0};
+    constexpr auto level_count_location = glpp::UniformLocation{1};
+
+    [[nodiscard]] auto image_format_qualifier(Enum const internal_format) noexcept
+        -> std::optional<std::string_view>
+    {
+        switch (internal_format)
+        {
+            case GL_R8: return "r8";
+            case GL_R8_SNORM: return "r8_snorm";
+            case GL_R16: return "r16";
+            case GL_R16_SNORM: return "r16_snorm";
+            case GL_RG8: return "rg8";
+            case GL_RG8_SNORM: return "rg8_snorm";
+            case GL_RG16: return "rg16";
+            case GL_RG16_SNORM: return "rg16_snorm";
+            case GL_RGBA8: return "rgba8";
+            case GL_RGBA8_SNORM: return "rgba8_snorm";
+            case GL_RGB10_A2: return "rgb10_a2";
+            case GL_RGBA16: return "rgba16";
+            case GL_R16F: return "r16f";
+            case GL_RG16F: return "rg16f";
+            case GL_RGBA16F: return "rgba16f";
+            case GL_R32F: return "r32f";
+            case GL_RG32F: return "rg32f";
+            case GL_RGBA32F: return "rgba32f";
+            case GL_R11F_G11F_B10F: return "r11f_g11f_b10f";
+            default: return std::nullopt;
+        }
+    }
+
+    [[nodiscard]] auto reduction_name(glpp::MipReduction const reduction) noexcept
+        -> std::string_view
+    {
+        switch (reduction)
+        {
+            case glpp::MipReduction::average: return "REDUCE_AVERAGE";
+            case glpp::MipReduction::min: return "REDUCE_MIN";
+            case glpp::MipReduction::max: return "REDUCE_MAX";
+        }
+        return "REDUCE_AVERAGE";
+    }
+
+    // Levels are relative to the base level; level n is written
+    // through image unit n - 1. Level 6 is read back by the last
+    // workgroup and has to be coherent.
+    constexpr auto shader_body = std::string_view{R"glsl(
+layout(local_size_x = 256) in;
+
+layout(binding = 0) uniform sampler2D source;
+layout(location = 0) uniform int base_level;
+layout(location = 1) uniform int level_count;
+
+layout(std430, binding = 0) coherent buffer Counter
+{
+    uint finished_groups;
+};
+
+shared vec4 tile[32][32];
+shared bool is_last_group;
+
+ivec2 source_size;
+
+vec4 reduce(vec4 a, vec4 b, vec4 c, vec4 d)
+{
+#if defined(REDUCE_MIN)
+    return min(min(a, b), min(c, d));
+#elif defined(REDUCE_MAX)
+    return max(max(a, b), max(c, d));
+#else
+    return (a + b + c + d) * 0.25;
+#endif
+}
+
+ivec2 level_size(int level)
+{
+    return max(source_size >> level, ivec2(1));
+}
+
+void store(int level, ivec2 p, vec4 value)
+{
+    if (level > level_count || any(greaterThanEqual(p, level_size(level))))
+    {
+        return;
+    }
+    STORE_CASES
+}
+
+vec4 load(ivec2 p, bool from_level_6)
+{
+#if IMAGE_COUNT > 6
+    if (from_level_6)
+    {
+        return imageLoad(mip5, min(p, level_size(6) - 1));
+    }
+#endif
+    return texelFetch(source, min(p, source_size - 1), base_level);
+}
+
+// Reduces the 2 by 2 texels above texel s / 2 of the next level.
+// For min and max, the last texel of an odd row or column is added
+// to the texel before it, so that no texel is left out.
+vec4 load_footprint(ivec2 s, bool from_level_6)
+{
+    vec4 value = reduce(
+        load(s, from_level_6),
+        load(s + ivec2(1, 0), from_level_6),
+        load(s + ivec2(0, 1), from_level_6),
+        load(s + ivec2(1, 1), from_level_6));
+#if defined(REDUCE_MIN) || defined(REDUCE_MAX)
+    ivec2 size = from_level_6 ? level_size(6) : source_size;
+    bvec2 is_wide = equal(s + 2, size - 1);
+    if (is_wide.x)
+    {
+        value = reduce(value, value, load(s + ivec2(2, 0), from_level_6), load(s + ivec2(2, 1), from_level_6));
+    }
+    if (is_wide.y)
+    {
+        value = reduce(value, value, load(s + ivec2(0, 2), from_level_6), load(s + ivec2(1, 2), from_level_6));
+    }
+    if (all(is_wide))
+    {
+        value = reduce(value, value, value, load(s + ivec2(2, 2), from_level_6));
+    }
+#endif
+    return value;
+}
+
+// Reads a texel of the level stored in the tile, clamped to the edge
+// of the level like the loads from the source.
+vec4 tile_texel(ivec2 p, ivec2 tile_origin, int level)
+{
+    ivec2 clamped = min(tile_origin + p, level_size(level) - 1) - tile_origin;
+    clamped = clamp(clamped, ivec2(0), ivec2(31));
+    return tile[clamped.y][clamped.x];
+}
+
+// Reduces a 64 by 64 tile of level first - 1 to levels first ... first + 5.
+void downsample_tile(ivec2 tile_id, int first, bool from_level_6)
+{
+    uint index = gl_LocalInvocationIndex;
+
+    for (uint i = 0; i < 4; ++i)
+    {
+        uint texel = index + i * 256;
+        ivec2 p = ivec2(texel % 32, texel / 32);
+        vec4 value = load_footprint(tile_id * 64 + p * 2, from_level_6);
+
+        tile[p.y][p.x] = value;
+        store(first, tile_id * 32 + p, value);
+    }
+    memoryBarrierShared();
+    barrier();
+
+    for (int level = 1; level < 6; ++level)
+    {
+        int size = 32 >> level;
+        bool is_active = index < uint(size * size);
+        ivec2 p = ivec2(index % uint(size), index / uint(size));
+        vec4 value;
+
+        if (is_active)
+        {
+            ivec2 s = p * 2;
+            ivec2 origin = tile_id * size * 2;
+            int previous = first + level - 1;
+            value = reduce(
+                tile_texel(s, origin, previous),
+                tile_texel(s + ivec2(1, 0), origin, previous),
+                tile_texel(s + ivec2(0, 1), origin, previous),
+                tile_texel(s + ivec2(1, 1), origin, previous));
+        }
+        memoryBarrierShared();
+        barrier();
+
+        if (is_active)
+        {
+            tile[p.y][p.x] = value;
+            store(first + level, tile_id * size + p, value);
+        }
+        memoryBarrierShared();
+        barrier();
+    }
+}
+
+void main()
+{
+    source_size = textureSize(source, base_level);
+
+    downsample_tile(ivec2(gl_WorkGroupID.xy), 1, false);
+
+#if IMAGE_COUNT > 6
+    if (level_count <= 6)
+    {
+        return;
+    }
+
+    if (gl_LocalInvocationIndex == 0)
+    {
+        // Publish this group's level 6 texel before counting it.
+        memoryBarrierImage();
+        uint group_count = gl_NumWorkGroups.x * gl_NumWorkGroups.y;
+        is_last_group = atomicAdd(finished_groups, 1) == group_count - 1;
+    }
+    memoryBarrierShared();
+    barrier();
+
+    if (!is_last_group)
+    {
+        return;
+    }
+
+    if (gl_LocalInvocationIndex == 0)
+    {
+        // Ready for the next dispatch.
+        finished_groups = 0;
+    }
+    memoryBarrierImage();
+
+    downsample_tile(ivec2(0), 7, true);
+#endif
+}
+)glsl"};
+
+    [[nodiscard]] auto shader_source(
+        std::string_view const format,
+        glpp::MipReduction const reduction,
+        Int32 const image_count)
+        -> std::string
+    {
+        auto source = fmt::format(
+            "#version 430 core\n"
+            "#define {0}\n"
+            "#define IMAGE_COUNT {1}\n",
+            reduction_name(reduction),
+            image_count);
+
+        auto store_cases = std::string{"switch (level)\n    {\n"};
+        for (auto image = Int32{0}; image < image_count; ++image)
+        {
+            // Only level 6 is ever read back.
+            source += fmt::format(
+                "layout({0}, binding = {1}) uniform {2} image2D mip{1};\n",
+                format,
+                image,
+                image == tile_levels - 1 ? "coherent" : "writeonly");
+            store_cases += fmt::format(
+                "        case {0}: imageStore(mip{1}, p, value); break;\n",
+                image + 1,
+                image);
+        }
+        store_cases += "    }\n";
+
+        auto body = std::string{shader_body};
+        constexpr auto placeholder = std::string_view{"STORE_CASES"};
+        body.replace(body.find(placeholder), placeholder.size(), store_cases);
+
+        return source + body;
+    }
+
+    [[nodiscard]] auto level_count(glpp::Size const width, glpp::Size const height) noexcept
+        -> Int32
+    {
+        auto levels = Int32{1};
+        for (auto size = std::max(width, height); size > 1; size /= 2)
+        {
+            ++levels;
+        }
+        return levels;
+    }
+
+    // The number of levels of a pass starting at the base level that
+    // can be written before a level reduced in shared memory would read
+    // an odd sized level; only levels read from the texture get the wider
+    // footprint at odd edges, as the texels past the tile belong to
+    // another workgroup.
+    [[nodiscard]] auto even_levels(
+        glpp::Texture const& texture,
+        Int32 const base_level,
+        Int32 const pass_levels) noexcept
+        -> Int32
+    {
+        // Levels 1 and 7 of a pass read levels 0 and 6 from the texture.
+        for (auto level = Int32{1}; level < pass_levels; ++level)
+        {
+            auto const width = std::max(glpp::Size{1}, texture.width() >> (base_level + level));
+            auto const height = std::max(glpp::Size{1}, texture.height() >> (base_level + level));
+            auto const is_odd = (width > 1 && width % 2 != 0) || (height > 1 && height % 2 != 0);
+            if (level != tile_levels && is_odd)
+            {
+                return level;
+            }
+        }
+
+        return pass_levels;
+    }
+}  // namespace
+
+namespace glpp
+{
+    MipDownsampler::MipDownsampler()
+    {
+        auto image_uniforms = Int32{};
+        auto image_units = Int32{};
+        glGetIntegerv(GL_MAX_COMPUTE_IMAGE_UNIFORMS, &image_uniforms);
+        glGetIntegerv(GL_MAX_IMAGE_UNITS, &image_units);
+
+        levels_per_pass_ = std::min({max_levels_per_pass, image_uniforms, image_units});
+        if (levels_per_pass_ < 1)
+        {
+            throw Error{"Compute shader image units are not supported"};
+        }
+
+        auto const zero = UInt32{0};
+        counter_.buffer_data({&zero, 1});
+    }
+
+    void MipDownsampler::downsample(Texture& texture, MipReduction const reduction)
+    {
+        auto internal_format = Int32{};
+        glGetTextureLevelParameteriv(texture.id(), 0, GL_TEXTURE_INTERNAL_FORMAT, &internal_format);
+
+        auto const format = static_cast<Enum>(internal_format);
+        auto const& downsample_program = program(format, reduction);
+        auto const levels = level_count(texture.width(), texture.height());
+
+        for (auto level = Int32{1}; level < levels; ++level)
+        {
+            auto width = Int32{};
+            glGetTextureLevelParameteriv(texture.id(), level, GL_TEXTURE_WIDTH, &width);
+            if (width == 0)
+            {
+                texture.load(
+                    Texture::Data{
+                        std::max(Size{1}, texture.width() >> level),
+                        std::max(Size{1}, texture.height() >> level),
+                        Texture::BasicFormat::rgba,
+                        static_cast<UInt8 const*>(nullptr),
+                    },
+                    static_cast<Texture::SizedInternalFormat>(format),
+                    level);
+                texture.set_max_level(levels - 1);
+            }
+        }
+
+        auto const program_binding = ScopedBind{downsample_program};
+        auto const texture_binding = ScopedBind{texture};
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, counter_.id());
+
+        for (auto base_level = Int32{0}; base_level < levels - 1;)
+        {
+            auto const base_width = std::max(Size{1}, texture.width() >> base_level);
+            auto const base_height = std::max(Size{1}, texture.height() >> base_level);
+            auto pass_levels = std::min({
+                levels - 1 - base_level,
+                levels_per_pass_,
+                std::max(base_width, base_height) > max_single_pass_size ? tile_levels : max_levels_per_pass,
+            });
+
+            if (reduction != MipReduction::average)
+            {
+                pass_levels = std::min(pass_levels, even_levels(texture, base_level, pass_levels));
+            }
+
+            for (auto image = Int32{0}; image < pass_levels; ++image)
+            {
+                glBindImageTexture(
+                    static_cast<UInt32>(image),
+                    texture.id(),
+                    base_level + 1 + image,
+                    GL_FALSE,
+                    0,
+                    image == tile_levels - 1 ? GL_READ_WRITE : GL_WRITE_ONLY,
+                    format);
+            }
+
+            Uniform<Int32>{base_level_location}.load(base_level);
+            Uniform<Int32>{level_count_location}.load(pass_levels);
+            glDispatchCompute(
+                static_cast<UInt32>((base_width + tile_size - 1) / tile_size),
+                static_cast<UInt32>((base_height + tile_size - 1) / tile_size),
+                1);
+            glMemoryBarrier(
+                GL_TEXTURE_FETCH_BARRIER_BIT
+                | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT
+                | GL_SHADER_STORAGE_BARRIER_BIT
+                | GL_FRAMEBUFFER_BARRIER_BIT
+                | GL_TEXTURE_UPDATE_BARRIER_BIT
+                | GL_PIXEL_BUFFER_BARRIER_BIT);
+
+            base_level += pass_levels;
+        }
+
+        for (auto image = Int32{0}; image < levels_per_pass_; ++image)
+        {
+            glBindImageTexture(static_cast<UInt32>(image), nullid, 0, GL_FALSE, 0, GL_READ_ONLY, GL_R8);
+        }
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, nullid);
+    }
+
+    auto MipDownsampler::program(Enum const internal_format, MipReduction const reduction)
+        -> ShaderProgram const&
+    {
+        auto const key = std::pair{internal_format, reduction};
+        if (auto const it = programs_.find(key); it != programs_.end())
+        {
+            return it->second;
+        }
+
+        auto const format = image_format_qualifier(internal_format);
+        if (!format)
+        {
+            throw Error{fmt::format(
+                "Texture format {0:#x} can not be used for compute mip generation",
+                internal_format)};
+        }
+
+        auto const shader = Shader{
+            ShaderType::compute_shader,
+            shader_source(*format, reduction, levels_per_pass_),
+        };
+
+        return programs_
+            .emplace(
+                std::piecewise_construct,
+                std::forward_as_tuple(key),
+                std::forward_as_tuple(std::span{&shader, 1}))
+            .first->second;
+    }
+}  // namespace glpp
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <utility>
+
+#include <glad/glad.h>
+#include "glpp/buffer.hpp"
+#include "glpp/primitive_types.hpp"
+#include "glpp/shader_program.hpp"
+#include "glpp/texture.hpp"
+
+namespace glpp
+{
+    enum class MipReduction : std::uint8_t
+    {
+        average,
+        min,
+        max,
+    };
+
+    // Generates mip chains of 2D textures with a compute shader,
+    // writing up to 12 levels in a single dispatch: every workgroup reduces
+    // a 64 by 64 tile to levels 1 - 6 in shared memory, and the last
+    // workgroup to finish (found through a global atomic counter)
+    // reduces level 6 to levels 7 - 12.
+    // Intended for render targets that need a fresh chain every frame
+    // (bloom, hierarchical Z); min and max reductions are conservative
+    // for the latter.
+    //
+    // Missing mip levels are allocated on first use. Levels are written
+    // through image units, so the texture must have an image compatible,
+    // non-integer color format (no sRGB, compressed or depth formats -
+    // copy depth into r32f for hierarchical Z). Every texel reduces the
+    // 2 by 2 texels above it. At odd level sizes, averages drop the last
+    // row / column, as in glGenerateMipmap, while min and max reduce
+    // 3 texels on the odd axis of the last row / column (dispatches
+    // then stop at levels with odd sizes, so they write fewer levels).
+    // Once one side of a non-square texture is 1 texel, its edge texel
+    // is read twice.
+    // The number of levels per dispatch is also limited by the number
+    // of image units available to compute shaders.
+    class MipDownsampler
+    {
+      public:
+        // Throws glpp::Error
+        MipDownsampler();
+
+        // Throws glpp::Error if the texture format is not supported,
+        // glpp::ShaderCompilationError
+        void downsample(Texture& texture, MipReduction reduction = MipReduction::average);
+
+        // Levels written by a single dispatch.
+        [[nodiscard]] auto levels_per_pass() const noexcept -> Int32 { return levels_per_pass_; }
+
+      private:
+        Int32 levels_per_pass_;
+        StaticBuffer<UInt32, BufferType::shader_storage_buffer> counter_;
+        std::map<std::pair<Enum, MipReduction>, ShaderProgram> programs_;
+
+        [[nodiscard]] auto program(Enum internal_format, MipReduction reduction)
+            -> ShaderProgram const&;
+    };
+}  // namespace glpp
@@ -0,0 +1,737 @@
+#include "glpp/pixel_conversion.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+// x86 kernels are compiled for their instruction set with target
+// attributes and picked at runtime, so that a baseline build still
+// uses AVX2 / AVX-512 where available. NEON is part of the AArch64 baseline.
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define GLPP_PIXEL_CONVERSION_X86
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define GLPP_PIXEL_CONVERSION_NEON
+#endif
+
+namespace
+{
+    using glpp::Float32;
+    using glpp::SimdLevel;
+    using glpp::UInt16;
+    using glpp::UInt8;
+
+    // Every kernel converts count pixels (or channels).
+    struct Kernels
+    {
+        SimdLevel level;
+        void (*rgb_to_rgba)(UInt8 const* src, UInt8* dst, std::size_t count, UInt8 alpha) noexcept;
+        void (*swap_red_blue)(UInt8 const* src, UInt8* dst, std::size_t count) noexcept;
+        void (*premultiply_alpha)(UInt8 const* src, UInt8* dst, std::size_t count) noexcept;
+        void (*unorm16_to_unorm8)(UInt16 const* src, UInt8* dst, std::size_t count) noexcept;
+        void (*float_to_half)(Float32 const* src, UInt16* dst, std::size_t count) noexcept;
+    };
+
+    // Reference implementations, also used for the tails of the SIMD kernels.
+    // The SIMD kernels produce bit identical results.
+    namespace scalar
+    {
+        // round(c * a / 255) without a division.
+        [[nodiscard]] constexpr auto multiply_unorm8(unsigned const c, unsigned const a) noexcept
+            -> UInt8
+        {
+            auto const t = c * a + 128;
+            return static_cast<UInt8>((t + (t >> 8)) >> 8);
+        }
+
+        // round(v / 257) without a division; the saturation
+        // mirrors the 16 bit SIMD lanes and does not change the result.
+        [[nodiscard]] constexpr auto round_unorm16_to_unorm8(unsigned const v) noexcept
+            -> UInt8
+        {
+            auto const x = std::min(v + 128, 0xFFFFu);
+            return static_cast<UInt8>((x - (x >> 8)) >> 8);
+        }
+
+        [[nodiscard]] auto to_half(Float32 const value) noexcept -> UInt16
+        {
+            auto const bits = std::bit_cast<std::uint32_t>(value);
+            auto const sign = (bits >> 16) & 0x8000u;
+            auto const magnitude = bits & 0x7FFFFFFFu;
+
+            if (magnitude >= 0x7F800000u)
+            {
+                // Infinity stays infinity, NaNs stay quiet NaNs.
+                auto const nan = magnitude > 0x7F800000u ? 0x0200u | ((magnitude >> 13) & 0x03FFu) : 0u;
+                return static_cast<UInt16>(sign | 0x7C00u | nan);
+            }
+            if (magnitude >= 0x477FF000u)
+            {
+                // Rounds to above the largest half, 65504.
+                return static_cast<UInt16>(sign | 0x7C00u);
+            }
+            if (magnitude < 0x38800000u)
+            {
+                // Subnormal half; adding 0.5 moves the value to where the
+                // float's unit in the last place is the half's, letting the
+                // FPU round to nearest even.
+                auto const shifted = std::bit_cast<Float32>(magnitude) + 0.5f;
+                return static_cast<UInt16>(sign | (std::bit_cast<std::uint32_t>(shifted) - 0x3F000000u));
+            }
+
+            // Rebias the exponent from 127 to 15 and round the mantissa
+            // to nearest even; a carry correctly bumps the exponent.
+            auto const odd = (magnitude >> 13) & 1u;
+            auto const rounded = magnitude + 0xC8000FFFu + odd;
+            return static_cast<UInt16>(sign | (rounded >> 13));
+        }
+
+        void rgb_to_rgba(
+            UInt8 const* const src,
+            UInt8* const dst,
+            std::size_t const count,
+            UInt8 const alpha) noexcept
+        {
+            for (auto i = std::size_t{0}; i < count; ++i)
+            {
+                dst[i * 4 + 0] = src[i * 3 + 0];
+                dst[i * 4 + 1] = src[i * 3 + 1];
+                dst[i * 4 + 2] = src[i * 3 + 2];
+                dst[i * 4 + 3] = alpha;
+            }
+        }
+
+        void swap_red_blue(UInt8 const* const src, UInt8* const dst, std::size_t const count) noexcept
+        {
+            for (auto i = std::size_t{0}; i < count * 4; i += 4)
+            {
+                auto const red = src[i];
+                auto const blue = src[i + 2];
+                dst[i] = blue;
+                dst[i + 1] = src[i + 1];
+                dst[i + 2] = red;
+                dst[i + 3] = src[i + 3];
+            }
+        }
+
+        void premultiply_alpha(UInt8 const* const src, UInt8* const dst, std::size_t const count) noexcept
+        {
+            for (auto i = std::size_t{0}; i < count * 4; i += 4)
+            {
+                auto const alpha = src[i + 3];
+                dst[i] = multiply_unorm8(src[i], alpha);
+                dst[i + 1] = multiply_unorm8(src[i + 1], alpha);
+                dst[i + 2] = multiply_unorm8(src[i + 2], alpha);
+                dst[i + 3] = alpha;
+            }
+        }
+
+        void unorm16_to_unorm8(UInt16 const* const src, UInt8* const dst, std::size_t const count) noexcept
+        {
+            for (auto i = std::size_t{0}; i < count; ++i)
+            {
+                dst[i] = round_unorm16_to_unorm8(src[i]);
+            }
+        }
+
+        void float_to_half(Float32 const* const src, UInt16* const dst, std::size_t const count) noexcept
+        {
+            for (auto i = std::size_t{0}; i < count; ++i)
+            {
+                dst[i] = to_half(src[i]);
+            }
+        }
+
+        constexpr auto kernels = Kernels{
+            SimdLevel::scalar,
+            rgb_to_rgba,
+            swap_red_blue,
+            premultiply_alpha,
+            unorm16_to_unorm8,
+            float_to_half,
+        };
+    }  // namespace scalar
+
+#if defined(GLPP_PIXEL_CONVERSION_X86)
+#define GLPP_TARGET(isa) __attribute__((target(isa)))
+
+    namespace sse4_1
+    {
+        GLPP_TARGET("sse4.1")
+        void rgb_to_rgba(
+            UInt8 const* const src,
+            UInt8* const dst,
+            std::size_t const count,
+            UInt8 const alpha) noexcept
+        {
+            auto const shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+            auto const alpha_bits = _mm_set1_epi32(static_cast<int>(std::uint32_t{alpha} << 24));
+
+            // 16 byte loads for 12 bytes of pixels; stop before reading past the end.
+            auto i = std::size_t{0};
+            for (; i + 6 <= count; i += 4)
+            {
+                auto const pixels = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i * 3));
+                _mm_storeu_si128(
+                    reinterpret_cast<__m128i*>(dst + i * 4),
+                    _mm_or_si128(_mm_shuffle_epi8(pixels, shuffle), alpha_bits));
+            }
+            scalar::rgb_to_rgba(src + i * 3, dst + i * 4, count - i, alpha);
+        }
+
+        GLPP_TARGET("sse4.1")
+        void swap_red_blue(UInt8 const* const src, UInt8* const dst, std::size_t const count) noexcept
+        {
+            auto const shuffle = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+            auto i = std::size_t{0};
+            for (; i + 4 <= count; i += 4)
+            {
+                auto const pixels = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i * 4));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_shuffle_epi8(pixels, shuffle));
+            }
+            scalar::swap_red_blue(src + i * 4, dst + i * 4, count - i);
+        }
+
+        // Two pixels in 16 bit lanes; see scalar::multiply_unorm8.
+        GLPP_TARGET("sse4.1")
+        inline auto premultiply(__m128i const pixels) noexcept -> __m128i
+        {
+            auto const alpha_shuffle = _mm_setr_epi8(6, 7, 6, 7, 6, 7, -1, -1, 14, 15, 14, 15, 14, 15, -1, -1);
+            auto const alpha_one = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+
+            auto const alpha = _mm_or_si128(_mm_shuffle_epi8(pixels, alpha_shuffle), alpha_one);
+            auto const t = _mm_add_epi16(_mm_mullo_epi16(pixels, alpha), _mm_set1_epi16(128));
+            return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+        }
+
+        GLPP_TARGET("sse4.1")
+        void premultiply_alpha(UInt8 const* const src, UInt8* const dst, std::size_t const count) noexcept
+        {
+            auto i = std::size_t{0};
+            for (; i + 4 <= count; i += 4)
+            {
+                auto const pixels = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i * 4));
+                auto const low = premultiply(_mm_cvtepu8_epi16(pixels));
+                auto const high = premultiply(_mm_unpackhi_epi8(pixels, _mm_setzero_si128()));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_packus_epi16(low, high));
+            }
+            scalar::premultiply_alpha(src + i * 4, dst + i * 4, count - i);
+        }
+
+        // See scalar::round_unorm16_to_unorm8.
+        GLPP_TARGET("sse4.1")
+        inline auto round_unorm16_to_unorm8(__m128i const values) noexcept -> __m128i
+        {
+            auto const x = _mm_adds_epu16(values, _mm_set1_epi16(128));
+            return _mm_srli_epi16(_mm_sub_epi16(x, _mm_srli_epi16(x, 8)), 8);
+        }
+
+        GLPP_TARGET("sse4.1")
+        void unorm16_to_unorm8(UInt16 const* const src, UInt8* const dst, std::size_t const count) noexcept
+        {
+            auto i = std::size_t{0};
+            for (; i + 16 <= count; i += 16)
+            {
+                auto const low = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+                auto const high = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i + 8));
+                _mm_storeu_si128(
+                    reinterpret_cast<__m128i*>(dst + i),
+                    _mm_packus_epi16(round_unorm16_to_unorm8(low), round_unorm16_to_unorm8(high)));
+            }
+            scalar::unorm16_to_unorm8(src + i, dst + i, count - i);
+        }
+
+        // Half conversion needs F16C, which comes with AVX2.
+        constexpr auto kernels = Kernels{
+            SimdLevel::sse4_1,
+            rgb_to_rgba,
+            swap_red_blue,
+            premultiply_alpha,
+            unorm16_to_unorm8,
+            scalar::float_to_half,
+        };
+    }  // namespace sse4_1
+
+    // Only selected on CPUs that also support F16C.
+    namespace avx2
+    {
+        GLPP_TARGET("avx2")
+        void rgb_to_rgba(
+            UInt8 const* const src,
+            UInt8* const dst,
+            std::size_t const count,
+            UInt8 const alpha) noexcept
+        {
+            auto const shuffle = _mm256_setr_epi8(
+                0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+                0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+            auto const alpha_bits = _mm256_set1_epi32(static_cast<int>(std::uint32_t{alpha} << 24));
+
+            // Two 16 byte loads 12 bytes apart; the second reads 4 bytes
+            // past the 8 pixels.
+            auto i = std::size_t{0};
+            for (; i + 10 <= count; i += 8)
+            {
+                auto const* const pixels = src + i * 3;
+                auto const both = _mm256_inserti128_si256(
+                    _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const*>(pixels))),
+                    _mm_loadu_si128(reinterpret_cast<__m128i const*>(pixels + 12)),
+                    1);
+                _mm256_storeu_si256(
+                    reinterpret_cast<__m256i*>(dst + i * 4),
+                    _mm256_or_si256(_mm256_shuffle_epi8(both, shuffle), alpha_bits));
+            }
+            sse4_1::rgb_to_rgba(src + i * 3, dst + i * 4, count - i, alpha);
+        }
+
+        GLPP_TARGET("avx2")
+        void swap_red_blue(UInt8 const* const src, UInt8* const dst, std::size_t const count) noexcept
+        {
+            auto const shuffle = _mm256_setr_epi8(
+                2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+            auto i = std::size_t{0};
+            for (; i + 8 <= count; i += 8)
+            {
+                auto const pixels = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + i * 4));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_shuffle_epi8(pixels, shuffle));
+            }
+            sse4_1::swap_red_blue(src + i * 4, dst + i * 4, count - i);
+        }
+
+        GLPP_TARGET("avx2")
+        inline auto premultiply(__m256i const pixels) noexcept -> __m256i
+        {
+            auto const alpha_shuffle = _mm256_setr_epi8(
+                6, 7, 6, 7, 6, 7, -1, -1, 14, 15, 14, 15, 14, 15, -1, -1,
+                6, 7, 6, 7, 6, 7, -1, -1, 14, 15, 14, 15, 14, 15, -1, -1);
+            auto const alpha_one = _mm256_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255);
+
+            auto const alpha = _mm256_or_si256(_mm256_shuffle_epi8(pixels, alpha_shuffle), alpha_one);
+            auto const t = _mm256_add_epi16(_mm256_mullo_epi16(pixels, alpha), _mm256_set1_epi16(128));
+            return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+        }
+
+        GLPP_TARGET("avx2")
+        void premultiply_alpha(UInt8 const* const src, UInt8* const dst, std::size_t const count) noexcept
+        {
+            auto i = std::size_t{0};
+            for (; i + 8 <= count; i += 8)
+            {
+                auto const* const pixels = reinterpret_cast<__m128i const*>(src + i * 4);
+                auto const low = premultiply(_mm256_cvtepu8_epi16(_mm_loadu_si128(pixels)));
+                auto const high = premultiply(_mm256_cvtepu8_epi16(_mm_loadu_si128(pixels + 1)));
+                // The pack interleaves the 128 bit lanes of both halves.
+                _mm256_storeu_si256(
+                    reinterpret_cast<__m256i*>(dst + i * 4),
+                    _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), 0b11'01'10'00));
+            }
+            sse4_1::premultiply_alpha(src + i * 4, dst + i * 4, count - i);
+        }
+
+        GLPP_TARGET("avx2")
+        inline auto round_unorm16_to_unorm8(__m256i const values) noexcept -> __m256i
+        {
+            auto const x = _mm256_adds_epu16(values, _mm256_set1_epi16(128));
+            return _mm256_srli_epi16(_mm256_sub_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+        }
+
+        GLPP_TARGET("avx2")
+        void unorm16_to_unorm8(UInt16 const* const src, UInt8* const dst, std::size_t const count) noexcept
+        {
+            auto i = std::size_t{0};
+            for (; i + 32 <= count; i += 32)
+            {
+                auto const low = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + i));
+                auto const high = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + i + 16));
+                auto const packed = _mm256_packus_epi16(round_unorm16_to_unorm8(low), round_unorm16_to_unorm8(high));
+                _mm256_storeu_si256(
+                    reinterpret_cast<__m256i*>(dst + i),
+                    _mm256_permute4x64_epi64(packed, 0b11'01'10'00));
+            }
+            sse4_1::unorm16_to_unorm8(src + i, dst + i, count - i);
+        }
+
+        GLPP_TARGET("avx2,f16c")
+        void float_to_half(Float32 const* const src, UInt16* const dst, std::size_t const count) noexcept
+        {
+            auto i = std::size_t{0};
+            for (; i + 8 <= count; i += 8)
+            {
+                _mm_storeu_si128(
+                    reinterpret_cast<__m128i*>(dst + i),
+                    _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+            }
+            scalar::float_to_half(src + i, dst + i, count - i);
+        }
+
+        constexpr auto kernels = Kernels{
+            SimdLevel::avx2,
+            rgb_to_rgba,
+            swap_red_blue,
+            premultiply_alpha,
+            unorm16_to_unorm8,
+            float_to_half,
+        };
+    }  // namespace avx2
+
+// GCC's AVX-512 intrinsic headers build their masked operations on an
+// intentionally undefined vector, which it reports once inlined here.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+    namespace avx512
+    {
+        GLPP_TARGET("avx512f,avx512bw")
+        void rgb_to_rgba(
+            UInt8 const* const src,
+            UInt8* const dst,
+            std::size_t const count,
+            UInt8 const alpha) noexcept
+        {
+            auto const shuffle = _mm512_broadcast_i32x4(
+                _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1));
+            auto const alpha_bits = _mm512_set1_epi32(static_cast<int>(std::uint32_t{alpha} << 24));
+
+            // Four 16 byte loads 12 bytes apart; the last reads 4 bytes
+            // past the 16 pixels.
+            auto i = std::size_t{0};
+            for (; i + 18 <= count; i += 16)
+            {
+                auto const* const pixels = src + i * 3;
+                auto all = _mm512_castsi128_si512(_mm_loadu_si128(reinterpret_cast<__m128i const*>(pixels)));
+                all = _mm512_inserti32x4(all, _mm_loadu_si128(reinterpret_cast<__m128i const*>(pixels + 12)), 1);
+                all = _mm512_inserti32x4(all, _mm_loadu_si128(reinterpret_cast<__m128i const*>(pixels + 24)), 2);
+                all = _mm512_inserti32x4(all, _mm_loadu_si128(reinterpret_cast<__m128i const*>(pixels + 36)), 3);
+                _mm512_storeu_si512(dst + i * 4, _mm512_or_si512(_mm512_shuffle_epi8(all, shuffle), alpha_bits));
+            }
+            avx2::rgb_to_rgba(src + i * 3, dst + i * 4, count - i, alpha);
+        }
+
+        GLPP_TARGET("avx512f,avx512bw")
+        void swap_red_blue(UInt8 const* const src, UInt8* const dst, std::size_t const count) noexcept
+        {
+            auto const shuffle = _mm512_broadcast_i32x4(
+                _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15));
+
+            auto i = std::size_t{0};
+            for (; i + 16 <= count; i += 16)
+            {
+                _mm512_storeu_si512(
+                    dst + i * 4,
+                    _mm512_shuffle_epi8(_mm512_loadu_si512(src + i * 4), shuffle));
+            }
+            avx2::swap_red_blue(src + i * 4, dst + i * 4, count - i);
+        }
+
+        GLPP_TARGET("avx512f,avx512bw")
+        inline auto premultiply(__m512i const pixels) noexcept -> __m512i
+        {
+            auto const alpha_shuffle = _mm512_broadcast_i32x4(
+                _mm_setr_epi8(6, 7, 6, 7, 6, 7, -1, -1, 14, 15, 14, 15, 14, 15, -1, -1));
+            auto const alpha_one = _mm512_broadcast_i32x4(_mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255));
+
+            auto const alpha = _mm512_or_si512(_mm512_shuffle_epi8(pixels, alpha_shuffle), alpha_one);
+            auto const t = _mm512_add_epi16(_mm512_mullo_epi16(pixels, alpha), _mm512_set1_epi16(128));
+            return _mm512_srli_epi16(_mm512_add_epi16(t, _mm512_srli_epi16(t, 8)), 8);
+        }
+
+        GLPP_TARGET("avx512f,avx512bw")
+        void premultiply_alpha(UInt8 const* const src, UInt8* const dst, std::size_t const count) noexcept
+        {
+            auto i = std::size_t{0};
+            for (; i + 16 <= count; i += 16)
+            {
+                auto const* const pixels = reinterpret_cast<__m256i const*>(src + i * 4);
+                auto const low = premultiply(_mm512_cvtepu8_epi16(_mm256_loadu_si256(pixels)));
+                auto const high = premultiply(_mm512_cvtepu8_epi16(_mm256_loadu_si256(pixels + 1)));
+                _mm512_storeu_si512(
+                    dst + i * 4,
+                    _mm512_inserti64x4(_mm512_castsi256_si512(_mm512_cvtepi16_epi8(low)), _mm512_cvtepi16_epi8(high), 1));
+            }
+            avx2::premultiply_alpha(src + i * 4, dst + i * 4, count - i);
+        }
+
+        GLPP_TARGET("avx512f,avx512bw")
+        void unorm16_to_unorm8(UInt16 const* const src, UInt8* const dst, std::size_t const count) noexcept
+        {
+            auto i = std::size_t{0};
+            for (; i + 32 <= count; i += 32)
+            {
+                auto const values = _mm512_loadu_si512(src + i);
+                auto const x = _mm512_adds_epu16(values, _mm512_set1_epi16(128));
+                auto const rounded = _mm512_srli_epi16(_mm512_sub_epi16(x, _mm512_srli_epi16(x, 8)), 8);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm512_cvtepi16_epi8(rounded));
+            }
+            avx2::unorm16_to_unorm8(src + i, dst + i, count - i);
+        }
+
+        GLPP_TARGET("avx512f,avx512bw")
+        void float_to_half(Float32 const* const src, UInt16* const dst, std::size_t const count) noexcept
+        {
+            auto i = std::size_t{0};
+            for (; i + 16 <= count; i += 16)
+            {
+                _mm256_storeu_si256(
+                    reinterpret_cast<__m256i*>(dst + i),
+                    _mm512_cvtps_ph(_mm512_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+            }
+            avx2::float_to_half(src + i, dst + i, count - i);
+        }
+
+        constexpr auto kernels = Kernels{
+            SimdLevel::avx512,
+            rgb_to_rgba,
+            swap_red_blue,
+            premultiply_alpha,
+            unorm16_to_unorm8,
+            float_to_half,
+        };
+    }  // namespace avx512
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#undef GLPP_TARGET
+#elif defined(GLPP_PIXEL_CONVERSION_NEON)
+    namespace neon
+    {
+        void rgb_to_rgba(
+            UInt8 const* const src,
+            UInt8* const dst,
+            std::size_t const count,
+            UInt8 const alpha) noexcept
+        {
+            auto i = std::size_t{0};
+            for (; i + 16 <= count; i += 16)
+            {
+                auto const rgb = vld3q_u8(src + i * 3);
+                auto const rgba = uint8x16x4_t{{rgb.val[0], rgb.val[1], rgb.val[2], vdupq_n_u8(alpha)}};
+                vst4q_u8(dst + i * 4, rgba);
+            }
+            scalar::rgb_to_rgba(src + i * 3, dst + i * 4, count - i, alpha);
+        }
+
+        void swap_red_blue(UInt8 const* const src, UInt8* const dst, std::size_t const count) noexcept
+        {
+            auto i = std::size_t{0};
+            for (; i + 16 <= count; i += 16)
+            {
+                auto const rgba = vld4q_u8(src + i * 4);
+                auto const bgra = uint8x16x4_t{{rgba.val[2], rgba.val[1], rgba.val[0], rgba.val[3]}};
+                vst4q_u8(dst + i * 4, bgra);
+            }
+            scalar::swap_red_blue(src + i * 4, dst + i * 4, count - i);
+        }
+
+        // See scalar::multiply_unorm8.
+        inline auto multiply_unorm8(uint8x16_t const c, uint8x16_t const a) noexcept -> uint8x16_t
+        {
+            auto const low = vmull_u8(vget_low_u8(c), vget_low_u8(a));
+            auto const high = vmull_u8(vget_high_u8(c), vget_high_u8(a));
+            return vcombine_u8(
+                vrshrn_n_u16(vrsraq_n_u16(low, low, 8), 8),
+                vrshrn_n_u16(vrsraq_n_u16(high, high, 8), 8));
+        }
+
+        void premultiply_alpha(UInt8 const* const src, UInt8* const dst, std::size_t const count) noexcept
+        {
+            auto i = std::size_t{0};
+            for (; i + 16 <= count; i += 16)
+            {
+                auto pixels = vld4q_u8(src + i * 4);
+                pixels.val[0] = multiply_unorm8(pixels.val[0], pixels.val[3]);
+                pixels.val[1] = multiply_unorm8(pixels.val[1], pixels.val[3]);
+                pixels.val[2] = multiply_unorm8(pixels.val[2], pixels.val[3]);
+                vst4q_u8(dst + i * 4, pixels);
+            }
+            scalar::premultiply_alpha(src + i * 4, dst + i * 4, count - i);
+        }
+
+        // See scalar::round_unorm16_to_unorm8.
+        inline auto round_unorm16_to_unorm8(uint16x8_t const values) noexcept -> uint8x8_t
+        {
+            auto const x = vqaddq_u16(values, vdupq_n_u16(128));
+            return vshrn_n_u16(vsubq_u16(x, vshrq_n_u16(x, 8)), 8);
+        }
+
+        void unorm16_to_unorm8(UInt16 const* const src, UInt8* const dst, std::size_t const count) noexcept
+        {
+            auto i = std::size_t{0};
+            for (; i + 16 <= count; i += 16)
+            {
+                vst1q_u8(
+                    dst + i,
+                    vcombine_u8(
+                        round_unorm16_to_unorm8(vld1q_u16(src + i)),
+                        round_unorm16_to_unorm8(vld1q_u16(src + i + 8))));
+            }
+            scalar::unorm16_to_unorm8(src + i, dst + i, count - i);
+        }
+
+        void float_to_half(Float32 const* const src, UInt16* const dst, std::size_t const count) noexcept
+        {
+            auto i = std::size_t{0};
+            for (; i + 4 <= count; i += 4)
+            {
+                vst1_u16(dst + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src + i))));
+            }
+            scalar::float_to_half(src + i, dst + i, count - i);
+        }
+
+        constexpr auto kernels = Kernels{
+            SimdLevel::neon,
+            rgb_to_rgba,
+            swap_red_blue,
+            premultiply_alpha,
+            unorm16_to_unorm8,
+            float_to_half,
+        };
+    }  // namespace neon
+#endif
+
+    [[nodiscard]] auto detect_simd_level() noexcept -> SimdLevel
+    {
+#if defined(GLPP_PIXEL_CONVERSION_X86)
+        __builtin_cpu_init();
+        // The AVX2 and AVX-512 half conversions use F16C, which
+        // is a separate CPUID bit, even though every known AVX2 CPU has it.
+        auto const has_f16c = __builtin_cpu_supports("f16c") != 0;
+        if (has_f16c && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+        {
+            return SimdLevel::avx512;
+        }
+        if (has_f16c && __builtin_cpu_supports("avx2"))
+        {
+            return SimdLevel::avx2;
+        }
+        if (__builtin_cpu_supports("sse4.1"))
+        {
+            return SimdLevel::sse4_1;
+        }
+        return SimdLevel::scalar;
+#elif defined(GLPP_PIXEL_CONVERSION_NEON)
+        return SimdLevel::neon;
+#else
+        return SimdLevel::scalar;
+#endif
+    }
+
+    [[nodiscard]] auto detected_simd_level() noexcept -> SimdLevel
+    {
+        static auto const level = detect_simd_level();
+        return level;
+    }
+
+    [[nodiscard]] auto is_supported(SimdLevel const level) noexcept -> bool
+    {
+        auto const detected = detected_simd_level();
+        switch (level)
+        {
+            case SimdLevel::scalar:
+                return true;
+            case SimdLevel::neon:
+                return detected == SimdLevel::neon;
+            default:
+                return detected != SimdLevel::neon && level <= detected;
+        }
+    }
+
+    [[nodiscard]] auto kernels_for(SimdLevel const level) noexcept -> Kernels const&
+    {
+        switch (level)
+        {
+#if defined(GLPP_PIXEL_CONVERSION_X86)
+            case SimdLevel::sse4_1:
+                return sse4_1::kernels;
+            case SimdLevel::avx2:
+                return avx2::kernels;
+            case SimdLevel::avx512:
+                return avx512::kernels;
+#elif defined(GLPP_PIXEL_CONVERSION_NEON)
+            case SimdLevel::neon:
+                return neon::kernels;
+#endif
+            default:
+                return scalar::kernels;
+        }
+    }
+
+    auto active_kernels = std::atomic<Kernels const*>{nullptr};
+
+    [[nodiscard]] auto kernels() noexcept -> Kernels const&
+    {
+        auto const* active = active_kernels.load(std::memory_order_acquire);
+        if (active == nullptr)
+        {
+            active = &kernels_for(detected_simd_level());
+            active_kernels.store(active, std::memory_order_release);
+        }
+        return *active;
+    }
+}  // namespace
+
+namespace glpp
+{
+    auto simd_level() noexcept -> SimdLevel
+    {
+        return kernels().level;
+    }
+
+    auto set_simd_level(SimdLevel level) noexcept -> SimdLevel
+    {
+        while (!is_supported(level))
+        {
+            level = static_cast<SimdLevel>(static_cast<std::uint8_t>(level) - 1);
+        }
+
+        active_kernels.store(&kernels_for(level), std::memory_order_release);
+        return level;
+    }
+
+    void rgb_to_rgba(std::span<UInt8 const> const src, std::span<UInt8> const dst, UInt8 const alpha) noexcept
+    {
+        auto const count = src.size() / 3;
+        assert(dst.size() >= count * 4);
+
+        kernels().rgb_to_rgba(src.data(), dst.data(), count, alpha);
+    }
+
+    void swap_red_blue(std::span<UInt8 const> const src, std::span<UInt8> const dst) noexcept
+    {
+        auto const count = src.size() / 4;
+        assert(dst.size() >= count * 4);
+
+        kernels().swap_red_blue(src.data(), dst.data(), count);
+    }
+
+    void premultiply_alpha(std::span<UInt8 const> const src, std::span<UInt8> const dst) noexcept
+    {
+        auto const count = src.size() / 4;
+        assert(dst.size() >= count * 4);
+
+        kernels().premultiply_alpha(src.data(), dst.data(), count);
+    }
+
+    void unorm16_to_unorm8(std::span<UInt16 const> const src, std::span<UInt8> const dst) noexcept
+    {
+        assert(dst.size() >= src.size());
+
+        kernels().unorm16_to_unorm8(src.data(), dst.data(), src.size());
+    }
+
+    void float_to_half(std::span<Float32 const> const src, std::span<UInt16> const dst) noexcept
+    {
+        assert(dst.size() >= src.size());
+
+        kernels().float_to_half(src.data(), dst.data(), src.size());
+    }
+}  // namespace glpp
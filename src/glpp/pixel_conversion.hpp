@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "glpp/primitive_types.hpp"
+
+namespace glpp
+{
+    // Instruction sets of the pixel conversion kernels,
+    // in the order they are preferred within an architecture.
+    enum class SimdLevel : std::uint8_t
+    {
+        scalar,
+        sse4_1,
+        avx2,
+        avx512,
+        neon,
+    };
+
+    // The level the kernels currently run with; on first use,
+    // the best one supported by the CPU is detected.
+    [[nodiscard]] auto simd_level() noexcept -> SimdLevel;
+
+    // Restricts the kernels to a level, e.g. scalar to compare results
+    // or timings against; levels the CPU does not support fall back
+    // to the best supported one below them. Returns the level in effect.
+    // Not meant to be called while conversions run on other threads.
+    auto set_simd_level(SimdLevel level) noexcept -> SimdLevel;
+
+    // The kernels below convert src.size() / components pixels;
+    // dst has to be big enough. Source and destination must either
+    // be the same memory (where noted) or not overlap at all.
+
+    // Tightly packed RGB (or BGR) to RGBA (or BGRA) with a constant alpha.
+    void rgb_to_rgba(std::span<UInt8 const> src, std::span<UInt8> dst, UInt8 alpha = 255) noexcept;
+
+    // RGBA to BGRA and back. May work in place.
+    void swap_red_blue(std::span<UInt8 const> src, std::span<UInt8> dst) noexcept;
+
+    // Multiplies the color channels of RGBA (or BGRA) pixels by alpha,
+    // rounding to nearest. May work in place.
+    void premultiply_alpha(std::span<UInt8 const> src, std::span<UInt8> dst) noexcept;
+
+    // Rounds 16 bit normalized values to 8 bits, per channel.
+    void unorm16_to_unorm8(std::span<UInt16 const> src, std::span<UInt8> dst) noexcept;
+
+    // IEEE half floats for GL_HALF_FLOAT uploads, per channel;
+    // rounds to nearest even, out of range values become infinity.
+    void float_to_half(std::span<Float32 const> src, std::span<UInt16> dst) noexcept;
+}  // namespace glpp
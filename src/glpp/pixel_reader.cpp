@@ -0,0 +1 @@
+#include "glpp/pixel_reader.hpp"
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <optional>
+#include <vector>
+
+#include <glad/glad.h>
+#include "glpp/buffer.hpp"
+#include "glpp/framebuffer.hpp"
+#include "glpp/primitive_types.hpp"
+#include "glpp/scoped_bind.hpp"
+#include "glpp/sync.hpp"
+#include "glpp/texture.hpp"
+#include "glpp/traits.hpp"
+
+namespace glpp
+{
+    struct PixelRect
+    {
+        Int32 x;
+        Int32 y;
+        Size width;
+        Size height;
+    };
+
+    // Reads pixels back into client memory without stalling the pipeline.
+    // Each read is copied into one of a ring of persistently mapped pixel pack
+    // buffers; the returned future is resolved by poll() once the copy has
+    // completed on the GPU. If every buffer is in use, the oldest read is
+    // waited for and resolved first.
+    //
+    // Must only be used on the GL thread; calling get() on a future before
+    // poll() has resolved it blocks forever. Resolved pixel rows are
+    // tightly packed, bottom row first.
+    template <typename T>
+    class PixelReader
+    {
+      public:
+        explicit PixelReader(std::size_t const ring_size = 3)
+          : slots_(ring_size)
+        {
+            assert(ring_size > 0);
+        }
+
+        PixelReader(PixelReader const&) = delete;
+        PixelReader(PixelReader&&) = delete;
+
+        auto operator=(PixelReader const&) = delete;
+        auto operator=(PixelReader&&) = delete;
+
+        // Reads from the framebuffer's first color attachment.
+        [[nodiscard]] auto read_pixels_async(
+            Framebuffer const& framebuffer,
+            PixelRect const rect,
+            Texture::BasicFormat const format)
+            -> std::future<std::vector<T>>
+        {
+            auto& slot = begin_read(rect, format);
+
+            auto previous_binding = Int32{};
+            glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previous_binding);
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer.id());
+
+            {
+                auto const binding = ScopedBind{*slot.buffer};
+                auto const pack = PackAlignment{};
+                glReadPixels(
+                    rect.x,
+                    rect.y,
+                    rect.width,
+                    rect.height,
+                    static_cast<Enum>(format),
+                    primitive_type_enumerator_v<T>,
+                    nullptr);
+            }
+
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, static_cast<Id>(previous_binding));
+
+            return end_read(slot);
+        }
+
+        // For layered textures, reads a single layer (or cube map face).
+        [[nodiscard]] auto read_pixels_async(
+            TextureBase const& texture,
+            PixelRect const rect,
+            Texture::BasicFormat const format,
+            Int32 const level = 0,
+            Int32 const layer = 0)
+            -> std::future<std::vector<T>>
+        {
+            auto& slot = begin_read(rect, format);
+
+            {
+                auto const binding = ScopedBind{*slot.buffer};
+                auto const pack = PackAlignment{};
+                glGetTextureSubImage(
+                    texture.id(),
+                    level,
+                    rect.x,
+                    rect.y,
+                    layer,
+                    rect.width,
+                    rect.height,
+                    1,
+                    static_cast<Enum>(format),
+                    primitive_type_enumerator_v<T>,
+                    static_cast<Size>(slot.count * sizeof(T)),
+                    nullptr);
+            }
+
+            return end_read(slot);
+        }
+
+        // Resolves the futures of all reads that have completed.
+        // Returns the number of reads still pending.
+        auto poll() -> std::size_t
+        {
+            auto pending = std::size_t{0};
+            for (auto& slot : slots_)
+            {
+                if (slot.fence && slot.fence->is_signaled())
+                {
+                    resolve(slot);
+                }
+                else if (slot.fence)
+                {
+                    ++pending;
+                }
+            }
+            return pending;
+        }
+
+        // Blocks until all pending reads are resolved.
+        void finish()
+        {
+            while (auto const slot = oldest_pending())
+            {
+                resolve(*slot);
+            }
+        }
+
+      private:
+        struct Slot
+        {
+            std::optional<PersistentBuffer<T, BufferType::pixel_pack_buffer>> buffer;
+            std::optional<Fence> fence;
+            std::promise<std::vector<T>> promise;
+            std::size_t count = 0;
+            std::size_t sequence = 0;
+        };
+
+        // Reads are always tightly packed;
+        // restores the previous alignment afterwards.
+        struct PackAlignment
+        {
+            Int32 previous_alignment = 1;
+
+            PackAlignment() noexcept
+            {
+                glGetIntegerv(GL_PACK_ALIGNMENT, &previous_alignment);
+                if (previous_alignment != 1)
+                {
+                    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+                }
+            }
+
+            PackAlignment(PackAlignment const&) = delete;
+
+            ~PackAlignment() noexcept
+            {
+                if (previous_alignment != 1)
+                {
+                    glPixelStorei(GL_PACK_ALIGNMENT, previous_alignment);
+                }
+            }
+
+            auto operator=(PackAlignment const&) = delete;
+        };
+
+        std::vector<Slot> slots_;
+        std::size_t next_sequence_ = 0;
+
+        [[nodiscard]] auto oldest_pending() -> Slot*
+        {
+            auto oldest = static_cast<Slot*>(nullptr);
+            for (auto& slot : slots_)
+            {
+                if (slot.fence && (!oldest || slot.sequence < oldest->sequence))
+                {
+                    oldest = &slot;
+                }
+            }
+            return oldest;
+        }
+
+        [[nodiscard]] auto begin_read(PixelRect const rect, Texture::BasicFormat const format)
+            -> Slot&
+        {
+            auto const free_slot = std::find_if(
+                slots_.begin(),
+                slots_.end(),
+                [](Slot const& slot) { return !slot.fence.has_value(); });
+            auto& slot = free_slot != slots_.end() ? *free_slot : *oldest_pending();
+
+            if (slot.fence)
+            {
+                resolve(slot);
+            }
+
+            slot.count = static_cast<std::size_t>(rect.width)
+                         * static_cast<std::size_t>(rect.height)
+                         * static_cast<std::size_t>(Texture::component_count(format));
+
+            if (!slot.buffer || static_cast<std::size_t>(slot.buffer->size()) < slot.count)
+            {
+                slot.buffer.reset();
+                slot.buffer.emplace(static_cast<std::ptrdiff_t>(slot.count), MapAccess::read);
+            }
+
+            return slot;
+        }
+
+        [[nodiscard]] auto end_read(Slot& slot) -> std::future<std::vector<T>>
+        {
+            slot.fence.emplace();
+            slot.sequence = next_sequence_++;
+            slot.promise = {};
+
+            return slot.promise.get_future();
+        }
+
+        void resolve(Slot& slot)
+        {
+            [[maybe_unused]] auto const signaled
+                = slot.fence->wait(std::chrono::nanoseconds::max());
+            assert(signaled);
+
+            auto const data = slot.buffer->mapping().first(slot.count);
+            slot.promise.set_value(std::vector<T>(data.begin(), data.end()));
+            slot.fence.reset();
+        }
+    };
+}  // namespace glpp
@@ -0,0 +1,267 @@
+#include "glpp/program_cache.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <system_error>
+
+#include <fmt/format.h>
+
+namespace
+{
+    using glpp::ProgramBinary;
+
+    constexpr auto magic = std::array<char, 8>{'G', 'L', 'P', 'P', 'P', 'R', 'O', 'G'};
+    constexpr auto version = std::uint32_t{1};
+    constexpr auto extension = std::string_view{".glprog"};
+    constexpr auto driver_file_name = std::string_view{"driver.txt"};
+
+    // Follows the magic; the binary data follows the header.
+    struct Header
+    {
+        std::uint32_t version;
+        std::uint32_t format;
+        std::uint64_t key;
+        std::uint64_t size;
+        std::uint64_t checksum;
+    };
+
+    // FNV-1a; stable across runs and platforms, unlike std::hash.
+    class Hasher
+    {
+      public:
+        void add(std::span<std::byte const> const bytes) noexcept
+        {
+            for (auto const byte : bytes)
+            {
+                hash_ = (hash_ ^ static_cast<std::uint64_t>(byte)) * 0x100000001b3u;
+            }
+        }
+
+        void add(std::string_view const string) noexcept
+        {
+            add(std::uint64_t{string.size()});
+            add(std::as_bytes(std::span{string}));
+        }
+
+        void add(std::uint64_t const value) noexcept
+        {
+            add(std::as_bytes(std::span{&value, 1}));
+        }
+
+        [[nodiscard]] auto hash() const noexcept -> std::uint64_t { return hash_; }
+
+      private:
+        std::uint64_t hash_ = 0xcbf29ce484222325u;
+    };
+
+    [[nodiscard]] auto checksum(std::span<std::byte const> const data) noexcept -> std::uint64_t
+    {
+        auto hasher = Hasher{};
+        hasher.add(data);
+        return hasher.hash();
+    }
+
+    [[nodiscard]] auto gl_string(glpp::Enum const name) -> std::string_view
+    {
+        auto const* const string = reinterpret_cast<char const*>(glGetString(name));
+        return string != nullptr ? string : "";
+    }
+
+    [[nodiscard]] auto read_file(std::filesystem::path const& path) -> std::optional<std::string>
+    {
+        auto file = std::ifstream{path, std::ios::binary};
+        if (!file)
+        {
+            return std::nullopt;
+        }
+
+        return std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    }
+
+    // Writes through a temporary file, so that concurrent readers
+    // never see a partially written file. Failures are ignored;
+    // the cache is only an optimization.
+    void write_file(
+        std::filesystem::path const& path,
+        std::span<std::span<std::byte const> const> const parts) noexcept
+    {
+        auto temporary = path;
+        temporary += ".tmp";
+
+        try
+        {
+            {
+                auto file = std::ofstream{temporary, std::ios::binary | std::ios::trunc};
+                for (auto const part : parts)
+                {
+                    file.write(
+                        reinterpret_cast<char const*>(part.data()),
+                        static_cast<std::streamsize>(part.size()));
+                }
+                if (!file)
+                {
+                    std::filesystem::remove(temporary);
+                    return;
+                }
+            }
+            std::filesystem::rename(temporary, path);
+        }
+        catch (std::exception const&)
+        {
+            auto error = std::error_code{};
+            std::filesystem::remove(temporary, error);
+        }
+    }
+
+    // Returns the binary of a valid cache file.
+    [[nodiscard]] auto parse(std::string_view const file, std::uint64_t const key)
+        -> std::optional<ProgramBinary>
+    {
+        auto header = Header{};
+        if (file.size() < magic.size() + sizeof(header)
+            || std::memcmp(file.data(), magic.data(), magic.size()) != 0)
+        {
+            return std::nullopt;
+        }
+        std::memcpy(&header, file.data() + magic.size(), sizeof(header));
+
+        auto const data = std::as_bytes(std::span{file}).subspan(magic.size() + sizeof(header));
+        if (header.version != version
+            || header.key != key
+            || header.size != data.size()
+            || header.checksum != checksum(data))
+        {
+            return std::nullopt;
+        }
+
+        return ProgramBinary{
+            static_cast<glpp::Enum>(header.format),
+            std::vector<std::byte>(data.begin(), data.end()),
+        };
+    }
+}  // namespace
+
+namespace glpp
+{
+    ProgramCache::ProgramCache(std::filesystem::path directory)
+      : directory_{std::move(directory)}
+      , driver_{fmt::format(
+            "{0}\n{1}\n{2}\n",
+            gl_string(GL_VENDOR),
+            gl_string(GL_RENDERER),
+            gl_string(GL_VERSION))}
+    {
+        auto format_count = Int32{};
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+        formats_.resize(static_cast<std::size_t>(format_count));
+        glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats_.data());
+
+        std::filesystem::create_directories(directory_);
+
+        // Binaries of another driver would all be refused, and their
+        // keys never requested again; start over.
+        auto const driver_path = directory_ / driver_file_name;
+        if (read_file(driver_path) != driver_)
+        {
+            for (auto const& entry : std::filesystem::directory_iterator{directory_})
+            {
+                if (entry.path().extension() == extension)
+                {
+                    std::filesystem::remove(entry.path());
+                }
+            }
+
+            auto const parts = std::array{std::as_bytes(std::span{driver_})};
+            write_file(driver_path, parts);
+        }
+    }
+
+    auto ProgramCache::load(std::span<ProgramShaderSource const> const shaders) -> ShaderProgram
+    {
+        auto const program_key = key(shaders);
+        auto const program_path = path(program_key);
+
+        if (enabled())
+        {
+            if (auto const file = read_file(program_path))
+            {
+                if (auto const binary = parse(*file, program_key);
+                    binary && std::ranges::count(formats_, static_cast<Int32>(binary->format)) != 0)
+                {
+                    try
+                    {
+                        auto program = ShaderProgram{*binary};
+                        ++stats_.hits;
+                        return program;
+                    }
+                    catch (ShaderCompilationError const&)
+                    {
+                        // Refused by the driver, e.g. after an update
+                        // that kept the version string.
+                    }
+                }
+                ++stats_.rejected;
+            }
+        }
+        ++stats_.misses;
+
+        auto compiled = std::vector<Shader>{};
+        compiled.reserve(shaders.size());
+        for (auto const& shader : shaders)
+        {
+            compiled.emplace_back(shader.type, shader.fragments);
+        }
+        auto program = ShaderProgram{compiled, enabled()};
+
+        if (enabled())
+        {
+            if (auto const binary = program.binary(); !binary.data.empty())
+            {
+                auto const header = Header{
+                    version,
+                    static_cast<std::uint32_t>(binary.format),
+                    program_key,
+                    binary.data.size(),
+                    checksum(binary.data),
+                };
+                auto const parts = std::array<std::span<std::byte const>, 3>{
+                    std::as_bytes(std::span{magic}),
+                    std::as_bytes(std::span{&header, 1}),
+                    std::span<std::byte const>{binary.data},
+                };
+                write_file(program_path, parts);
+            }
+        }
+
+        return program;
+    }
+
+    auto ProgramCache::key(std::span<ProgramShaderSource const> const shaders) const noexcept
+        -> std::uint64_t
+    {
+        auto hasher = Hasher{};
+        hasher.add(driver_);
+        hasher.add(std::uint64_t{shaders.size()});
+        for (auto const& shader : shaders)
+        {
+            hasher.add(std::uint64_t{static_cast<Enum>(shader.type)});
+            hasher.add(std::uint64_t{shader.fragments.size()});
+            for (auto const& fragment : shader.fragments)
+            {
+                hasher.add(fragment);
+            }
+        }
+
+        return hasher.hash();
+    }
+
+    auto ProgramCache::path(std::uint64_t const key) const -> std::filesystem::path
+    {
+        return directory_ / fmt::format("{0:016x}{1}", key, extension);
+    }
+}  // namespace glpp
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "glpp/shader.hpp"
+#include "glpp/shader_program.hpp"
+
+namespace glpp
+{
+    struct ProgramCacheStats
+    {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        // Cache files that were corrupt or refused by the driver;
+        // also counted as misses.
+        std::size_t rejected = 0;
+
+        [[nodiscard]] auto hit_rate() const noexcept -> double
+        {
+            auto const total = hits + misses;
+            return total != 0 ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+        }
+    };
+
+    // Caches linked program binaries on disk, skipping compilation
+    // and linking of programs seen by an earlier run.
+    //
+    // Programs are keyed by a hash of their resolved sources
+    // (including the version and macro definitions in the prelude)
+    // and of the driver vendor, renderer and version. The cache
+    // directory is cleared when the driver changes; files that are
+    // corrupt or refused by the driver are recompiled and replaced.
+    // If the driver supports no binary formats, programs are always
+    // compiled.
+    class ProgramCache
+    {
+      public:
+        // Has to be created with a current context.
+        //
+        // Throws std::filesystem::filesystem_error
+        explicit ProgramCache(std::filesystem::path directory);
+
+        // Throws glpp::Error, glpp::ShaderCompilationError
+        [[nodiscard]] auto load(std::span<ProgramShaderSource const> shaders) -> ShaderProgram;
+
+        [[nodiscard]] auto stats() const noexcept -> ProgramCacheStats const& { return stats_; }
+
+        // False if the driver supports no binary formats.
+        [[nodiscard]] auto enabled() const noexcept -> bool { return !formats_.empty(); }
+
+        [[nodiscard]] auto directory() const noexcept -> std::filesystem::path const&
+        {
+            return directory_;
+        }
+
+      private:
+        std::filesystem::path directory_;
+        std::string driver_;
+        std::vector<Int32> formats_;
+        ProgramCacheStats stats_;
+
+        [[nodiscard]] auto key(std::span<ProgramShaderSource const> shaders) const noexcept
+            -> std::uint64_t;
+
+        [[nodiscard]] auto path(std::uint64_t key) const -> std::filesystem::path;
+    };
+}  // namespace glpp
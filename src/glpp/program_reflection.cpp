@@ -0,0 +1,238 @@
+#include "glpp/program_reflection.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+
+namespace
+{
+    using glpp::Enum;
+    using glpp::Int32;
+    using glpp::ProgramInterface;
+
+    constexpr auto array_suffix = std::string_view{"[0]"};
+
+    [[nodiscard]] auto is_block(ProgramInterface const program_interface) noexcept -> bool
+    {
+        return program_interface == ProgramInterface::uniform_block
+               || program_interface == ProgramInterface::shader_storage_block;
+    }
+
+    [[nodiscard]] auto has_location(ProgramInterface const program_interface) noexcept -> bool
+    {
+        return program_interface == ProgramInterface::uniform
+               || program_interface == ProgramInterface::program_input
+               || program_interface == ProgramInterface::program_output;
+    }
+
+    // Columns of a matrix type, 1 for other types.
+    [[nodiscard]] auto column_count(Enum const type) noexcept -> Int32
+    {
+        switch (type)
+        {
+        case GL_FLOAT_MAT2:
+        case GL_FLOAT_MAT2x3:
+        case GL_FLOAT_MAT2x4:
+        case GL_DOUBLE_MAT2:
+        case GL_DOUBLE_MAT2x3:
+        case GL_DOUBLE_MAT2x4:
+            return 2;
+        case GL_FLOAT_MAT3:
+        case GL_FLOAT_MAT3x2:
+        case GL_FLOAT_MAT3x4:
+        case GL_DOUBLE_MAT3:
+        case GL_DOUBLE_MAT3x2:
+        case GL_DOUBLE_MAT3x4:
+            return 3;
+        case GL_FLOAT_MAT4:
+        case GL_FLOAT_MAT4x2:
+        case GL_FLOAT_MAT4x3:
+        case GL_DOUBLE_MAT4:
+        case GL_DOUBLE_MAT4x2:
+        case GL_DOUBLE_MAT4x3:
+            return 4;
+        default:
+            return 1;
+        }
+    }
+
+    // Whether the type is a dvec3 or dvec4, or a matrix of them.
+    [[nodiscard]] auto has_wide_double_columns(Enum const type) noexcept -> bool
+    {
+        switch (type)
+        {
+        case GL_DOUBLE_VEC3:
+        case GL_DOUBLE_VEC4:
+        case GL_DOUBLE_MAT2x3:
+        case GL_DOUBLE_MAT2x4:
+        case GL_DOUBLE_MAT3:
+        case GL_DOUBLE_MAT3x4:
+        case GL_DOUBLE_MAT4x3:
+        case GL_DOUBLE_MAT4:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // Locations taken by an input or output variable of the type: one
+    // per matrix column, and two per dvec3 or dvec4 column except in
+    // vertex shader inputs.
+    [[nodiscard]] auto location_count(Enum const type, bool const vertex_input) noexcept -> Int32
+    {
+        return column_count(type) * (has_wide_double_columns(type) && !vertex_input ? 2 : 1);
+    }
+
+    [[nodiscard]] auto query(
+        glpp::Id const program,
+        ProgramInterface const program_interface,
+        glpp::UInt32 const index,
+        Enum const property) noexcept
+        -> Int32
+    {
+        auto value = Int32{};
+        glGetProgramResourceiv(
+            program,
+            static_cast<Enum>(program_interface),
+            index,
+            1,
+            &property,
+            1,
+            nullptr,
+            &value);
+
+        return value;
+    }
+}  // namespace
+
+namespace glpp
+{
+    ProgramReflection::ProgramReflection(Id const program)
+    {
+        constexpr auto interfaces = std::array{
+            ProgramInterface::uniform,
+            ProgramInterface::uniform_block,
+            ProgramInterface::program_input,
+            ProgramInterface::program_output,
+            ProgramInterface::shader_storage_block,
+            ProgramInterface::buffer_variable,
+        };
+
+        for (auto const program_interface : interfaces)
+        {
+            auto count = Int32{};
+            glGetProgramInterfaceiv(
+                program,
+                static_cast<Enum>(program_interface),
+                GL_ACTIVE_RESOURCES,
+                &count);
+
+            for (auto index = UInt32{0}; index < static_cast<UInt32>(count); ++index)
+            {
+                auto resource = ProgramResource{program_interface, index, {}};
+
+                auto const name_length = query(program, program_interface, index, GL_NAME_LENGTH);
+                resource.name.resize(static_cast<std::size_t>(std::max(name_length, 1)));
+                auto written = Size{};
+                glGetProgramResourceName(
+                    program,
+                    static_cast<Enum>(program_interface),
+                    index,
+                    static_cast<Size>(resource.name.size()),
+                    &written,
+                    resource.name.data());
+                resource.name.resize(static_cast<std::size_t>(written));
+
+                if (is_block(program_interface))
+                {
+                    resource.binding = query(program, program_interface, index, GL_BUFFER_BINDING);
+                    resource.data_size = query(program, program_interface, index, GL_BUFFER_DATA_SIZE);
+                }
+                else
+                {
+                    resource.type = static_cast<Enum>(
+                        query(program, program_interface, index, GL_TYPE));
+                    resource.array_size = query(program, program_interface, index, GL_ARRAY_SIZE);
+                }
+
+                if (has_location(program_interface))
+                {
+                    resource.location = query(program, program_interface, index, GL_LOCATION);
+                }
+
+                if (program_interface == ProgramInterface::program_input
+                    || program_interface == ProgramInterface::program_output)
+                {
+                    auto const vertex_input
+                        = program_interface == ProgramInterface::program_input
+                          && query(program, program_interface, index, GL_REFERENCED_BY_VERTEX_SHADER) != 0;
+                    resource.location_stride = location_count(resource.type, vertex_input);
+                }
+
+                if (program_interface == ProgramInterface::uniform
+                    || program_interface == ProgramInterface::buffer_variable)
+                {
+                    resource.block_index = query(program, program_interface, index, GL_BLOCK_INDEX);
+                    resource.offset = query(program, program_interface, index, GL_OFFSET);
+                }
+
+                resources_.push_back(std::move(resource));
+            }
+        }
+
+        // Array names are inserted twice; at most half of the slots are used.
+        slots_.resize(std::bit_ceil(std::max<std::size_t>(resources_.size() * 4, 1)));
+        for (auto resource = UInt32{0}; resource < resources_.size(); ++resource)
+        {
+            auto const name = std::string_view{resources_[resource].name};
+            insert(name, resource);
+            if (name.ends_with(array_suffix))
+            {
+                insert(name.substr(0, name.size() - array_suffix.size()), resource);
+            }
+        }
+    }
+
+    auto ProgramReflection::element_location(
+        ProgramInterface const program_interface,
+        std::string_view const name) const noexcept
+        -> std::optional<UInt32>
+    {
+        // Element locations are consecutive.
+        if (!name.ends_with(']'))
+        {
+            return std::nullopt;
+        }
+        auto const open = name.rfind('[');
+        auto const last = name.data() + name.size() - 1;
+        auto element = Int32{};
+        if (open == std::string_view::npos
+            || std::from_chars(name.data() + open + 1, last, element).ptr != last)
+        {
+            return std::nullopt;
+        }
+
+        auto const* const array = find(program_interface, ResourceName{name.substr(0, open)});
+        if (array == nullptr || array->location < 0 || element < 0 || element >= array->array_size)
+        {
+            return std::nullopt;
+        }
+
+        return static_cast<UInt32>(array->location + element * array->location_stride);
+    }
+
+    void ProgramReflection::insert(std::string_view const name, UInt32 const resource)
+    {
+        auto const hash = slot_hash(resources_[resource].program_interface, hash_resource_name(name));
+        auto const mask = slots_.size() - 1;
+        for (auto slot = hash & mask;; slot = (slot + 1) & mask)
+        {
+            if (slots_[slot].resource == empty_slot)
+            {
+                slots_[slot] = Slot{hash, resource, static_cast<UInt32>(name.size())};
+                return;
+            }
+        }
+    }
+}  // namespace glpp
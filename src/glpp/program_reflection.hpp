@@ -0,0 +1,198 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <glad/glad.h>
+#include "glpp/id.hpp"
+#include "glpp/primitive_types.hpp"
+
+namespace glpp
+{
+    // FNV-1a; usable at compile time.
+    [[nodiscard]] constexpr auto hash_resource_name(std::string_view const name) noexcept
+        -> std::uint64_t
+    {
+        auto hash = std::uint64_t{0xcbf29ce484222325u};
+        for (auto const c : name)
+        {
+            hash = (hash ^ static_cast<std::uint8_t>(c)) * 0x100000001b3u;
+        }
+
+        return hash;
+    }
+
+    // A resource name with its hash, computed when the name is
+    // created; constexpr, so the hash of a string literal folds
+    // into a constant.
+    class ResourceName
+    {
+      public:
+        // Also takes string literals and character buffers,
+        // up to the terminating null.
+        constexpr ResourceName(char const* const name) noexcept
+          : ResourceName{std::string_view{name, std::char_traits<char>::length(name)}}
+        {
+        }
+
+        constexpr ResourceName(std::string_view const name) noexcept
+          : name_{name}
+          , hash_{hash_resource_name(name)}
+        {
+        }
+
+        ResourceName(std::string const& name) noexcept
+          : ResourceName{std::string_view{name}}
+        {
+        }
+
+        [[nodiscard]] constexpr auto name() const noexcept -> std::string_view { return name_; }
+
+        [[nodiscard]] constexpr auto hash() const noexcept -> std::uint64_t { return hash_; }
+
+      private:
+        std::string_view name_;
+        std::uint64_t hash_;
+    };
+
+    enum class ProgramInterface : Enum
+    {
+        uniform = GL_UNIFORM,
+        uniform_block = GL_UNIFORM_BLOCK,
+        program_input = GL_PROGRAM_INPUT,
+        program_output = GL_PROGRAM_OUTPUT,
+        shader_storage_block = GL_SHADER_STORAGE_BLOCK,
+        buffer_variable = GL_BUFFER_VARIABLE,
+    };
+
+    struct ProgramResource
+    {
+        ProgramInterface program_interface;
+        // Index within the interface.
+        UInt32 index;
+        // As reported by the driver; arrays end with "[0]".
+        std::string name;
+        // Type of a variable; 0 for blocks.
+        Enum type = 0;
+        Int32 array_size = 1;
+        // -1 for variables without a location, e.g. in blocks.
+        Int32 location = -1;
+        // Locations taken by each array element: 1 for uniforms; by
+        // the GLSL layout rules for inputs and outputs, e.g. 4 for
+        // a mat4.
+        Int32 location_stride = 1;
+        // Index of the block containing a variable, -1 outside blocks.
+        Int32 block_index = -1;
+        // Offset of a variable within its block, -1 outside blocks.
+        Int32 offset = -1;
+        // Binding point and minimum buffer size of a block.
+        Int32 binding = -1;
+        Int32 data_size = 0;
+    };
+
+    // The active resources of a linked program, queried once through
+    // the program interface API, with constant time lookup by name.
+    // Arrays can also be looked up without the "[0]" suffix, and
+    // the locations of array elements by "name[i]", which are
+    // ProgramResource::location_stride apart.
+    class ProgramReflection
+    {
+      public:
+        ProgramReflection() = default;
+
+        // The program has to be linked.
+        explicit ProgramReflection(Id program);
+
+        [[nodiscard]] auto resources() const noexcept -> std::span<ProgramResource const>
+        {
+            return resources_;
+        }
+
+        // Inline, so that the hash of a literal name folds into the probe.
+        [[nodiscard]] auto find(
+            ProgramInterface const program_interface,
+            ResourceName const name) const noexcept
+            -> ProgramResource const*
+        {
+            if (slots_.empty())
+            {
+                return nullptr;
+            }
+
+            auto const hash = slot_hash(program_interface, name.hash());
+            auto const mask = slots_.size() - 1;
+            for (auto slot = hash & mask;; slot = (slot + 1) & mask)
+            {
+                auto const& [stored_hash, resource, name_size] = slots_[slot];
+                if (resource == empty_slot)
+                {
+                    return nullptr;
+                }
+
+                // The size matched, so the slot's name is a prefix
+                // of the resource name at least as long.
+                if (stored_hash == hash
+                    && name_size == name.name().size()
+                    && resources_[resource].program_interface == program_interface
+                    && std::equal(name.name().begin(), name.name().end(), resources_[resource].name.begin()))
+                {
+                    return &resources_[resource];
+                }
+            }
+        }
+
+        [[nodiscard]] auto location(
+            ProgramInterface const program_interface,
+            ResourceName const name) const noexcept
+            -> std::optional<UInt32>
+        {
+            if (auto const* const resource = find(program_interface, name))
+            {
+                if (resource->location < 0)
+                {
+                    return std::nullopt;
+                }
+                return static_cast<UInt32>(resource->location);
+            }
+
+            return element_location(program_interface, name.name());
+        }
+
+      private:
+        static constexpr auto empty_slot = ~UInt32{0};
+
+        struct Slot
+        {
+            std::uint64_t hash = 0;
+            UInt32 resource = empty_slot;
+            // The name may be a prefix of the resource name.
+            UInt32 name_size = 0;
+        };
+
+        std::vector<ProgramResource> resources_;
+        // Open addressing with linear probing; the size is a power of two.
+        std::vector<Slot> slots_;
+
+        [[nodiscard]] static constexpr auto slot_hash(
+            ProgramInterface const program_interface,
+            std::uint64_t const name_hash) noexcept
+            -> std::uint64_t
+        {
+            return name_hash ^ (static_cast<std::uint64_t>(program_interface) * 0x9e3779b97f4a7c15u);
+        }
+
+        // Location of "name[i]", from the location of the array.
+        [[nodiscard]] auto element_location(
+            ProgramInterface program_interface,
+            std::string_view name) const noexcept
+            -> std::optional<UInt32>;
+
+        void insert(std::string_view name, UInt32 resource);
+    };
+}  // namespace glpp
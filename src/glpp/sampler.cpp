@@ -0,0 +1,78 @@
+#include "glpp/sampler.hpp"
+
+#include <functional>
+#include <tuple>
+#include <variant>
+
+namespace
+{
+    [[nodiscard]] auto min_filter_enumerator(glpp::Texture::Filter const filter) noexcept
+        -> glpp::Enum
+    {
+        return std::visit(
+            [](auto const filter_type) {
+                return static_cast<glpp::Enum>(filter_type);
+            },
+            filter.min);
+    }
+}  // namespace
+
+namespace glpp
+{
+    Sampler::Sampler(
+        Texture::Filter const filter,
+        Texture::WrapBehaviour const wrap_behaviour) noexcept
+    {
+        set_filter(filter);
+        set_wrap_behaviour(wrap_behaviour);
+    }
+
+    void Sampler::set_filter(Texture::Filter const filter) noexcept
+    {
+        glSamplerParameteri(id(), GL_TEXTURE_MIN_FILTER, min_filter_enumerator(filter));
+        glSamplerParameteri(id(), GL_TEXTURE_MAG_FILTER, static_cast<Enum>(filter.mag));
+    }
+
+    void Sampler::set_wrap_behaviour(Texture::WrapBehaviour const wrap_behaviour) noexcept
+    {
+        glSamplerParameteri(id(), GL_TEXTURE_WRAP_S, static_cast<Enum>(wrap_behaviour.s));
+        glSamplerParameteri(id(), GL_TEXTURE_WRAP_T, static_cast<Enum>(wrap_behaviour.t));
+        glSamplerParameteri(id(), GL_TEXTURE_WRAP_R, static_cast<Enum>(wrap_behaviour.r));
+    }
+
+    auto SamplerCache::get(
+        Texture::Filter const filter,
+        Texture::WrapBehaviour const wrap_behaviour)
+        -> Sampler const&
+    {
+        auto const key = Key{
+            min_filter_enumerator(filter),
+            static_cast<Enum>(filter.mag),
+            static_cast<Enum>(wrap_behaviour.s),
+            static_cast<Enum>(wrap_behaviour.t),
+            static_cast<Enum>(wrap_behaviour.r),
+        };
+
+        if (auto const it = samplers_.find(key); it != samplers_.end())
+        {
+            return it->second;
+        }
+
+        return samplers_
+            .emplace(
+                std::piecewise_construct,
+                std::forward_as_tuple(key),
+                std::forward_as_tuple(filter, wrap_behaviour))
+            .first->second;
+    }
+
+    auto SamplerCache::KeyHash::operator()(Key const& key) const noexcept -> std::size_t
+    {
+        auto hash = std::size_t{0};
+        for (auto const value : {key.min_filter, key.mag_filter, key.wrap_s, key.wrap_t, key.wrap_r})
+        {
+            hash ^= std::hash<Enum>{}(value) + 0x9E3779B9u + (hash << 6) + (hash >> 2);
+        }
+        return hash;
+    }
+}  // namespace glpp
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+
+#include <glad/glad.h>
+#include "glpp/id.hpp"
+#include "glpp/primitive_types.hpp"
+#include "glpp/texture.hpp"
+#include "glpp/uniform.hpp"
+
+namespace glpp
+{
+    // Sampling state that, while bound to a unit, overrides the filter
+    // and wrap behaviour of whichever texture is bound to the same unit.
+    // This lets a texture be sampled differently on several units
+    // without touching its own parameters.
+    //
+    // Swizzling is texture (view) state in OpenGL and is not affected.
+    // Mipmapped filters still require the texture to have mipmaps.
+    class Sampler
+    {
+      public:
+        Sampler() noexcept
+          : Sampler{Texture::Filter{}, Texture::WrapBehaviour{}}
+        {
+        }
+
+        Sampler(Texture::Filter filter, Texture::WrapBehaviour wrap_behaviour) noexcept;
+
+        void set_filter(Texture::Filter filter) noexcept;
+
+        void set_wrap_behaviour(Texture::WrapBehaviour wrap_behaviour) noexcept;
+
+        void bind(SamplerUnit const sampler_unit = {}) const noexcept
+        {
+            glBindSampler(sampler_unit.index, id());
+        }
+
+        static void unbind(SamplerUnit const sampler_unit = {}) noexcept
+        {
+            glBindSampler(sampler_unit.index, nullid);
+        }
+
+        [[nodiscard]] auto id() const noexcept -> Id { return id_.get(); }
+
+      private:
+        struct Deleter
+        {
+            void operator()(UInt32 size, Id* data) const noexcept
+            {
+                glDeleteSamplers(size, data);
+            }
+        };
+
+        UniqueIdArray<1, Deleter> id_{glGenSamplers};
+    };
+
+    // Shares one sampler object between all users of the same
+    // filter and wrap behaviour combination.
+    class SamplerCache
+    {
+      public:
+        // The returned sampler lives until the cache is cleared or destroyed.
+        [[nodiscard]] auto get(
+            Texture::Filter filter,
+            Texture::WrapBehaviour wrap_behaviour)
+            -> Sampler const&;
+
+        void clear() noexcept { samplers_.clear(); }
+
+        [[nodiscard]] auto size() const noexcept -> std::size_t { return samplers_.size(); }
+
+      private:
+        struct Key
+        {
+            Enum min_filter;
+            Enum mag_filter;
+            Enum wrap_s;
+            Enum wrap_t;
+            Enum wrap_r;
+
+            [[nodiscard]] auto operator==(Key const&) const noexcept -> bool = default;
+        };
+
+        struct KeyHash
+        {
+            [[nodiscard]] auto operator()(Key const& key) const noexcept -> std::size_t;
+        };
+
+        std::unordered_map<Key, Sampler, KeyHash> samplers_;
+    };
+}  // namespace glpp
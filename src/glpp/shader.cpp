@@ -1,22 +1,105 @@
 #include "glpp/shader.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <cstring>
 #include <iterator>
+#include <string_view>
 #include <vector>
 
 #include <gsl/gsl_util>
 
+namespace
+{
+    constexpr auto spirv_magic = std::uint32_t{0x07230203};
+
+    // Starts the comment written by glpp::source_file_legend(),
+    // followed by a "// N: name" line per file.
+    constexpr auto legend_header = std::string_view{"// Source files:\n"};
+    constexpr auto legend_line_prefix = std::string_view{"// "};
+
+    // The file names listed in the source of a shader that failed
+    // to compile, or an empty string without a legend.
+    [[nodiscard]] auto compile_error_legend(glpp::Id const shader) -> std::string
+    {
+        auto source_length = glpp::Int32{};
+        glGetShaderiv(shader, GL_SHADER_SOURCE_LENGTH, &source_length);
+        if (source_length <= 0)
+        {
+            return {};
+        }
+
+        auto source = std::vector<char>(static_cast<std::size_t>(source_length));
+        glGetShaderSource(shader, source_length, nullptr, source.data());
+
+        auto const text = std::string_view{source.data()};
+        auto position = text.find(legend_header);
+        if (position == std::string_view::npos)
+        {
+            return {};
+        }
+        position += legend_header.size();
+
+        auto legend = std::string{"\nSource files:\n  0: <prelude>\n"};
+        while (text.substr(position).starts_with(legend_line_prefix))
+        {
+            auto const begin = position + legend_line_prefix.size();
+            auto const end = std::min(text.find('\n', begin), text.size());
+            legend += "  ";
+            legend += text.substr(begin, end - begin);
+            legend += '\n';
+            position = end + 1;
+        }
+
+        return legend;
+    }
+
+    // SPIR-V booleans are 32 bit.
+    [[nodiscard]] constexpr auto scalar_value(bool const value) noexcept -> glpp::UInt32
+    {
+        return value ? 1 : 0;
+    }
+
+    template <typename T>
+    [[nodiscard]] constexpr auto scalar_value(T const value) noexcept -> T
+    {
+        return value;
+    }
+}  // namespace
+
 namespace glpp
 {
+    auto parallel_shader_compile_supported() noexcept -> bool
+    {
+        return GLAD_GL_KHR_parallel_shader_compile || GLAD_GL_ARB_parallel_shader_compile;
+    }
+
+    auto spirv_supported() noexcept -> bool
+    {
+        return GLAD_GL_ARB_gl_spirv;
+    }
+
+    auto source_file_legend(std::span<std::string const> const file_names) -> std::string
+    {
+        auto legend = std::string{legend_header};
+        for (auto index = std::size_t{0}; index < file_names.size(); ++index)
+        {
+            legend += legend_line_prefix;
+            legend += std::to_string(index + 1);
+            legend += ": ";
+            legend += file_names[index];
+            legend += '\n';
+        }
+
+        return legend;
+    }
+
     Shader::Shader(
         ShaderType const type,
         std::span<std::string const> const source_fragments)
-      : id_{glCreateShader(static_cast<Enum>(type))}
+      : Shader{compile_async(type, source_fragments)}
     {
-        if (!id())
-        {
-            throw glpp::Error{"Could not create a shader object"};
-        }
-        compile(source_fragments);
+        check_status();
     }
 
     Shader::Shader(
@@ -26,6 +109,106 @@ namespace glpp
     {
     }
 
+    Shader::Shader(
+        ShaderType const type,
+        std::span<std::byte const> const spirv,
+        std::span<SpecializationConstant const> const constants,
+        std::string const& entry_point)
+      : Shader{type}
+    {
+        if (!spirv_supported())
+        {
+            throw Error{"SPIR-V shaders are not supported (GL_ARB_gl_spirv)"};
+        }
+
+        auto magic = std::uint32_t{};
+        if (spirv.size() < sizeof(magic) || spirv.size() % sizeof(magic) != 0)
+        {
+            throw ShaderCompilationError{"Invalid SPIR-V module size"};
+        }
+        std::memcpy(&magic, spirv.data(), sizeof(magic));
+        if (magic != spirv_magic)
+        {
+            throw ShaderCompilationError{"Invalid SPIR-V module (bad magic number)"};
+        }
+
+        auto const shader_id = id();
+        glShaderBinary(
+            1,
+            &shader_id,
+            GL_SHADER_BINARY_FORMAT_SPIR_V_ARB,
+            spirv.data(),
+            gsl::narrow<Size>(spirv.size()));
+
+        auto constant_ids = std::vector<UInt32>{};
+        auto constant_values = std::vector<UInt32>{};
+        constant_ids.reserve(constants.size());
+        constant_values.reserve(constants.size());
+        for (auto const& [constant_id, value] : constants)
+        {
+            constant_ids.push_back(constant_id);
+            // Every scalar is passed as its 32 bit pattern.
+            constant_values.push_back(std::visit(
+                [](auto const scalar) { return std::bit_cast<UInt32>(scalar_value(scalar)); },
+                value));
+        }
+
+        glSpecializeShaderARB(
+            id(),
+            entry_point.c_str(),
+            gsl::narrow<UInt32>(constant_ids.size()),
+            constant_ids.data(),
+            constant_values.data());
+
+        try
+        {
+            check_status();
+        }
+        catch (ShaderCompilationError const& error)
+        {
+            // Drivers may leave the log empty, e.g. for an unknown entry point.
+            if (*error.what() == '\0')
+            {
+                throw ShaderCompilationError{
+                    "Failed to specialize SPIR-V shader entry point '" + entry_point + "'",
+                };
+            }
+            throw;
+        }
+    }
+
+    auto Shader::compile_async(
+        ShaderType const type,
+        std::span<std::string const> const source_fragments)
+        -> Shader
+    {
+        auto shader = Shader{type};
+        shader.compile(source_fragments);
+
+        return shader;
+    }
+
+    auto Shader::is_ready() const noexcept -> bool
+    {
+        if (!parallel_shader_compile_supported())
+        {
+            return true;
+        }
+
+        auto completed = Int32{};
+        glGetShaderiv(id(), GL_COMPLETION_STATUS_KHR, &completed);
+        return completed != GL_FALSE;
+    }
+
+    Shader::Shader(ShaderType const type)
+      : id_{glCreateShader(static_cast<Enum>(type))}
+    {
+        if (!id())
+        {
+            throw glpp::Error{"Could not create a shader object"};
+        }
+    }
+
     void Shader::compile(std::span<std::string const> const source_fragments)
     {
         auto fragment_c_strings = std::vector<char const*>{};
@@ -42,7 +225,10 @@ namespace glpp
             fragment_c_strings.data(),
             nullptr);
         glCompileShader(id());
+    }
 
+    void Shader::check_status() const
+    {
         auto success = Int32{};
         auto log_len = Int32{};
         glGetShaderiv(id(), GL_COMPILE_STATUS, &success);
@@ -52,7 +238,7 @@ namespace glpp
         {
             auto log = std::vector<char>(static_cast<std::size_t>(log_len) + 1);
             glGetShaderInfoLog(id(), log_len, nullptr, log.data());
-            throw ShaderCompilationError{log.data()};
+            throw ShaderCompilationError{log.data() + compile_error_legend(id())};
         }
     }
 }  // namespace glpp
\ No newline at end of file
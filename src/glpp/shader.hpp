@@ -1,11 +1,14 @@
 #pragma once
 
+#include <cstddef>
 #include <span>
 #include <string>
+#include <variant>
 
 #include <glad/glad.h>
 #include "glpp/error.hpp"
 #include "glpp/id.hpp"
+#include "glpp/primitive_types.hpp"
 
 namespace glpp
 {
@@ -51,6 +54,32 @@ namespace glpp
         std::string value;
     };
 
+    // Whether GL_KHR_parallel_shader_compile (or the ARB variant)
+    // is available, letting the driver compile and link on its own
+    // threads while status queries are deferred.
+    [[nodiscard]] auto parallel_shader_compile_supported() noexcept -> bool;
+
+    // Whether GL_ARB_gl_spirv is available, for loading SPIR-V shaders.
+    [[nodiscard]] auto spirv_supported() noexcept -> bool;
+
+    // A GLSL comment naming the source files numbered from 1 by
+    // "#line" directives. It has to precede the first directive
+    // (everything before is file 0). If a shader whose source contains
+    // it fails to compile, the error ends with the names, however
+    // the shader was compiled (see glpp::resolve_shader_sources()).
+    [[nodiscard]] auto source_file_legend(std::span<std::string const> file_names) -> std::string;
+
+    // Value of a SPIR-V specialization constant;
+    // the type has to match its declaration in the shader.
+    using SpecializationValue = std::variant<bool, Int32, UInt32, Float32>;
+
+    struct SpecializationConstant
+    {
+        // As in layout(constant_id = ...).
+        UInt32 id;
+        SpecializationValue value;
+    };
+
     class Shader
     {
       public:
@@ -70,8 +99,37 @@ namespace glpp
             ShaderType type,
             std::string const& source);
 
+        // Load a shader from a SPIR-V module, specializing its entry point.
+        // Constants that are not given keep their default values.
+        //
+        // Throws glpp::Error if SPIR-V is not supported,
+        // glpp::ShaderCompilationError
+        Shader(
+            ShaderType type,
+            std::span<std::byte const> spirv,
+            std::span<SpecializationConstant const> constants = {},
+            std::string const& entry_point = "main");
+
+        // Issues the compilation without waiting for it;
+        // see glpp::ShaderCompiler.
+        //
+        // Throws glpp::Error
+        [[nodiscard]] static auto compile_async(
+            ShaderType type,
+            std::span<std::string const> source_fragments)
+            -> Shader;
+
         [[nodiscard]] auto id() const noexcept -> Id { return id_.get(); }
 
+        // Whether compilation has finished; always true without
+        // parallel shader compilation.
+        [[nodiscard]] auto is_ready() const noexcept -> bool;
+
+        // Waits for compilation to finish.
+        //
+        // Throws glpp::ShaderCompilationError
+        void check_status() const;
+
       private:
         struct Deleter
         {
@@ -85,6 +143,9 @@ namespace glpp
 
         ShaderId id_;
 
+        // Throws glpp::Error
+        explicit Shader(ShaderType type);
+
         void compile(
             std::span<std::string const> sourceFragments);
     };
@@ -0,0 +1,330 @@
+#include "glpp/shader_bundle.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <unordered_map>
+
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+#include "glpp/error.hpp"
+
+namespace
+{
+    constexpr auto magic = std::array<char, 8>{'G', 'L', 'P', 'P', 'S', 'H', 'D', 'B'};
+    constexpr auto version = std::uint32_t{1};
+
+    // Follows the magic. Then come the blob, program and shader records,
+    // the blob indices of the shader fragments, and the blob data.
+    struct Header
+    {
+        std::uint32_t version;
+        std::uint32_t program_count;
+        std::uint32_t shader_count;
+        std::uint32_t fragment_count;
+        std::uint32_t blob_count;
+        std::uint32_t reserved;
+    };
+
+    // Offset from the start of the file.
+    struct BlobRecord
+    {
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+
+    struct ProgramRecord
+    {
+        std::uint32_t name_blob;
+        std::uint32_t first_shader;
+        std::uint32_t shader_count;
+    };
+
+    struct ShaderRecord
+    {
+        std::uint32_t type;
+        std::uint32_t first_fragment;
+        std::uint32_t fragment_count;
+    };
+
+    // Reads the bundle front to back, checking every read against its size.
+    class Reader
+    {
+      public:
+        Reader(std::span<std::byte const> const data, std::filesystem::path const& path)
+          : data_{data}
+          , path_{path}
+        {
+        }
+
+        template <typename T>
+        [[nodiscard]] auto read() -> T
+        {
+            auto value = T{};
+            std::memcpy(&value, take(sizeof(T)).data(), sizeof(T));
+
+            return value;
+        }
+
+        // The bytes are taken before allocating, so a corrupt
+        // count cannot make the vector outgrow the file.
+        template <typename T>
+        [[nodiscard]] auto read(std::uint32_t const count) -> std::vector<T>
+        {
+            expect(count <= std::numeric_limits<std::size_t>::max() / sizeof(T));
+            auto const bytes = take(sizeof(T) * count);
+            auto values = std::vector<T>(count);
+            std::memcpy(values.data(), bytes.data(), bytes.size());
+
+            return values;
+        }
+
+        void expect(bool const condition) const
+        {
+            if (!condition)
+            {
+                throw glpp::Error{fmt::format("Invalid shader bundle '{0}'", path_)};
+            }
+        }
+
+      private:
+        std::span<std::byte const> data_;
+        std::size_t offset_ = 0;
+        std::filesystem::path const& path_;
+
+        [[nodiscard]] auto take(std::size_t const size) -> std::span<std::byte const>
+        {
+            expect(size <= data_.size() - offset_);
+            auto const bytes = data_.subspan(offset_, size);
+            offset_ += size;
+
+            return bytes;
+        }
+    };
+
+    void write(std::ofstream& file, std::span<std::byte const> const bytes)
+    {
+        file.write(
+            reinterpret_cast<char const*>(bytes.data()),
+            static_cast<std::streamsize>(bytes.size()));
+    }
+}  // namespace
+
+namespace glpp
+{
+    void write_shader_bundle(
+        std::filesystem::path const& path,
+        std::span<ShaderBundleProgram const> const programs)
+    {
+        auto order = std::vector<ShaderBundleProgram const*>{};
+        for (auto const& program : programs)
+        {
+            order.push_back(&program);
+        }
+        std::ranges::sort(order, {}, &ShaderBundleProgram::name);
+        if (auto const duplicate = std::ranges::adjacent_find(order, {}, &ShaderBundleProgram::name);
+            duplicate != order.end())
+        {
+            throw Error{fmt::format("Shader program '{0}' is bundled twice", (*duplicate)->name)};
+        }
+
+        auto blobs = std::vector<std::string_view>{};
+        auto blob_indices = std::unordered_map<std::string_view, std::uint32_t>{};
+        auto const add_blob = [&](std::string_view const blob) {
+            auto const [found, added] = blob_indices.try_emplace(
+                blob,
+                static_cast<std::uint32_t>(blobs.size()));
+            if (added)
+            {
+                blobs.push_back(blob);
+            }
+
+            return found->second;
+        };
+
+        auto program_records = std::vector<ProgramRecord>{};
+        auto shader_records = std::vector<ShaderRecord>{};
+        auto fragments = std::vector<std::uint32_t>{};
+        for (auto const* const program : order)
+        {
+            program_records.push_back(ProgramRecord{
+                add_blob(program->name),
+                static_cast<std::uint32_t>(shader_records.size()),
+                static_cast<std::uint32_t>(program->shaders.size()),
+            });
+            for (auto const& shader : program->shaders)
+            {
+                shader_records.push_back(ShaderRecord{
+                    static_cast<std::uint32_t>(shader.type),
+                    static_cast<std::uint32_t>(fragments.size()),
+                    static_cast<std::uint32_t>(shader.fragments.size()),
+                });
+                for (auto const& fragment : shader.fragments)
+                {
+                    fragments.push_back(add_blob(fragment));
+                }
+            }
+        }
+
+        auto const header = Header{
+            version,
+            static_cast<std::uint32_t>(program_records.size()),
+            static_cast<std::uint32_t>(shader_records.size()),
+            static_cast<std::uint32_t>(fragments.size()),
+            static_cast<std::uint32_t>(blobs.size()),
+            0,
+        };
+
+        auto blob_records = std::vector<BlobRecord>{};
+        auto offset = magic.size()
+                      + sizeof(header)
+                      + sizeof(BlobRecord) * blobs.size()
+                      + sizeof(ProgramRecord) * program_records.size()
+                      + sizeof(ShaderRecord) * shader_records.size()
+                      + sizeof(std::uint32_t) * fragments.size();
+        for (auto const blob : blobs)
+        {
+            blob_records.push_back(BlobRecord{offset, blob.size()});
+            offset += blob.size();
+        }
+
+        // Written through a temporary file, so that a running
+        // application never maps a partially written bundle.
+        auto temporary = path;
+        temporary += ".tmp";
+        {
+            auto file = std::ofstream{temporary, std::ios::binary | std::ios::trunc};
+            write(file, std::as_bytes(std::span{magic}));
+            write(file, std::as_bytes(std::span{&header, 1}));
+            write(file, std::as_bytes(std::span{blob_records}));
+            write(file, std::as_bytes(std::span{program_records}));
+            write(file, std::as_bytes(std::span{shader_records}));
+            write(file, std::as_bytes(std::span{fragments}));
+            for (auto const blob : blobs)
+            {
+                write(file, std::as_bytes(std::span{blob}));
+            }
+
+            if (!file)
+            {
+                throw Error{fmt::format("Failed to write shader bundle '{0}'", path)};
+            }
+        }
+        std::filesystem::rename(temporary, path);
+    }
+
+    ShaderBundle::ShaderBundle(std::filesystem::path const& path)
+      : file_{path}
+    {
+        auto const data = file_.data();
+        auto reader = Reader{data, path};
+
+        auto const file_magic = reader.read<std::array<char, 8>>();
+        auto const header = reader.read<Header>();
+        reader.expect(file_magic == magic && header.version == version);
+
+        auto const blob_records = reader.read<BlobRecord>(header.blob_count);
+        auto const program_records = reader.read<ProgramRecord>(header.program_count);
+        auto const shader_records = reader.read<ShaderRecord>(header.shader_count);
+        fragments_ = reader.read<std::uint32_t>(header.fragment_count);
+
+        for (auto const& blob : blob_records)
+        {
+            reader.expect(blob.offset <= data.size() && blob.size <= data.size() - blob.offset);
+            blobs_.emplace_back(
+                reinterpret_cast<char const*>(data.data()) + blob.offset,
+                static_cast<std::size_t>(blob.size));
+        }
+        reader.expect(std::ranges::all_of(fragments_, [&](auto const blob) {
+            return blob < blobs_.size();
+        }));
+
+        for (auto const& shader : shader_records)
+        {
+            reader.expect(shader.first_fragment <= fragments_.size()
+                          && shader.fragment_count <= fragments_.size() - shader.first_fragment);
+            shaders_.push_back(Stage{
+                static_cast<ShaderType>(shader.type),
+                shader.first_fragment,
+                shader.fragment_count,
+            });
+        }
+
+        for (auto const& program : program_records)
+        {
+            reader.expect(program.name_blob < blobs_.size()
+                          && program.first_shader <= shaders_.size()
+                          && program.shader_count <= shaders_.size() - program.first_shader);
+            programs_.push_back(Program{
+                blobs_[program.name_blob],
+                program.first_shader,
+                program.shader_count,
+            });
+        }
+        reader.expect(std::ranges::is_sorted(programs_, {}, &Program::name));
+    }
+
+    auto ShaderBundle::contains(std::string_view const name) const -> bool
+    {
+        return std::ranges::binary_search(programs_, name, {}, &Program::name);
+    }
+
+    auto ShaderBundle::sources(std::string_view const name) const
+        -> std::vector<ProgramShaderSource>
+    {
+        auto const& program = find(name);
+
+        auto sources = std::vector<ProgramShaderSource>{};
+        sources.reserve(program.shader_count);
+        for (auto const& shader : std::span{shaders_}.subspan(program.first_shader, program.shader_count))
+        {
+            auto& source = sources.emplace_back(ProgramShaderSource{shader.type, {}});
+            for (auto const blob :
+                 std::span{fragments_}.subspan(shader.first_fragment, shader.fragment_count))
+            {
+                source.fragments.emplace_back(blobs_[blob]);
+            }
+        }
+
+        return sources;
+    }
+
+    auto ShaderBundle::load(std::string_view const name) const -> ShaderProgram
+    {
+        auto const program_sources = sources(name);
+
+        auto shaders = std::vector<Shader>{};
+        shaders.reserve(program_sources.size());
+        for (auto const& source : program_sources)
+        {
+            shaders.emplace_back(source.type, source.fragments);
+        }
+
+        return ShaderProgram{shaders};
+    }
+
+    auto ShaderBundle::names() const -> std::vector<std::string_view>
+    {
+        auto names = std::vector<std::string_view>{};
+        names.reserve(programs_.size());
+        for (auto const& program : programs_)
+        {
+            names.push_back(program.name);
+        }
+
+        return names;
+    }
+
+    auto ShaderBundle::find(std::string_view const name) const -> Program const&
+    {
+        auto const found = std::ranges::lower_bound(programs_, name, {}, &Program::name);
+        if (found == programs_.end() || found->name != name)
+        {
+            throw Error{fmt::format("Shader program '{0}' is not in the bundle", name)};
+        }
+
+        return *found;
+    }
+}  // namespace glpp
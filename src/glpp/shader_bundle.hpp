@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "glpp/mapped_file.hpp"
+#include "glpp/shader_program.hpp"
+
+namespace glpp
+{
+    struct ShaderBundleProgram
+    {
+        std::string name;
+        // As returned by glpp::resolve_shader_sources().
+        std::vector<ProgramShaderSource> shaders;
+    };
+
+    // Writes the resolved sources of the programs into a single file;
+    // identical fragments (such as preludes and sources shared between
+    // programs) are stored once.
+    //
+    // Throws glpp::Error, std::filesystem::filesystem_error
+    void write_shader_bundle(
+        std::filesystem::path const& path,
+        std::span<ShaderBundleProgram const> programs);
+
+    // Programs written by glpp::write_shader_bundle(), loaded
+    // without touching the shader source files: the bundle is
+    // memory-mapped, and the fragments of a program are copied
+    // out of it only when its sources are requested.
+    class ShaderBundle
+    {
+      public:
+        // Throws glpp::Error, std::filesystem::filesystem_error
+        explicit ShaderBundle(std::filesystem::path const& path);
+
+        [[nodiscard]] auto contains(std::string_view name) const -> bool;
+
+        // The sources to compile the program from, e.g. with
+        // a glpp::ProgramCache or glpp::ShaderCompiler.
+        //
+        // Throws glpp::Error if the program is not in the bundle
+        [[nodiscard]] auto sources(std::string_view name) const
+            -> std::vector<ProgramShaderSource>;
+
+        // Throws glpp::Error, glpp::ShaderCompilationError
+        [[nodiscard]] auto load(std::string_view name) const -> ShaderProgram;
+
+        [[nodiscard]] auto names() const -> std::vector<std::string_view>;
+
+      private:
+        struct Program
+        {
+            std::string_view name;
+            std::uint32_t first_shader;
+            std::uint32_t shader_count;
+        };
+
+        struct Stage
+        {
+            ShaderType type;
+            std::uint32_t first_fragment;
+            std::uint32_t fragment_count;
+        };
+
+        MappedFile file_;
+        // Sorted by name.
+        std::vector<Program> programs_;
+        std::vector<Stage> shaders_;
+        // Blob of each fragment of the shaders.
+        std::vector<std::uint32_t> fragments_;
+        // Views into the mapped file.
+        std::vector<std::string_view> blobs_;
+
+        [[nodiscard]] auto find(std::string_view name) const -> Program const&;
+    };
+}  // namespace glpp
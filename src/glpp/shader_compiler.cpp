@@ -0,0 +1,138 @@
+#include "glpp/shader_compiler.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+#include <glad/glad.h>
+
+namespace glpp
+{
+    ShaderCompiler::ShaderCompiler(UInt32 const max_threads) noexcept
+    {
+        if (GLAD_GL_KHR_parallel_shader_compile)
+        {
+            glMaxShaderCompilerThreadsKHR(max_threads);
+        }
+        else if (GLAD_GL_ARB_parallel_shader_compile)
+        {
+            glMaxShaderCompilerThreadsARB(max_threads);
+        }
+    }
+
+    auto ShaderCompiler::compile(
+        std::span<ProgramShaderSource const> const shaders,
+        bool const binary_retrievable)
+        -> std::future<ShaderProgram>
+    {
+        return submit(shaders, nullptr, binary_retrievable).promise.get_future();
+    }
+
+    void ShaderCompiler::compile(
+        std::span<ProgramShaderSource const> const shaders,
+        ProgramCallback callback,
+        bool const binary_retrievable)
+    {
+        submit(shaders, std::move(callback), binary_retrievable);
+    }
+
+    auto ShaderCompiler::poll() -> std::size_t
+    {
+        // Resolving may run callbacks that submit further programs.
+        auto ready = std::vector<Pending>{};
+        auto const first_pending = std::stable_partition(
+            pending_.begin(),
+            pending_.end(),
+            [](Pending const& pending) { return pending.program.is_ready(); });
+        std::move(pending_.begin(), first_pending, std::back_inserter(ready));
+        pending_.erase(pending_.begin(), first_pending);
+
+        resolve(ready);
+
+        return pending_.size();
+    }
+
+    void ShaderCompiler::finish()
+    {
+        // Callbacks may submit further programs, which are finished too.
+        while (!pending_.empty())
+        {
+            auto ready = std::exchange(pending_, {});
+            resolve(ready);
+        }
+    }
+
+    auto ShaderCompiler::submit(
+        std::span<ProgramShaderSource const> const shaders,
+        ProgramCallback callback,
+        bool const binary_retrievable)
+        -> Pending&
+    {
+        auto compiled = std::vector<Shader>{};
+        compiled.reserve(shaders.size());
+        for (auto const& shader : shaders)
+        {
+            compiled.push_back(Shader::compile_async(shader.type, shader.fragments));
+        }
+
+        // Linking does not have to wait for the shaders;
+        // the driver orders the work.
+        auto program = ShaderProgram::link_async(compiled, binary_retrievable);
+
+        return pending_.emplace_back(Pending{
+            std::move(compiled),
+            std::move(program),
+            std::promise<ShaderProgram>{},
+            std::move(callback),
+        });
+    }
+
+    void ShaderCompiler::resolve(std::vector<Pending>& ready)
+    {
+        // Every promise is fulfilled before any callback runs, so a
+        // throwing callback cannot leave the other programs unresolved.
+        for (auto& pending : ready)
+        {
+            try
+            {
+                // A failed shader fails the link with a less useful log.
+                for (auto const& shader : pending.shaders)
+                {
+                    shader.check_status();
+                }
+                pending.program.check_status();
+                pending.promise.set_value(std::move(pending.program));
+            }
+            catch (ShaderCompilationError const&)
+            {
+                pending.promise.set_exception(std::current_exception());
+            }
+        }
+
+        auto callback_error = std::exception_ptr{};
+        for (auto& pending : ready)
+        {
+            if (!pending.callback)
+            {
+                continue;
+            }
+
+            try
+            {
+                pending.callback(pending.promise.get_future());
+            }
+            catch (...)
+            {
+                if (!callback_error)
+                {
+                    callback_error = std::current_exception();
+                }
+            }
+        }
+
+        if (callback_error)
+        {
+            std::rethrow_exception(callback_error);
+        }
+    }
+}  // namespace glpp
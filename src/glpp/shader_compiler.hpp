@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <span>
+#include <vector>
+
+#include "glpp/primitive_types.hpp"
+#include "glpp/shader.hpp"
+#include "glpp/shader_program.hpp"
+
+namespace glpp
+{
+    // Called by poll() with the ready future of a program;
+    // get() throws glpp::ShaderCompilationError if it failed.
+    using ProgramCallback = std::function<void(std::future<ShaderProgram> program)>;
+
+    // Compiles and links programs without waiting for the driver,
+    // using GL_KHR_parallel_shader_compile: compilation and linking
+    // of every submitted program are issued right away, and their
+    // status is only queried once GL_COMPLETION_STATUS_KHR reports
+    // they are done, so rendering can go on meanwhile.
+    //
+    // Without the extension, programs are still resolved by poll(),
+    // but the driver may block when issuing or resolving them.
+    //
+    // Must only be used on the GL thread; calling get() on a future
+    // before poll() has resolved it blocks forever.
+    class ShaderCompiler
+    {
+      public:
+        // Lets the driver choose the number of compiler threads.
+        static constexpr auto driver_threads = UInt32{0xFFFFFFFF};
+
+        // Sets the number of compiler threads of the driver
+        // (glMaxShaderCompilerThreadsKHR); 0 disables parallel compilation.
+        explicit ShaderCompiler(UInt32 max_threads = driver_threads) noexcept;
+
+        ShaderCompiler(ShaderCompiler const&) = delete;
+        ShaderCompiler(ShaderCompiler&&) = delete;
+
+        auto operator=(ShaderCompiler const&) = delete;
+        auto operator=(ShaderCompiler&&) = delete;
+
+        // Throws glpp::Error
+        [[nodiscard]] auto compile(
+            std::span<ProgramShaderSource const> shaders,
+            bool binary_retrievable = false)
+            -> std::future<ShaderProgram>;
+
+        // Throws glpp::Error
+        void compile(
+            std::span<ProgramShaderSource const> shaders,
+            ProgramCallback callback,
+            bool binary_retrievable = false);
+
+        // Resolves the programs that are ready, in submission order
+        // among them. Returns the number of programs still pending.
+        // If callbacks throw, the others still run and the first
+        // exception is rethrown once all of them have.
+        auto poll() -> std::size_t;
+
+        // Blocks until all pending programs are resolved;
+        // callback exceptions propagate as for poll().
+        void finish();
+
+        [[nodiscard]] auto pending() const noexcept -> std::size_t { return pending_.size(); }
+
+      private:
+        struct Pending
+        {
+            std::vector<Shader> shaders;
+            ShaderProgram program;
+            std::promise<ShaderProgram> promise;
+            ProgramCallback callback;
+        };
+
+        std::vector<Pending> pending_;
+
+        auto submit(
+            std::span<ProgramShaderSource const> shaders,
+            ProgramCallback callback,
+            bool binary_retrievable)
+            -> Pending&;
+
+        static void resolve(std::vector<Pending>& ready);
+    };
+}  // namespace glpp
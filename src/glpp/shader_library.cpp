@@ -0,0 +1,278 @@
+#include "glpp/shader_library.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+#include <fmt/format.h>
+#include "glpp/error.hpp"
+
+namespace
+{
+    [[nodiscard]] auto is_identifier_char(char const c) noexcept -> bool
+    {
+        return (c >= 'a' && c <= 'z')
+               || (c >= 'A' && c <= 'Z')
+               || (c >= '0' && c <= '9')
+               || c == '_';
+    }
+
+    // Whether the identifier appears as a whole token.
+    [[nodiscard]] auto refers_to(std::string_view const source, std::string_view const identifier)
+        -> bool
+    {
+        for (auto position = source.find(identifier);
+             position != std::string_view::npos;
+             position = source.find(identifier, position + 1))
+        {
+            auto const end = position + identifier.size();
+            if ((position == 0 || !is_identifier_char(source[position - 1]))
+                && (end == source.size() || !is_identifier_char(source[end])))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+}  // namespace
+
+namespace glpp
+{
+    ShaderLibrary::ShaderLibrary(
+        GlslVersion const version,
+        std::span<ShaderStage const> const stages,
+        std::vector<ShaderAxis> axes,
+        std::span<std::filesystem::path const> const include_directories,
+        std::span<MacroDefinition const> const definitions,
+        ShaderFilesystem const& filesystem)
+      : axes_{std::move(axes)}
+    {
+        auto offset = UInt32{0};
+        for (auto const& axis : axes_)
+        {
+            axis_offsets_.push_back(offset);
+            offset += static_cast<UInt32>(std::bit_width(axis.value_count() - 1));
+        }
+        if (offset > 64)
+        {
+            throw Error{fmt::format("Shader axes need {0} bits, at most 64 are supported", offset)};
+        }
+
+        for (auto const& stage : stages)
+        {
+            sources_.push_back(ProgramShaderSource{
+                stage.type,
+                resolve_shader_sources(
+                    version,
+                    stage.sources,
+                    include_directories,
+                    definitions,
+                    filesystem),
+            });
+        }
+
+        for (auto axis = std::size_t{0}; axis < axes_.size(); ++axis)
+        {
+            auto const used = std::ranges::any_of(sources_, [&](auto const& source) {
+                // Skips the prelude, which only has the definitions.
+                return std::any_of(
+                    source.fragments.begin() + 1,
+                    source.fragments.end(),
+                    [&](auto const& fragment) { return refers_to(fragment, axes_[axis].macro); });
+            });
+            if (used)
+            {
+                used_mask_ |= axis_mask(axis);
+            }
+        }
+    }
+
+    auto ShaderLibrary::axis_index(std::string_view const macro) const -> std::size_t
+    {
+        auto const found = std::ranges::find(axes_, macro, &ShaderAxis::macro);
+        if (found == axes_.end())
+        {
+            throw Error{fmt::format("Unknown shader axis '{0}'", macro)};
+        }
+
+        return static_cast<std::size_t>(found - axes_.begin());
+    }
+
+    auto ShaderLibrary::variant(std::span<ShaderAxisValue const> const values) const
+        -> ShaderVariantKey
+    {
+        auto key = ShaderVariantKey{0};
+        for (auto const& [macro, value] : values)
+        {
+            auto const axis = axis_index(macro);
+            if (value >= axes_[axis].value_count())
+            {
+                throw Error{fmt::format("Value {0} out of range of shader axis '{1}'", value, macro)};
+            }
+
+            key = with(key, axis, value);
+        }
+
+        return key;
+    }
+
+    auto ShaderLibrary::with(
+        ShaderVariantKey const key,
+        std::size_t const axis,
+        UInt32 const value) const noexcept
+        -> ShaderVariantKey
+    {
+        return (key & ~axis_mask(axis))
+               | (static_cast<ShaderVariantKey>(value) << axis_offsets_[axis]);
+    }
+
+    auto ShaderLibrary::value(ShaderVariantKey const key, std::size_t const axis) const noexcept
+        -> UInt32
+    {
+        return static_cast<UInt32>((key & axis_mask(axis)) >> axis_offsets_[axis]);
+    }
+
+    auto ShaderLibrary::get(ShaderVariantKey const key) -> ShaderProgram const&
+    {
+        auto& variant_entry = entry(key);
+        if (!variant_entry.program)
+        {
+            if (variant_entry.error && !variant_entry.compiling)
+            {
+                std::rethrow_exception(variant_entry.error);
+            }
+
+            auto const sources = variant_sources(variant_definitions(key));
+            auto shaders = std::vector<Shader>{};
+            shaders.reserve(sources.size());
+            for (auto const& source : sources)
+            {
+                shaders.emplace_back(source.type, source.fragments);
+            }
+            variant_entry.program.emplace(shaders);
+        }
+
+        return *variant_entry.program;
+    }
+
+    auto ShaderLibrary::get_or_fallback(ShaderVariantKey const key, ShaderCompiler& compiler)
+        -> ShaderProgram const*
+    {
+        auto& variant_entry = entry(key);
+        if (variant_entry.program)
+        {
+            return &*variant_entry.program;
+        }
+
+        if (!variant_entry.compiling && !variant_entry.error)
+        {
+            variant_entry.compiling = true;
+            compiler.compile(
+                variant_sources(variant_definitions(key)),
+                // Entries are never removed, so the pointer stays valid
+                // for as long as the library.
+                [&compiled = variant_entry, alive = std::weak_ptr{alive_}](
+                    std::future<ShaderProgram> program) {
+                    if (alive.expired())
+                    {
+                        return;
+                    }
+
+                    compiled.compiling = false;
+                    if (compiled.program)
+                    {
+                        return;
+                    }
+
+                    try
+                    {
+                        compiled.program.emplace(program.get());
+                    }
+                    catch (ShaderCompilationError const&)
+                    {
+                        compiled.error = std::current_exception();
+                    }
+                });
+        }
+
+        return fallback_;
+    }
+
+    void ShaderLibrary::set_fallback(ShaderVariantKey const key)
+    {
+        fallback_ = &get(key);
+    }
+
+    auto ShaderLibrary::axis_mask(std::size_t const axis) const noexcept -> ShaderVariantKey
+    {
+        auto const bits = std::bit_width(axes_[axis].value_count() - 1);
+
+        return ((ShaderVariantKey{1} << bits) - 1) << axis_offsets_[axis];
+    }
+
+    auto ShaderLibrary::entry(ShaderVariantKey const key) -> Entry&
+    {
+        auto const canonical = key & used_mask_;
+        if (auto const found = variants_.find(canonical); found != variants_.end())
+        {
+            return *found->second;
+        }
+
+        auto& variant_entry = programs_[variant_definitions(key)];
+        variants_.emplace(canonical, &variant_entry);
+
+        return variant_entry;
+    }
+
+    auto ShaderLibrary::variant_definitions(ShaderVariantKey const key) const -> std::string
+    {
+        auto defines = std::string{};
+        for (auto axis = std::size_t{0}; axis < axes_.size(); ++axis)
+        {
+            if ((used_mask_ & axis_mask(axis)) == 0)
+            {
+                continue;
+            }
+
+            auto const& shader_axis = axes_[axis];
+            auto const axis_value = value(key, axis);
+            if (axis_value >= shader_axis.value_count())
+            {
+                throw Error{fmt::format(
+                    "Value {0} out of range of shader axis '{1}'",
+                    axis_value,
+                    shader_axis.macro)};
+            }
+            if (shader_axis.values.empty())
+            {
+                if (axis_value != 0)
+                {
+                    defines += fmt::format("#define {0} 1\n", shader_axis.macro);
+                }
+            }
+            else
+            {
+                defines += fmt::format(
+                    "#define {0} {1}\n",
+                    shader_axis.macro,
+                    shader_axis.values[axis_value]);
+            }
+        }
+
+        return defines;
+    }
+
+    auto ShaderLibrary::variant_sources(std::string const& definitions) const
+        -> std::vector<ProgramShaderSource>
+    {
+        // Definitions follow the prelude, which starts with the version directive.
+        auto sources = sources_;
+        for (auto& source : sources)
+        {
+            source.fragments.insert(source.fragments.begin() + 1, definitions);
+        }
+
+        return sources;
+    }
+}  // namespace glpp
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "glpp/load_shader.hpp"
+#include "glpp/primitive_types.hpp"
+#include "glpp/shader.hpp"
+#include "glpp/shader_compiler.hpp"
+#include "glpp/shader_program.hpp"
+
+namespace glpp
+{
+    // A permutation axis, selected by a macro.
+    struct ShaderAxis
+    {
+        std::string macro;
+        // The macro is defined as values[i] for axis value i.
+        // If empty, the axis is a toggle: the macro is defined as 1
+        // for value 1 and left undefined for value 0.
+        std::vector<std::string> values = {};
+
+        [[nodiscard]] auto value_count() const noexcept -> UInt32
+        {
+            return values.empty() ? 2u : static_cast<UInt32>(values.size());
+        }
+    };
+
+    struct ShaderAxisValue
+    {
+        std::string_view macro;
+        UInt32 value;
+    };
+
+    // The values of all axes, packed into as few bits as they need;
+    // 0 selects value 0 of every axis.
+    using ShaderVariantKey = std::uint64_t;
+
+    // Compiles the permutations of a program lazily, on first use.
+    //
+    // Sources are resolved once; variants only differ in the macro
+    // definitions following the version directive. Axes whose macro
+    // does not appear in the sources are left undefined, and variants
+    // with the same definitions (e.g. from axis values with the same
+    // text) share a single program.
+    class ShaderLibrary
+    {
+      public:
+        // Throws glpp::Error, glpp::ShaderCompilationError,
+        // std::filesystem::filesystem_error
+        ShaderLibrary(
+            GlslVersion version,
+            std::span<ShaderStage const> stages,
+            std::vector<ShaderAxis> axes,
+            std::span<std::filesystem::path const> include_directories = {},
+            std::span<MacroDefinition const> definitions = {},
+            ShaderFilesystem const& filesystem = DefaultShaderFilesystem{});
+
+        // Pending background compilations refer to the library.
+        ShaderLibrary(ShaderLibrary const&) = delete;
+        ShaderLibrary(ShaderLibrary&&) = delete;
+
+        auto operator=(ShaderLibrary const&) = delete;
+        auto operator=(ShaderLibrary&&) = delete;
+
+        // Throws glpp::Error if the axis is not found
+        [[nodiscard]] auto axis_index(std::string_view macro) const -> std::size_t;
+
+        // Axes not given take value 0.
+        //
+        // Throws glpp::Error if an axis is not found or a value is out of range
+        [[nodiscard]] auto variant(std::span<ShaderAxisValue const> values) const
+            -> ShaderVariantKey;
+
+        // Sets the value of one axis.
+        [[nodiscard]] auto with(ShaderVariantKey key, std::size_t axis, UInt32 value) const noexcept
+            -> ShaderVariantKey;
+
+        [[nodiscard]] auto value(ShaderVariantKey key, std::size_t axis) const noexcept -> UInt32;
+
+        // Compiles the variant if it is not ready yet, without waiting
+        // for a background compilation of it.
+        //
+        // Throws glpp::Error, glpp::ShaderCompilationError
+        [[nodiscard]] auto get(ShaderVariantKey key) -> ShaderProgram const&;
+
+        // Returns the variant if it is ready; otherwise starts compiling it
+        // on the compiler, if not started yet, and returns the fallback
+        // (nullptr without one). Variants that failed to compile keep
+        // returning the fallback; get() throws their error.
+        // The compiler has to be polled; compilations that complete
+        // after the library is destroyed are dropped.
+        //
+        // Throws glpp::Error
+        [[nodiscard]] auto get_or_fallback(ShaderVariantKey key, ShaderCompiler& compiler)
+            -> ShaderProgram const*;
+
+        // Compiles the variant returned by get_or_fallback() while others compile.
+        //
+        // Throws glpp::Error, glpp::ShaderCompilationError
+        void set_fallback(ShaderVariantKey key);
+
+        [[nodiscard]] auto axes() const noexcept -> std::span<ShaderAxis const> { return axes_; }
+
+        // Number of distinct programs compiled or being compiled.
+        [[nodiscard]] auto program_count() const noexcept -> std::size_t { return programs_.size(); }
+
+      private:
+        struct Entry
+        {
+            std::optional<ShaderProgram> program;
+            std::exception_ptr error;
+            bool compiling = false;
+        };
+
+        std::vector<ShaderAxis> axes_;
+        std::vector<UInt32> axis_offsets_;
+        std::vector<ProgramShaderSource> sources_;
+        // Bits of the axes that the sources refer to.
+        ShaderVariantKey used_mask_ = 0;
+        // Keyed by the macro definitions of the variant.
+        std::unordered_map<std::string, Entry> programs_;
+        // Entries of the variants looked up so far, by key masked with used_mask_.
+        std::unordered_map<ShaderVariantKey, Entry*> variants_;
+        ShaderProgram const* fallback_ = nullptr;
+        // Expires with the library, for the compiler callbacks.
+        std::shared_ptr<bool> alive_ = std::make_shared<bool>(true);
+
+        [[nodiscard]] auto axis_mask(std::size_t axis) const noexcept -> ShaderVariantKey;
+
+        // Throws glpp::Error if a value is out of range
+        [[nodiscard]] auto entry(ShaderVariantKey key) -> Entry&;
+
+        [[nodiscard]] auto variant_definitions(ShaderVariantKey key) const -> std::string;
+
+        [[nodiscard]] auto variant_sources(std::string const& definitions) const
+            -> std::vector<ProgramShaderSource>;
+    };
+}  // namespace glpp
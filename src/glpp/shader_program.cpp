@@ -7,33 +7,72 @@
 namespace glpp
 {
     ShaderProgram::ShaderProgram(std::span<Shader const> shaders)
+      : ShaderProgram{shaders, false}
+    {
+    }
+
+    ShaderProgram::ShaderProgram(std::span<Shader const> shaders, bool const binary_retrievable)
+      : ShaderProgram{link_async(shaders, binary_retrievable)}
+    {
+        check_status();
+    }
+
+    ShaderProgram::ShaderProgram(ProgramBinary const& binary)
       : id_{glCreateProgram()}
     {
-        link(shaders);
+        glProgramBinary(
+            id(),
+            binary.format,
+            binary.data.data(),
+            gsl::narrow<Size>(binary.data.size()));
+        check_status();
     }
 
-    auto ShaderProgram::uniform_location(std::string const& name) const noexcept
-        -> std::optional<UniformLocation>
+    ShaderProgram::ShaderProgram() noexcept
+      : id_{glCreateProgram()}
     {
-        if (auto location = glGetUniformLocation(id(), name.c_str()); location != -1)
-            return UniformLocation{gsl::narrow<UInt32>(location)};
-        return std::nullopt;
     }
 
-    auto ShaderProgram::attribute_location(std::string const& name) const noexcept
-        -> std::optional<AttributeLocation>
+    auto ShaderProgram::link_async(
+        std::span<Shader const> const shaders,
+        bool const binary_retrievable)
+        -> ShaderProgram
+    {
+        auto program = ShaderProgram{};
+        if (binary_retrievable)
+        {
+            glProgramParameteri(program.id(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
+        program.link(shaders);
+
+        return program;
+    }
+
+    auto ShaderProgram::binary() const -> ProgramBinary
     {
-        if (auto location = glGetAttribLocation(id(), name.c_str()); location != -1)
-            return AttributeLocation{gsl::narrow<UInt32>(location)};
-        return std::nullopt;
+        auto binary = ProgramBinary{};
+        auto length = Int32{};
+        glGetProgramiv(id(), GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length > 0)
+        {
+            binary.data.resize(static_cast<std::size_t>(length));
+            glGetProgramBinary(id(), length, &length, &binary.format, binary.data.data());
+            binary.data.resize(static_cast<std::size_t>(length));
+        }
+
+        return binary;
     }
 
-    auto ShaderProgram::frag_output_location(std::string const& name) const noexcept
-        -> std::optional<FragOutputLocation>
+    auto ShaderProgram::is_ready() const noexcept -> bool
     {
-        if (auto location = glGetFragDataLocation(id(), name.c_str()); location != -1)
-            return FragOutputLocation{gsl::narrow<UInt32>(location)};
-        return std::nullopt;
+        if (!parallel_shader_compile_supported())
+        {
+            return true;
+        }
+
+        auto completed = Int32{};
+        glGetProgramiv(id(), GL_COMPLETION_STATUS_KHR, &completed);
+        return completed != GL_FALSE;
     }
 
     void ShaderProgram::Deleter::operator()(Id id) const noexcept
@@ -50,7 +89,10 @@ namespace glpp
 
         for (auto const& shader : shaders)
             glDetachShader(id(), shader.id());
+    }
 
+    void ShaderProgram::check_status()
+    {
         auto success = Int32{};
         auto log_len = Int32{};
         glGetProgramiv(id(), GL_LINK_STATUS, &success);
@@ -62,5 +104,7 @@ namespace glpp
             glGetProgramInfoLog(id(), log_len, nullptr, log.data());
             throw ShaderCompilationError{log.data()};
         }
+
+        reflection_ = ProgramReflection{id()};
     }
 }  // namespace glpp
\ No newline at end of file
@@ -1,12 +1,15 @@
 #pragma once
 
+#include <cstddef>
 #include <optional>
 #include <span>
 #include <string>
+#include <vector>
 
 #include <glad/glad.h>
 #include "glpp/id.hpp"
 #include "glpp/primitive_types.hpp"
+#include "glpp/program_reflection.hpp"
 #include "glpp/shader.hpp"
 
 namespace glpp
@@ -26,11 +29,47 @@ namespace glpp
         UInt32 value;
     };
 
+    // The resolved source fragments of one shader of a program,
+    // see glpp::resolve_shader_sources().
+    struct ProgramShaderSource
+    {
+        ShaderType type;
+        std::vector<std::string> fragments;
+    };
+
+    // A linked program as retrieved from the driver;
+    // only valid for the same driver and GPU.
+    struct ProgramBinary
+    {
+        Enum format;
+        std::vector<std::byte> data;
+    };
+
     class ShaderProgram
     {
       public:
+        // Throws glpp::ShaderCompilationError
         explicit ShaderProgram(std::span<Shader const> shaders);
 
+        // With binary_retrievable, hints the driver that binary()
+        // will be called.
+        //
+        // Throws glpp::ShaderCompilationError
+        ShaderProgram(std::span<Shader const> shaders, bool binary_retrievable);
+
+        // Restores a program from binary(); drivers reject binaries
+        // of other drivers or versions.
+        //
+        // Throws glpp::ShaderCompilationError
+        explicit ShaderProgram(ProgramBinary const& binary);
+
+        // Issues the link without waiting for it (nor for the shaders
+        // to compile); see glpp::ShaderCompiler.
+        [[nodiscard]] static auto link_async(
+            std::span<Shader const> shaders,
+            bool binary_retrievable = false)
+            -> ShaderProgram;
+
         void bind() const noexcept
         {
             glUseProgram(id());
@@ -41,17 +80,60 @@ namespace glpp
             glUseProgram(nullid);
         }
 
-        [[nodiscard]] auto uniform_location(std::string const& name) const noexcept
-            -> std::optional<UniformLocation>;
+        // Locations are looked up in the reflection, without calling
+        // the driver; the hashes of names given as string literals
+        // fold into constants.
+        [[nodiscard]] auto uniform_location(ResourceName const name) const noexcept
+            -> std::optional<UniformLocation>
+        {
+            if (auto location = reflection_.location(ProgramInterface::uniform, name))
+            {
+                return UniformLocation{*location};
+            }
+            return std::nullopt;
+        }
+
+        [[nodiscard]] auto attribute_location(ResourceName const name) const noexcept
+            -> std::optional<AttributeLocation>
+        {
+            if (auto location = reflection_.location(ProgramInterface::program_input, name))
+            {
+                return AttributeLocation{*location};
+            }
+            return std::nullopt;
+        }
 
-        [[nodiscard]] auto attribute_location(std::string const& name) const noexcept
-            -> std::optional<AttributeLocation>;
+        [[nodiscard]] auto frag_output_location(ResourceName const name) const noexcept
+            -> std::optional<FragOutputLocation>
+        {
+            if (auto location = reflection_.location(ProgramInterface::program_output, name))
+            {
+                return FragOutputLocation{*location};
+            }
+            return std::nullopt;
+        }
 
-        [[nodiscard]] auto frag_output_location(std::string const& name) const noexcept
-            -> std::optional<FragOutputLocation>;
+        // The active resources, queried when linking succeeded;
+        // empty until then.
+        [[nodiscard]] auto reflection() const noexcept -> ProgramReflection const&
+        {
+            return reflection_;
+        }
 
         [[nodiscard]] auto id() const noexcept -> Id { return id_.get(); }
 
+        // Whether linking has finished; always true without
+        // parallel shader compilation, see glpp::parallel_shader_compile_supported().
+        [[nodiscard]] auto is_ready() const noexcept -> bool;
+
+        // Waits for linking to finish, then reflects the program.
+        //
+        // Throws glpp::ShaderCompilationError
+        void check_status();
+
+        // Empty data if the driver does not provide binaries.
+        [[nodiscard]] auto binary() const -> ProgramBinary;
+
       private:
         struct Deleter
         {
@@ -59,6 +141,9 @@ namespace glpp
         };
 
         UniqueId<Deleter> id_;
+        ProgramReflection reflection_;
+
+        ShaderProgram() noexcept;
 
         void link(std::span<Shader const> shaders);
     };
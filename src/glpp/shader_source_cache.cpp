@@ -0,0 +1,195 @@
+#include "glpp/shader_source_cache.hpp"
+
+#include <algorithm>
+#include <istream>
+#include <iterator>
+#include <string_view>
+
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+namespace
+{
+    constexpr auto whitespace = std::string_view{" \t\r\v\f"};
+
+    [[nodiscard]] auto read_contents(std::istream& stream) -> std::string
+    {
+        auto contents = std::string{};
+
+        stream.seekg(0, std::ios::end);
+        if (auto const size = stream.tellg(); size > 0)
+        {
+            contents.resize(static_cast<std::size_t>(size));
+            stream.seekg(0, std::ios::beg);
+            stream.read(contents.data(), static_cast<std::streamsize>(size));
+            contents.resize(static_cast<std::size_t>(stream.gcount()));
+        }
+        else
+        {
+            // Not seekable.
+            stream.clear();
+            contents.assign(std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{});
+        }
+
+        return contents;
+    }
+
+    // Splits off the next whitespace separated token of a line.
+    [[nodiscard]] auto next_token(std::string_view& line) noexcept -> std::string_view
+    {
+        auto const begin = line.find_first_not_of(whitespace);
+        if (begin == std::string_view::npos)
+        {
+            line = {};
+            return {};
+        }
+
+        auto const end = std::min(line.find_first_of(whitespace, begin), line.size());
+        auto const token = line.substr(begin, end - begin);
+        line.remove_prefix(end);
+
+        return token;
+    }
+}  // namespace
+
+namespace glpp
+{
+    auto read_shader_source_file(
+        std::filesystem::path const& path,
+        ShaderFilesystem const& filesystem)
+        -> ShaderSourceFile
+    {
+        auto const file = filesystem.open(path);
+        if (file == nullptr || !*file)
+        {
+            throw ShaderCompilationError{
+                fmt::format("Failed to open shader source '{0}'", path),
+            };
+        }
+
+        // The contents become the fragment as they are;
+        // #include lines are blanked in place.
+        auto source_file = ShaderSourceFile{read_contents(*file), {}};
+        auto& text = source_file.fragment;
+        if (!text.empty() && text.back() != '\n')
+        {
+            text += '\n';
+        }
+
+        bool prologue_end = false;
+        int line_no = 1;
+
+        for (auto begin = std::size_t{0}; begin < text.size(); ++line_no)
+        {
+            auto const end = text.find('\n', begin);
+            auto const line = std::string_view{text}.substr(begin, end - begin);
+            auto rest = line;
+
+            if (auto const token = next_token(rest); token == "#include")
+            {
+                if (prologue_end)
+                {
+                    throw ShaderCompilationError{
+                        fmt::format(
+                            "In file '{0}' at line {1}: "
+                            "Invalid #include directive after non-empty line",
+                            path,
+                            line_no),
+                    };
+                }
+
+                if (auto const include = next_token(rest);
+                    include.size() >= 2
+                    && include.front() == '"'
+                    && include.back() == '"')
+                {
+                    source_file.includes.push_back(ShaderInclude{
+                        include.substr(1, include.size() - 2),
+                        line_no,
+                    });
+                    std::fill(
+                        text.begin() + static_cast<std::ptrdiff_t>(begin),
+                        text.begin() + static_cast<std::ptrdiff_t>(end),
+                        ' ');
+                }
+                else
+                {
+                    throw ShaderCompilationError{
+                        fmt::format(
+                            "In file '{0}' at line {1}: "
+                            "Invalid #include directive: '{2}'",
+                            path,
+                            line_no,
+                            line),
+                    };
+                }
+            }
+            else if (!token.empty())
+            {
+                prologue_end = true;
+            }
+
+            begin = end + 1;
+        }
+
+        return source_file;
+    }
+
+    auto ShaderSourceCache::get(
+        std::filesystem::path const& path,
+        ShaderFilesystem const& filesystem)
+        -> std::shared_ptr<ShaderSourceFile const>
+    {
+        auto const stamp = filesystem.stamp(path);
+        if (!stamp)
+        {
+            return std::make_shared<ShaderSourceFile const>(
+                read_shader_source_file(path, filesystem));
+        }
+
+        auto key = path.string();
+        {
+            auto const lock = std::scoped_lock{mutex_};
+            if (auto const found = files_.find(key);
+                found != files_.end() && found->second.stamp == *stamp)
+            {
+                ++hits_;
+                return found->second.file;
+            }
+        }
+
+        // Parsed without holding the lock; a file changed or requested
+        // by several threads at once may be parsed more than once.
+        auto file = std::make_shared<ShaderSourceFile const>(
+            read_shader_source_file(path, filesystem));
+
+        auto const lock = std::scoped_lock{mutex_};
+        files_.insert_or_assign(std::move(key), Entry{*stamp, file});
+
+        return file;
+    }
+
+    void ShaderSourceCache::erase(std::filesystem::path const& path)
+    {
+        auto const lock = std::scoped_lock{mutex_};
+        files_.erase(path.string());
+    }
+
+    void ShaderSourceCache::clear()
+    {
+        auto const lock = std::scoped_lock{mutex_};
+        files_.clear();
+    }
+
+    auto ShaderSourceCache::size() const -> std::size_t
+    {
+        auto const lock = std::scoped_lock{mutex_};
+        return files_.size();
+    }
+
+    auto ShaderSourceCache::hits() const -> std::size_t
+    {
+        auto const lock = std::scoped_lock{mutex_};
+        return hits_;
+    }
+}  // namespace glpp
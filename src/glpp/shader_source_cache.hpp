@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "glpp/load_shader.hpp"
+
+namespace glpp
+{
+    struct ShaderInclude
+    {
+        // As written in the #include directive.
+        std::filesystem::path path;
+        int line;
+    };
+
+    // A shader source file with its #include directives parsed out.
+    struct ShaderSourceFile
+    {
+        // The file contents, with #include directives replaced by empty lines.
+        std::string fragment;
+        std::vector<ShaderInclude> includes;
+    };
+
+    // Reads and parses a source file, see glpp::load_shader().
+    //
+    // Throws glpp::ShaderCompilationError
+    [[nodiscard]] auto read_shader_source_file(
+        std::filesystem::path const& path,
+        ShaderFilesystem const& filesystem)
+        -> ShaderSourceFile;
+
+    // Parsed shader source files, shared between all the shaders
+    // loaded with the cache; each file is read once, and again
+    // only when its stamp (see glpp::ShaderFilesystem::stamp())
+    // changes. Thread-safe.
+    class ShaderSourceCache
+    {
+      public:
+        // The path has to be canonical.
+        //
+        // Throws glpp::ShaderCompilationError,
+        // std::filesystem::filesystem_error
+        [[nodiscard]] auto get(
+            std::filesystem::path const& path,
+            ShaderFilesystem const& filesystem)
+            -> std::shared_ptr<ShaderSourceFile const>;
+
+        // Makes the next get() of the file read it again, even if
+        // its stamp did not change; e.g. when the file was written
+        // twice within the resolution of its write time.
+        // The path has to be canonical.
+        void erase(std::filesystem::path const& path);
+
+        void clear();
+
+        [[nodiscard]] auto size() const -> std::size_t;
+
+        // Number of get() calls that were served from the cache.
+        [[nodiscard]] auto hits() const -> std::size_t;
+
+      private:
+        struct Entry
+        {
+            ShaderFileStamp stamp;
+            std::shared_ptr<ShaderSourceFile const> file;
+        };
+
+        mutable std::mutex mutex_;
+        std::unordered_map<std::string, Entry> files_;
+        std::size_t hits_ = 0;
+    };
+}  // namespace glpp
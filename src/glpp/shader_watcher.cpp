@@ -0,0 +1,452 @@
+#include "glpp/shader_watcher.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <system_error>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+#include "glpp/error.hpp"
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#else
+#include <chrono>
+#include <condition_variable>
+#endif
+
+#ifdef __linux__
+namespace
+{
+    // Nullopt if the file can not be read, e.g. while it is replaced.
+    [[nodiscard]] auto current_stamp(std::filesystem::path const& file) noexcept
+        -> std::optional<glpp::ShaderFileStamp>
+    {
+        auto error = std::error_code{};
+        auto const last_write_time = std::filesystem::last_write_time(file, error);
+        if (error)
+        {
+            return std::nullopt;
+        }
+        auto const size = std::filesystem::file_size(file, error);
+        if (error)
+        {
+            return std::nullopt;
+        }
+
+        return glpp::ShaderFileStamp{last_write_time, size};
+    }
+}  // namespace
+#endif
+
+namespace glpp
+{
+    // Collects changed files on a background thread.
+    class ShaderWatcher::Monitor
+    {
+      public:
+        Monitor();
+
+        Monitor(Monitor const&) = delete;
+        Monitor(Monitor&&) = delete;
+
+        auto operator=(Monitor const&) = delete;
+        auto operator=(Monitor&&) = delete;
+
+        ~Monitor() noexcept;
+
+        // Throws glpp::Error
+        void watch(std::filesystem::path const& file);
+
+        // Canonical paths of the files that changed since the last call;
+        // may include files that are not watched.
+        [[nodiscard]] auto take_changes() -> std::vector<std::string>;
+
+      private:
+        std::mutex mutex_;
+        std::unordered_set<std::string> changed_;
+#ifdef __linux__
+        int inotify_fd_ = -1;
+        int wake_fd_ = -1;
+        // Files are watched through their directories, as editors
+        // often save by replacing the file.
+        std::unordered_map<int, std::filesystem::path> directories_;
+        // Stamps of the watched files, compared when the event
+        // queue overflowed and changes may have been missed.
+        std::unordered_map<std::string, std::optional<ShaderFileStamp>> files_;
+#else
+        static constexpr auto poll_interval = std::chrono::milliseconds{250};
+
+        std::condition_variable wake_;
+        bool stop_ = false;
+        std::unordered_map<std::string, std::filesystem::file_time_type> files_;
+#endif
+        std::thread thread_;
+
+        void run();
+#ifdef __linux__
+        // Marks the watched files whose stamps changed.
+        // The mutex has to be locked.
+        void restamp();
+#endif
+    };
+
+#ifdef __linux__
+    ShaderWatcher::Monitor::Monitor()
+      : inotify_fd_{inotify_init1(IN_NONBLOCK | IN_CLOEXEC)}
+      , wake_fd_{eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)}
+    {
+        if (inotify_fd_ < 0 || wake_fd_ < 0)
+        {
+            auto const reason = std::strerror(errno);
+            if (inotify_fd_ >= 0)
+            {
+                close(inotify_fd_);
+            }
+            if (wake_fd_ >= 0)
+            {
+                close(wake_fd_);
+            }
+
+            throw Error{fmt::format("Failed to start watching shader files: {0}", reason)};
+        }
+
+        thread_ = std::thread{[this] { run(); }};
+    }
+
+    ShaderWatcher::Monitor::~Monitor() noexcept
+    {
+        auto const value = std::uint64_t{1};
+        [[maybe_unused]] auto const written = write(wake_fd_, &value, sizeof(value));
+        thread_.join();
+
+        close(inotify_fd_);
+        close(wake_fd_);
+    }
+
+    void ShaderWatcher::Monitor::watch(std::filesystem::path const& file)
+    {
+        auto const directory = file.parent_path();
+        auto const descriptor = inotify_add_watch(
+            inotify_fd_,
+            directory.c_str(),
+            IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (descriptor < 0)
+        {
+            throw Error{fmt::format(
+                "Failed to watch shader directory '{0}': {1}",
+                directory,
+                std::strerror(errno))};
+        }
+
+        auto stamp = current_stamp(file);
+        auto const lock = std::scoped_lock{mutex_};
+        directories_.insert_or_assign(descriptor, directory);
+        files_.insert_or_assign(file.string(), std::move(stamp));
+    }
+
+    void ShaderWatcher::Monitor::restamp()
+    {
+        for (auto& [file, stamp] : files_)
+        {
+            if (auto current = current_stamp(file); current != stamp)
+            {
+                stamp = std::move(current);
+                changed_.insert(file);
+            }
+        }
+    }
+
+    void ShaderWatcher::Monitor::run()
+    {
+        alignas(inotify_event) char buffer[4096];
+        auto fds = std::array{
+            pollfd{inotify_fd_, POLLIN, 0},
+            pollfd{wake_fd_, POLLIN, 0},
+        };
+
+        while (true)
+        {
+            if (poll(fds.data(), fds.size(), -1) < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return;
+            }
+            if (fds[1].revents != 0)
+            {
+                return;
+            }
+
+            auto length = ssize_t{};
+            while ((length = read(inotify_fd_, buffer, sizeof(buffer))) > 0)
+            {
+                auto const lock = std::scoped_lock{mutex_};
+                for (auto offset = ssize_t{0}; offset < length;)
+                {
+                    auto const* const event = reinterpret_cast<inotify_event const*>(buffer + offset);
+                    offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+                    if ((event->mask & IN_Q_OVERFLOW) != 0)
+                    {
+                        restamp();
+                        continue;
+                    }
+
+                    if (event->len == 0)
+                    {
+                        continue;
+                    }
+
+                    if (auto const directory = directories_.find(event->wd);
+                        directory != directories_.end())
+                    {
+                        auto file = (directory->second / event->name).string();
+                        if (auto const watched = files_.find(file); watched != files_.end())
+                        {
+                            watched->second = current_stamp(file);
+                        }
+                        changed_.insert(std::move(file));
+                    }
+                }
+            }
+        }
+    }
+#else
+    ShaderWatcher::Monitor::Monitor()
+      : thread_{[this] { run(); }}
+    {
+    }
+
+    ShaderWatcher::Monitor::~Monitor() noexcept
+    {
+        {
+            auto const lock = std::scoped_lock{mutex_};
+            stop_ = true;
+        }
+        wake_.notify_one();
+        thread_.join();
+    }
+
+    void ShaderWatcher::Monitor::watch(std::filesystem::path const& file)
+    {
+        auto error = std::error_code{};
+        auto const time = std::filesystem::last_write_time(file, error);
+
+        auto const lock = std::scoped_lock{mutex_};
+        files_.try_emplace(file.string(), time);
+    }
+
+    void ShaderWatcher::Monitor::run()
+    {
+        auto lock = std::unique_lock{mutex_};
+        while (!wake_.wait_for(lock, poll_interval, [this] { return stop_; }))
+        {
+            for (auto& [file, time] : files_)
+            {
+                auto error = std::error_code{};
+                if (auto const current = std::filesystem::last_write_time(file, error);
+                    !error && current != time)
+                {
+                    time = current;
+                    changed_.insert(file);
+                }
+            }
+        }
+    }
+#endif
+
+    auto ShaderWatcher::Monitor::take_changes() -> std::vector<std::string>
+    {
+        auto const lock = std::scoped_lock{mutex_};
+        auto changes = std::vector<std::string>(changed_.begin(), changed_.end());
+        changed_.clear();
+
+        return changes;
+    }
+
+    ShaderWatcher::ShaderWatcher(ShaderCompiler& compiler)
+      : compiler_{compiler}
+      , monitor_{std::make_unique<Monitor>()}
+    {
+    }
+
+    ShaderWatcher::~ShaderWatcher() noexcept = default;
+
+    auto ShaderWatcher::add(WatchedProgram sources) -> ProgramId
+    {
+        auto dependencies = std::vector<std::filesystem::path>{};
+        auto const resolved = resolve(sources, dependencies);
+
+        auto shaders = std::vector<Shader>{};
+        shaders.reserve(resolved.size());
+        for (auto const& shader : resolved)
+        {
+            shaders.emplace_back(shader.type, shader.fragments);
+        }
+
+        auto const id = programs_.size();
+        programs_.push_back(Entry{
+            std::move(sources),
+            ShaderProgram{shaders},
+        });
+        watch(id, std::move(dependencies));
+
+        return id;
+    }
+
+    auto ShaderWatcher::update() -> std::size_t
+    {
+        auto swapped = std::size_t{0};
+        for (auto const id : std::exchange(ready_, {}))
+        {
+            if (auto& entry = programs_[id]; entry.reloaded)
+            {
+                entry.program = std::move(*entry.reloaded);
+                entry.reloaded.reset();
+                ++swapped;
+            }
+        }
+
+        auto affected = std::exchange(dirty_, {});
+        for (auto const& file : monitor_->take_changes())
+        {
+            // The stamp may not have changed with the contents.
+            source_cache_.erase(file);
+            if (auto const found = dependents_.find(file); found != dependents_.end())
+            {
+                affected.insert(affected.end(), found->second.begin(), found->second.end());
+            }
+        }
+        std::sort(affected.begin(), affected.end());
+        affected.erase(std::unique(affected.begin(), affected.end()), affected.end());
+
+        for (auto const id : affected)
+        {
+            if (programs_[id].reloading)
+            {
+                programs_[id].dirty = true;
+            }
+            else
+            {
+                reload(id);
+            }
+        }
+
+        return swapped;
+    }
+
+    auto ShaderWatcher::resolve(
+        WatchedProgram const& sources,
+        std::vector<std::filesystem::path>& dependencies)
+        -> std::vector<ProgramShaderSource>
+    {
+        auto resolved = std::vector<ProgramShaderSource>{};
+        for (auto const& stage : sources.stages)
+        {
+            resolved.push_back(ProgramShaderSource{
+                stage.type,
+                resolve_shader_sources(
+                    sources.version,
+                    stage.sources,
+                    sources.include_directories,
+                    sources.definitions,
+                    DefaultShaderFilesystem{},
+                    &source_cache_,
+                    &dependencies),
+            });
+        }
+
+        return resolved;
+    }
+
+    void ShaderWatcher::watch(ProgramId const id, std::vector<std::filesystem::path> dependencies)
+    {
+        std::sort(dependencies.begin(), dependencies.end());
+        dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+
+        auto& entry = programs_[id];
+        for (auto const& file : entry.dependencies)
+        {
+            std::erase(dependents_[file.string()], id);
+        }
+
+        for (auto const& file : dependencies)
+        {
+            monitor_->watch(file);
+            dependents_[file.string()].push_back(id);
+        }
+        entry.dependencies = std::move(dependencies);
+    }
+
+    void ShaderWatcher::reload(ProgramId const id)
+    {
+        auto& entry = programs_[id];
+        entry.dirty = false;
+
+        // Until the sources resolve again, the old dependencies stay watched.
+        auto dependencies = std::vector<std::filesystem::path>{};
+        auto sources = std::vector<ProgramShaderSource>{};
+        try
+        {
+            sources = resolve(entry.sources, dependencies);
+        }
+        catch (ShaderCompilationError const& error)
+        {
+            entry.error = error.what();
+            return;
+        }
+        catch (std::filesystem::filesystem_error const& error)
+        {
+            entry.error = error.what();
+            return;
+        }
+        watch(id, std::move(dependencies));
+
+        entry.reloading = true;
+        compiler_.compile(
+            sources,
+            [this, id, alive = std::weak_ptr{alive_}](std::future<ShaderProgram> program) {
+                if (alive.expired())
+                {
+                    return;
+                }
+
+                auto& reloaded = programs_[id];
+                reloaded.reloading = false;
+                try
+                {
+                    auto compiled = program.get();
+                    if (!reloaded.reloaded)
+                    {
+                        ready_.push_back(id);
+                    }
+                    reloaded.reloaded.emplace(std::move(compiled));
+                    reloaded.error.clear();
+                }
+                catch (ShaderCompilationError const& error)
+                {
+                    reloaded.error = error.what();
+                }
+
+                if (reloaded.dirty)
+                {
+                    dirty_.push_back(id);
+                }
+            });
+    }
+}  // namespace glpp
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "glpp/load_shader.hpp"
+#include "glpp/shader.hpp"
+#include "glpp/shader_compiler.hpp"
+#include "glpp/shader_program.hpp"
+#include "glpp/shader_source_cache.hpp"
+
+namespace glpp
+{
+    struct WatchedProgram
+    {
+        GlslVersion version;
+        std::vector<ShaderStage> stages;
+        std::vector<std::filesystem::path> include_directories = {};
+        std::vector<MacroDefinition> definitions = {};
+    };
+
+    // Reloads programs when their source or include files change.
+    //
+    // The files each program was resolved from are watched on a background
+    // thread (with inotify on Linux, by polling their stamps elsewhere;
+    // if the inotify queue overflows, all the stamps are compared).
+    // update() recompiles only the programs affected by a change, on the
+    // compiler, and swaps each one in at the update after it is ready;
+    // if compilation fails, the old program is kept.
+    //
+    // Must only be used on the GL thread, except for the background
+    // watching, which only touches the filesystem.
+    class ShaderWatcher
+    {
+      public:
+        using ProgramId = std::size_t;
+
+        // The compiler has to be polled, and outlive the watcher.
+        //
+        // Throws glpp::Error if watching can not be started
+        explicit ShaderWatcher(ShaderCompiler& compiler);
+
+        ShaderWatcher(ShaderWatcher const&) = delete;
+        ShaderWatcher(ShaderWatcher&&) = delete;
+
+        auto operator=(ShaderWatcher const&) = delete;
+        auto operator=(ShaderWatcher&&) = delete;
+
+        ~ShaderWatcher() noexcept;
+
+        // Compiles the program and starts watching its files.
+        //
+        // Throws glpp::Error, glpp::ShaderCompilationError,
+        // std::filesystem::filesystem_error
+        auto add(WatchedProgram sources) -> ProgramId;
+
+        // The reference stays valid; it refers to the reloaded
+        // program after a swap.
+        [[nodiscard]] auto program(ProgramId id) const noexcept -> ShaderProgram const&
+        {
+            return programs_[id].program;
+        }
+
+        // The error of the last failed reload;
+        // empty once a reload succeeds.
+        [[nodiscard]] auto error(ProgramId id) const noexcept -> std::string const&
+        {
+            return programs_[id].error;
+        }
+
+        // To be called at a frame boundary: swaps in the reloaded programs
+        // that are ready, and starts reloading the programs whose files
+        // changed. Returns the number of programs swapped.
+        auto update() -> std::size_t;
+
+      private:
+        class Monitor;
+
+        struct Entry
+        {
+            WatchedProgram sources;
+            ShaderProgram program;
+            std::vector<std::filesystem::path> dependencies = {};
+            std::optional<ShaderProgram> reloaded = {};
+            std::string error = {};
+            bool reloading = false;
+            // Changed while reloading.
+            bool dirty = false;
+        };
+
+        ShaderCompiler& compiler_;
+        ShaderSourceCache source_cache_;
+        std::deque<Entry> programs_;
+        // Canonical path to the programs depending on it.
+        std::unordered_map<std::string, std::vector<ProgramId>> dependents_;
+        // Reloaded programs waiting to be swapped in.
+        std::vector<ProgramId> ready_;
+        // Programs that changed while reloading.
+        std::vector<ProgramId> dirty_;
+        // Lets pending reloads outlive the watcher.
+        std::shared_ptr<bool> alive_ = std::make_shared<bool>(true);
+        std::unique_ptr<Monitor> monitor_;
+
+        [[nodiscard]] auto resolve(
+            WatchedProgram const& sources,
+            std::vector<std::filesystem::path>& dependencies)
+            -> std::vector<ProgramShaderSource>;
+
+        void watch(ProgramId id, std::vector<std::filesystem::path> dependencies);
+
+        void reload(ProgramId id);
+    };
+}  // namespace glpp
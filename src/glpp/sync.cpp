@@ -0,0 +1,26 @@
+#include "glpp/sync.hpp"
+
+#include "glpp/primitive_types.hpp"
+
+namespace glpp
+{
+    auto Fence::is_signaled() const noexcept -> bool
+    {
+        return wait(std::chrono::nanoseconds{0});
+    }
+
+    auto Fence::wait(std::chrono::nanoseconds const timeout) const noexcept -> bool
+    {
+        auto const result = glClientWaitSync(
+            get(),
+            GL_SYNC_FLUSH_COMMANDS_BIT,
+            static_cast<UInt64>(timeout.count()));
+
+        return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+    }
+
+    void Fence::Deleter::operator()(GLsync const sync) const noexcept
+    {
+        glDeleteSync(sync);
+    }
+}  // namespace glpp
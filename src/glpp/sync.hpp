@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <type_traits>
+
+#include <glad/glad.h>
+
+namespace glpp
+{
+    // A GL sync object, signaled once all commands issued
+    // before its construction have completed.
+    class Fence
+    {
+      public:
+        Fence() noexcept
+          : sync_{glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0)} {}
+
+        // Does not block; flushes the command stream so that
+        // the fence is guaranteed to signal eventually.
+        [[nodiscard]] auto is_signaled() const noexcept -> bool;
+
+        // Returns false on timeout.
+        [[nodiscard]] auto wait(std::chrono::nanoseconds timeout) const noexcept -> bool;
+
+        [[nodiscard]] auto get() const noexcept -> GLsync { return sync_.get(); }
+
+      private:
+        struct Deleter
+        {
+            void operator()(GLsync sync) const noexcept;
+        };
+
+        std::unique_ptr<std::remove_pointer_t<GLsync>, Deleter> sync_;
+    };
+}  // namespace glpp
@@ -2,73 +2,234 @@
 
 #include <array>
 
+#include "glpp/mip_downsampler.hpp"
 #include "glpp/scoped_bind.hpp"
 #include "glpp/traits.hpp"
 
+namespace
+{
+    // Sets the pixel store state for an upload; only the parameters
+    // that differ from the current state are set and then restored.
+    class ScopedUnpackLayout
+    {
+      public:
+        // The default layout is taken to be the current state, so that
+        // plain uploads do not query it; each query is a round trip
+        // with threaded drivers.
+        explicit ScopedUnpackLayout(glpp::TextureBase::UnpackLayout const layout) noexcept
+        {
+            if (layout.is_default())
+            {
+                return;
+            }
+
+            set(GL_UNPACK_ROW_LENGTH, layout.row_length);
+            set(GL_UNPACK_SKIP_PIXELS, layout.skip_pixels);
+            set(GL_UNPACK_SKIP_ROWS, layout.skip_rows);
+            set(GL_UNPACK_ALIGNMENT, layout.alignment);
+        }
+
+        ScopedUnpackLayout(ScopedUnpackLayout const&) = delete;
+        ScopedUnpackLayout(ScopedUnpackLayout&&) = delete;
+
+        ~ScopedUnpackLayout() noexcept
+        {
+            for (auto i = std::size_t{0}; i < changed_count_; ++i)
+            {
+                glPixelStorei(changed_[i].parameter, changed_[i].previous_value);
+            }
+        }
+
+        auto operator=(ScopedUnpackLayout const&) = delete;
+        auto operator=(ScopedUnpackLayout&&) = delete;
+
+      private:
+        struct Change
+        {
+            glpp::Enum parameter;
+            glpp::Int32 previous_value;
+        };
+
+        std::array<Change, 4> changed_ = {};
+        std::size_t changed_count_ = 0;
+
+        void set(glpp::Enum const parameter, glpp::Int32 const value) noexcept
+        {
+            auto previous_value = glpp::Int32{};
+            glGetIntegerv(parameter, &previous_value);
+            if (previous_value != value)
+            {
+                glPixelStorei(parameter, value);
+                changed_[changed_count_++] = Change{parameter, previous_value};
+            }
+        }
+    };
+}  // namespace
+
 namespace glpp
 {
-    Texture::Texture(
+    auto TextureBase::internal_format_enumerator(
+        InternalFormat const internal_format) noexcept -> Enum
+    {
+        return std::visit(
+            [](auto const internal_format) {
+                return static_cast<Enum>(internal_format);
+            },
+            internal_format);
+    }
+
+    void TextureBase::Deleter::operator()(UInt32 const size, Id* const data) const noexcept
+    {
+        glDeleteTextures(size, data);
+    }
+
+    void TextureBase::do_generate_mipmap(Enum const target) noexcept
+    {
+        glGenerateMipmap(target);
+    }
+
+    void TextureBase::do_set_filter(
+        Enum const target,
+        Filter const filter) noexcept
+    {
+        glTexParameteri(
+            target,
+            GL_TEXTURE_MIN_FILTER,
+            std::visit(
+                [](auto const filter_type) {
+                    return static_cast<Enum>(filter_type);
+                },
+                filter.min));
+        glTexParameteri(
+            target,
+            GL_TEXTURE_MAG_FILTER,
+            static_cast<Enum>(filter.mag));
+    }
+
+    void TextureBase::do_set_wrap_behaviour(
+        Enum const target,
+        WrapBehaviour const wrap_behaviour) noexcept
+    {
+        glTexParameteri(
+            target,
+            GL_TEXTURE_WRAP_S,
+            static_cast<Enum>(wrap_behaviour.s));
+        glTexParameteri(
+            target,
+            GL_TEXTURE_WRAP_T,
+            static_cast<Enum>(wrap_behaviour.t));
+
+        if (target == GL_TEXTURE_3D)
+        {
+            glTexParameteri(
+                target,
+                GL_TEXTURE_WRAP_R,
+                static_cast<Enum>(wrap_behaviour.r));
+        }
+    }
+
+    void TextureBase::do_set_swizzle(
+        Enum const target,
+        SwizzleMask const mask) noexcept
+    {
+        auto const mask_array = std::array<Int32, 4>{
+            static_cast<Int32>(mask.r),
+            static_cast<Int32>(mask.g),
+            static_cast<Int32>(mask.b),
+            static_cast<Int32>(mask.a),
+        };
+        glTexParameteriv(
+            target,
+            GL_TEXTURE_SWIZZLE_RGBA,
+            mask_array.data());
+    }
+
+    void TextureBase::do_set_max_level(
+        Enum const target,
+        Int32 const max_level) noexcept
+    {
+        glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, max_level);
+    }
+
+    template <TextureType type>
+    BasicTexture<type>::BasicTexture(
         Data const data,
+        InternalFormat const internal_format,
         Filter const filter,
         WrapBehaviour const wrap_behaviour,
         SwizzleMask const swizzle) noexcept
-      : Texture{
-          data,
-          data.format,
-          filter,
-          wrap_behaviour,
-          swizzle,
-      }
+        requires is_2d
     {
+        auto const binding = glpp::ScopedBind{*this};
+
+        do_load(target, data, 1, internal_format, 0);
+        do_set_parameters(filter, wrap_behaviour, swizzle);
     }
 
-    Texture::Texture(
+    template <TextureType type>
+    BasicTexture<type>::BasicTexture(
         Data const data,
+        Size const depth,
         InternalFormat const internal_format,
         Filter const filter,
         WrapBehaviour const wrap_behaviour,
         SwizzleMask const swizzle) noexcept
+        requires is_layered
     {
         auto const binding = glpp::ScopedBind{*this};
 
-        do_load(data, internal_format, 0);
-        do_set_filter(filter);
-        do_set_wrap_behaviour(wrap_behaviour);
-        do_set_swizzle(swizzle);
-
-        if (std::holds_alternative<MipmapFilterType>(filter.min))
-        {
-            do_generate_mipmap();
-        }
+        do_load(target, data, depth, internal_format, 0);
+        do_set_parameters(filter, wrap_behaviour, swizzle);
     }
 
-    void Texture::load(
-        Data const data,
-        Int32 const level) noexcept
+    template <TextureType type>
+    BasicTexture<type>::BasicTexture(
+        std::span<Data const, 6> const faces,
+        InternalFormat const internal_format,
+        Filter const filter,
+        WrapBehaviour const wrap_behaviour,
+        SwizzleMask const swizzle) noexcept
+        requires is_cube_map
     {
-        load(data, data.format, level);
+        auto const binding = glpp::ScopedBind{*this};
+
+        for (auto i = std::size_t{0}; i < cube_map_faces.size(); ++i)
+        {
+            do_load(
+                static_cast<Enum>(cube_map_faces[i]),
+                faces[i],
+                1,
+                internal_format,
+                0);
+        }
+        do_set_parameters(filter, wrap_behaviour, swizzle);
     }
 
-    void Texture::load(
+    template <TextureType type>
+    void BasicTexture<type>::load(
         Data const data,
         InternalFormat const internal_format,
         Int32 const level) noexcept
+        requires is_2d
     {
         auto const binding = glpp::ScopedBind{*this};
-        
-        do_load(data, internal_format, level);
+
+        do_load(target, data, 1, internal_format, level);
     }
 
-    void Texture::update(
+    template <TextureType type>
+    void BasicTexture<type>::update(
         Data const data,
         Int32 const x_offset,
         Int32 const y_offset,
         Int32 const level) noexcept
+        requires is_2d
     {
         auto const binding = glpp::ScopedBind{*this};
+        auto const unpack = ScopedUnpackLayout{data.unpack};
 
         glTexSubImage2D(
-            GL_TEXTURE_2D,
+            target,
             level,
             x_offset,
             y_offset,
@@ -79,109 +240,240 @@ namespace glpp
             data.data.get());
     }
 
-    void Texture::set_filter(Filter const filter) noexcept
+    template <TextureType type>
+    void BasicTexture<type>::load_compressed(
+        CompressedData const data,
+        Int32 const level) noexcept
+        requires is_2d
     {
         auto const binding = glpp::ScopedBind{*this};
 
-        do_set_filter(filter);
+        glCompressedTexImage2D(
+            target,
+            level,
+            static_cast<Enum>(data.format),
+            data.width,
+            data.height,
+            0,
+            static_cast<Size>(data.data.size()),
+            data.data.data());
+
+        if (level == 0)
+        {
+            set_size(data.width, data.height);
+        }
     }
 
-    void Texture::set_wrap_behaviour(WrapBehaviour const wrap_behaviour) noexcept
+    template <TextureType type>
+    void BasicTexture<type>::update_compressed(
+        CompressedData const data,
+        Int32 const x_offset,
+        Int32 const y_offset,
+        Int32 const level) noexcept
+        requires is_2d
     {
         auto const binding = glpp::ScopedBind{*this};
 
-        do_set_wrap_behaviour(wrap_behaviour);
+        glCompressedTexSubImage2D(
+            target,
+            level,
+            x_offset,
+            y_offset,
+            data.width,
+            data.height,
+            static_cast<Enum>(data.format),
+            static_cast<Size>(data.data.size()),
+            data.data.data());
     }
 
-    void Texture::set_swizzle(SwizzleMask const mask) noexcept
+    template <TextureType type>
+    void BasicTexture<type>::load(
+        Data const data,
+        Size const depth,
+        InternalFormat const internal_format,
+        Int32 const level) noexcept
+        requires is_layered
     {
         auto const binding = glpp::ScopedBind{*this};
 
-        do_set_swizzle(mask);
+        do_load(target, data, depth, internal_format, level);
     }
 
-    void Texture::generate_mipmap() noexcept
+    template <TextureType type>
+    void BasicTexture<type>::update(
+        Data const data,
+        Int32 const layer,
+        Int32 const x_offset,
+        Int32 const y_offset,
+        Int32 const level) noexcept
+        requires is_layered
     {
-        auto const binding = glpp::ScopedBind{*this}; 
-        do_generate_mipmap();
+        auto const binding = glpp::ScopedBind{*this};
+        auto const unpack = ScopedUnpackLayout{data.unpack};
+
+        glTexSubImage3D(
+            target,
+            level,
+            x_offset,
+            y_offset,
+            layer,
+            data.width,
+            data.height,
+            1,
+            static_cast<Enum>(data.format),
+            data.data.enumerator(),
+            data.data.get());
     }
 
-    void Texture::Deleter::operator()(UInt32 const size, Id* const data) const noexcept
+    template <TextureType type>
+    void BasicTexture<type>::load(
+        CubeMapFace const face,
+        Data const data,
+        InternalFormat const internal_format,
+        Int32 const level) noexcept
+        requires is_cube_map
     {
-        glDeleteTextures(size, data);
+        auto const binding = glpp::ScopedBind{*this};
+
+        do_load(static_cast<Enum>(face), data, 1, internal_format, level);
     }
 
-    void Texture::do_load(
+    template <TextureType type>
+    void BasicTexture<type>::update(
+        CubeMapFace const face,
         Data const data,
-        InternalFormat const internal_format,
+        Int32 const x_offset,
+        Int32 const y_offset,
         Int32 const level) noexcept
+        requires is_cube_map
     {
-        glTexImage2D(
-            GL_TEXTURE_2D,
+        auto const binding = glpp::ScopedBind{*this};
+        auto const unpack = ScopedUnpackLayout{data.unpack};
+
+        glTexSubImage2D(
+            static_cast<Enum>(face),
             level,
-            std::visit(
-                [](auto const internal_format) {
-                    return static_cast<Enum>(internal_format);
-                },
-                internal_format),
+            x_offset,
+            y_offset,
             data.width,
             data.height,
-            0,
             static_cast<Enum>(data.format),
             data.data.enumerator(),
             data.data.get());
+    }
 
-        if (level == 0)
-        {
-            width_ = data.width;
-            height_ = data.height;
-        }
+    template <TextureType type>
+    void BasicTexture<type>::set_filter(Filter const filter) noexcept
+    {
+        auto const binding = glpp::ScopedBind{*this};
+
+        do_set_filter(target, filter);
     }
 
-    void Texture::do_generate_mipmap() noexcept
+    template <TextureType type>
+    void BasicTexture<type>::set_wrap_behaviour(WrapBehaviour const wrap_behaviour) noexcept
     {
-        glGenerateMipmap(GL_TEXTURE_2D);
+        auto const binding = glpp::ScopedBind{*this};
+
+        do_set_wrap_behaviour(target, wrap_behaviour);
     }
 
-    void Texture::do_set_filter(Filter const filter) noexcept
+    template <TextureType type>
+    void BasicTexture<type>::set_swizzle(SwizzleMask const mask) noexcept
     {
-        glTexParameteri(
-            GL_TEXTURE_2D,
-            GL_TEXTURE_MIN_FILTER,
-            std::visit(
-                [](auto const filter_type) {
-                    return static_cast<Enum>(filter_type);
-                },
-                filter.min));
-        glTexParameteri(
-            GL_TEXTURE_2D,
-            GL_TEXTURE_MAG_FILTER,
-            static_cast<Enum>(filter.mag));
+        auto const binding = glpp::ScopedBind{*this};
+
+        do_set_swizzle(target, mask);
     }
 
-    void Texture::do_set_wrap_behaviour(WrapBehaviour const wrap_behaviour) noexcept
+    template <TextureType type>
+    void BasicTexture<type>::set_max_level(Int32 const max_level) noexcept
     {
-        glTexParameteri(
-            GL_TEXTURE_2D,
-            GL_TEXTURE_WRAP_S,
-            static_cast<Enum>(wrap_behaviour.s));
-        glTexParameteri(
-            GL_TEXTURE_2D,
-            GL_TEXTURE_WRAP_T,
-            static_cast<Enum>(wrap_behaviour.t));
+        auto const binding = glpp::ScopedBind{*this};
+
+        do_set_max_level(target, max_level);
     }
 
-    void Texture::do_set_swizzle(SwizzleMask const mask) noexcept
+    template <TextureType type>
+    void BasicTexture<type>::generate_mipmap() noexcept
     {
-        auto const mask_array = std::array<Int32, 4>{
-            static_cast<Int32>(mask.r),
-            static_cast<Int32>(mask.g),
-            static_cast<Int32>(mask.b),
-            static_cast<Int32>(mask.a),
-        };
-        glTexParameteriv(
-            GL_TEXTURE_2D,
-            GL_TEXTURE_SWIZZLE_RGBA,
-            mask_array.data());
+        auto const binding = glpp::ScopedBind{*this};
+        do_generate_mipmap(target);
+    }
+
+    template <TextureType type>
+    void BasicTexture<type>::generate_mipmap(
+        MipDownsampler& downsampler,
+        MipReduction const reduction)
+        requires is_2d
+    {
+        downsampler.downsample(*this, reduction);
     }
+
+    template <TextureType type>
+    void BasicTexture<type>::do_load(
+        Enum const image_target,
+        Data const data,
+        [[maybe_unused]] Size const depth,
+        InternalFormat const internal_format,
+        Int32 const level) noexcept
+    {
+        auto const unpack = ScopedUnpackLayout{data.unpack};
+
+        if constexpr (is_layered)
+        {
+            glTexImage3D(
+                image_target,
+                level,
+                internal_format_enumerator(internal_format),
+                data.width,
+                data.height,
+                depth,
+                0,
+                static_cast<Enum>(data.format),
+                data.data.enumerator(),
+                data.data.get());
+        }
+        else
+        {
+            glTexImage2D(
+                image_target,
+                level,
+                internal_format_enumerator(internal_format),
+                data.width,
+                data.height,
+                0,
+                static_cast<Enum>(data.format),
+                data.data.enumerator(),
+                data.data.get());
+        }
+
+        if (level == 0)
+        {
+            set_size(data.width, data.height);
+            depth_ = depth;
+        }
+    }
+
+    template <TextureType type>
+    void BasicTexture<type>::do_set_parameters(
+        Filter const filter,
+        WrapBehaviour const wrap_behaviour,
+        SwizzleMask const swizzle) noexcept
+    {
+        do_set_filter(target, filter);
+        do_set_wrap_behaviour(target, wrap_behaviour);
+        do_set_swizzle(target, swizzle);
+
+        if (std::holds_alternative<MipmapFilterType>(filter.min))
+        {
+            do_generate_mipmap(target);
+        }
+    }
+
+    template class BasicTexture<TextureType::texture_2d>;
+    template class BasicTexture<TextureType::texture_2d_array>;
+    template class BasicTexture<TextureType::texture_3d>;
+    template class BasicTexture<TextureType::cube_map>;
+    template class BasicTexture<TextureType::cube_map_array>;
 }  // namespace glpp
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <span>
 #include <string>
 #include <variant>
 
@@ -12,7 +15,48 @@
 
 namespace glpp
 {
-    class Texture
+    class MipDownsampler;
+
+    enum class MipReduction : std::uint8_t;
+
+    enum class TextureType : Enum
+    {
+        texture_2d = GL_TEXTURE_2D,
+        texture_2d_array = GL_TEXTURE_2D_ARRAY,
+        texture_3d = GL_TEXTURE_3D,
+        cube_map = GL_TEXTURE_CUBE_MAP,
+        cube_map_array = GL_TEXTURE_CUBE_MAP_ARRAY,
+    };
+
+    enum class CubeMapFace : Enum
+    {
+        positive_x = GL_TEXTURE_CUBE_MAP_POSITIVE_X,
+        negative_x = GL_TEXTURE_CUBE_MAP_NEGATIVE_X,
+        positive_y = GL_TEXTURE_CUBE_MAP_POSITIVE_Y,
+        negative_y = GL_TEXTURE_CUBE_MAP_NEGATIVE_Y,
+        positive_z = GL_TEXTURE_CUBE_MAP_POSITIVE_Z,
+        negative_z = GL_TEXTURE_CUBE_MAP_NEGATIVE_Z,
+    };
+
+    inline constexpr auto cube_map_faces = std::array{
+        CubeMapFace::positive_x,
+        CubeMapFace::negative_x,
+        CubeMapFace::positive_y,
+        CubeMapFace::negative_y,
+        CubeMapFace::positive_z,
+        CubeMapFace::negative_z,
+    };
+
+    // Layered textures are allocated with glTexImage3D and updated
+    // one layer (or one depth slice for 3D textures) at a time.
+    template <TextureType type>
+    inline constexpr auto is_layered_texture_type_v
+        = type == TextureType::texture_2d_array
+          || type == TextureType::texture_3d
+          || type == TextureType::cube_map_array;
+
+    // Holds the state and parameter types shared by all texture types.
+    class TextureBase
     {
       public:
         enum class BasicFormat : Enum
@@ -115,12 +159,82 @@ namespace glpp
             SizedInternalFormat,
             CompressedInternalFormat>;
 
+        // Where the uploaded rows are found in client memory
+        // (GL_UNPACK_* pixel store state). Other than the default
+        // layout, set for the upload and restored to the previous
+        // state afterwards; the default layout issues no GL calls,
+        // and requires the pixel store state to be at its defaults.
+        struct UnpackLayout
+        {
+            // Pixels per row of the whole source image;
+            // 0 means rows are as long as the uploaded data.
+            Int32 row_length = 0;
+            Int32 skip_pixels = 0;
+            Int32 skip_rows = 0;
+            // Rows start at multiples of this many bytes (1, 2, 4 or 8).
+            Int32 alignment = 4;
+
+            [[nodiscard]] auto is_default() const noexcept -> bool
+            {
+                return row_length == 0 && skip_pixels == 0 && skip_rows == 0 && alignment == 4;
+            }
+        };
+
         struct Data
         {
             Size width;
             Size height;
             BasicFormat format = BasicFormat::rgba;
             ConstValuePtr data = nullptr;
+            UnpackLayout unpack = {};
+
+            // The width by height rectangle at x, y of this data, still pointing
+            // into the same memory; uploads it without copying.
+            [[nodiscard]] auto subimage(
+                Int32 const x,
+                Int32 const y,
+                Size const sub_width,
+                Size const sub_height) const noexcept
+                -> Data
+            {
+                auto result = *this;
+                result.width = sub_width;
+                result.height = sub_height;
+                result.unpack.row_length = unpack.row_length > 0 ? unpack.row_length : width;
+                result.unpack.skip_pixels += x;
+                result.unpack.skip_rows += y;
+                return result;
+            }
+
+            // Distance between rows in bytes, following the unpack rules of GL,
+            // for reading the data on the CPU.
+            [[nodiscard]] auto row_stride(std::size_t const pixel_size) const noexcept
+                -> std::size_t
+            {
+                auto const alignment = static_cast<std::size_t>(unpack.alignment);
+                auto const row_size = static_cast<std::size_t>(unpack.row_length > 0 ? unpack.row_length : width)
+                                      * pixel_size;
+                return (row_size + alignment - 1) / alignment * alignment;
+            }
+
+            // Offset in bytes of the first pixel to upload.
+            [[nodiscard]] auto pixel_offset(std::size_t const pixel_size) const noexcept
+                -> std::size_t
+            {
+                return static_cast<std::size_t>(unpack.skip_rows) * row_stride(pixel_size)
+                       + static_cast<std::size_t>(unpack.skip_pixels) * pixel_size;
+            }
+        };
+
+        // Only the specific (block) compressed formats can be uploaded
+        // directly; the generic ones (compressed_red etc.) are only usable
+        // as an internal format for uncompressed data.
+        struct CompressedData
+        {
+            Size width;
+            Size height;
+            CompressedInternalFormat format;
+            std::span<std::byte const> data;
         };
 
         enum class BasicFilterType : Enum
@@ -155,6 +269,8 @@ namespace glpp
         {
             WrapBehaviourType s = WrapBehaviourType::repeat;
             WrapBehaviourType t = WrapBehaviourType::repeat;
+            // Only used by 3D textures.
+            WrapBehaviourType r = WrapBehaviourType::repeat;
         };
 
         enum class SwizzleChannel : Enum
@@ -175,11 +291,81 @@ namespace glpp
             SwizzleChannel a = SwizzleChannel::alpha;
         };
 
-        Texture() noexcept = default;
+
+        // Number of components of a pixel in client memory;
+        // the packed depth_stencil format counts as a single component.
+        [[nodiscard]] static constexpr auto component_count(BasicFormat const format) noexcept
+            -> Size
+        {
+            switch (format)
+            {
+                case BasicFormat::rgba:
+                case BasicFormat::bgra:
+                    return 4;
+                case BasicFormat::rgb:
+                case BasicFormat::bgr:
+                    return 3;
+                case BasicFormat::rg:
+                    return 2;
+                default:
+                    return 1;
+            }
+        }
+
+        [[nodiscard]] auto id() const noexcept -> Id { return id_.get(); }
+
+        [[nodiscard]] auto width() const noexcept -> Size { return width_; }
+
+        [[nodiscard]] auto height() const noexcept -> Size { return height_; }
+
+      protected:
+        TextureBase() noexcept = default;
+
+        void set_size(Size const width, Size const height) noexcept
+        {
+            width_ = width;
+            height_ = height;
+        }
+
+        [[nodiscard]] static auto internal_format_enumerator(
+            InternalFormat internal_format) noexcept -> Enum;
+
+        static void do_generate_mipmap(Enum target) noexcept;
+
+        static void do_set_filter(Enum target, Filter filter) noexcept;
+
+        static void do_set_wrap_behaviour(Enum target, WrapBehaviour wrap_behaviour) noexcept;
+
+        static void do_set_swizzle(Enum target, SwizzleMask mask) noexcept;
+
+        static void do_set_max_level(Enum target, Int32 max_level) noexcept;
+
+      private:
+        struct Deleter
+        {
+            void operator()(UInt32 size, Id* data) const noexcept;
+        };
+
+        UniqueIdArray<1, Deleter> id_{glGenTextures};
+        Size width_ = {};
+        Size height_ = {};
+    };
+
+    template <TextureType type>
+    class BasicTexture : public TextureBase
+    {
+      public:
+        static constexpr auto target = static_cast<Enum>(type);
+        static constexpr auto is_2d = type == TextureType::texture_2d;
+        static constexpr auto is_layered = is_layered_texture_type_v<type>;
+        static constexpr auto is_cube_map = type == TextureType::cube_map;
+
+        BasicTexture() noexcept = default;
 
         // Sets internal format to data.format.
-        explicit Texture(Data const data) noexcept
-          : Texture{
+        explicit BasicTexture(Data const data) noexcept
+            requires is_2d
+          : BasicTexture{
               data,
               Filter{},
               WrapBehaviour{},
@@ -188,10 +374,11 @@ namespace glpp
         {
         }
 
-        Texture(
+        BasicTexture(
             Data const data,
             InternalFormat const internal_format) noexcept
-          : Texture{
+            requires is_2d
+          : BasicTexture{
               data,
               internal_format,
               Filter{},
@@ -203,36 +390,137 @@ namespace glpp
 
         // Sets internal format to data.format.
         // If filter.min is a mipmap filter, also calls generate_mipmap().
-        Texture(
+        BasicTexture(
+            Data const data,
+            Filter const filter,
+            WrapBehaviour const wrap_behaviour,
+            SwizzleMask const swizzle) noexcept
+            requires is_2d
+          : BasicTexture{
+              data,
+              data.format,
+              filter,
+              wrap_behaviour,
+              swizzle,
+          }
+        {
+        }
+
+        // If filter.min is a mipmap filter, also calls generate_mipmap().
+        BasicTexture(
             Data data,
+            InternalFormat internal_format,
             Filter filter,
             WrapBehaviour wrap_behaviour,
-            SwizzleMask swizzle) noexcept;
+            SwizzleMask swizzle) noexcept
+            requires is_2d;
 
+        // data.data has to hold depth consecutive images
+        // (or be null to only allocate the texture).
         // If filter.min is a mipmap filter, also calls generate_mipmap().
-        Texture(
+        BasicTexture(
             Data data,
+            Size depth,
             InternalFormat internal_format,
-            Filter filter,
-            WrapBehaviour wrap_behaviour,
-            SwizzleMask swizzle) noexcept;
+            Filter filter = {},
+            WrapBehaviour wrap_behaviour = {},
+            SwizzleMask swizzle = {}) noexcept
+            requires is_layered;
+
+        // Faces are loaded in the order of glpp::cube_map_faces.
+        // If filter.min is a mipmap filter, also calls generate_mipmap().
+        BasicTexture(
+            std::span<Data const, 6> faces,
+            InternalFormat internal_format,
+            Filter filter = {},
+            WrapBehaviour wrap_behaviour = {},
+            SwizzleMask swizzle = {}) noexcept
+            requires is_cube_map;
 
         // Sets internal format to data.format.
         void load(
+            Data const data,
+            Int32 const level = 0) noexcept
+            requires is_2d
+        {
+            load(data, data.format, level);
+        }
+
+        void load(
+            Data data,
+            InternalFormat internal_format,
+            Int32 level = 0) noexcept
+            requires is_2d;
+
+        // Load must be called first to allocate a big enough texture.
+        void update(
             Data data,
-            Int32 level = 0) noexcept;
+            Int32 x_offset = 0,
+            Int32 y_offset = 0,
+            Int32 level = 0) noexcept
+            requires is_2d;
+
+        // Uploads pre-compressed data with glCompressedTexImage2D.
+        void load_compressed(
+            CompressedData data,
+            Int32 level = 0) noexcept
+            requires is_2d;
+
+        // Load must be called first to allocate a big enough texture;
+        // offsets and size have to be multiples of the block size.
+        void update_compressed(
+            CompressedData data,
+            Int32 x_offset = 0,
+            Int32 y_offset = 0,
+            Int32 level = 0) noexcept
+            requires is_2d;
 
+        // data.data has to hold depth consecutive images
+        // (or be null to only allocate the texture).
+        // For cube map arrays, depth counts layer-faces (6 per cube).
         void load(
             Data data,
+            Size depth,
             InternalFormat internal_format,
-            Int32 level = 0) noexcept;
+            Int32 level = 0) noexcept
+            requires is_layered;
 
+        // Updates a single layer (depth slice for 3D textures);
+        // for cube map arrays, layer is the layer-face index (cube * 6 + face).
         // Load must be called first to allocate a big enough texture.
         void update(
+            Data data,
+            Int32 layer,
+            Int32 x_offset = 0,
+            Int32 y_offset = 0,
+            Int32 level = 0) noexcept
+            requires is_layered;
+
+        // Sets internal format to data.format.
+        void load(
+            CubeMapFace const face,
+            Data const data,
+            Int32 const level = 0) noexcept
+            requires is_cube_map
+        {
+            load(face, data, data.format, level);
+        }
+
+        void load(
+            CubeMapFace face,
+            Data data,
+            InternalFormat internal_format,
+            Int32 level = 0) noexcept
+            requires is_cube_map;
+
+        // Load must be called first to allocate a big enough face.
+        void update(
+            CubeMapFace face,
             Data data,
             Int32 x_offset = 0,
             Int32 y_offset = 0,
-            Int32 level = 0) noexcept;
+            Int32 level = 0) noexcept
+            requires is_cube_map;
 
         void set_filter(Filter filter) noexcept;
 
@@ -240,50 +528,66 @@ namespace glpp
 
         void set_swizzle(SwizzleMask mask) noexcept;
 
+        // Limits sampling to levels [0, max_level];
+        // needed when an incomplete mip chain is loaded manually.
+        void set_max_level(Int32 max_level) noexcept;
+
         // Has to be called manually after calling set_filter(),
         // or updating the texture (when using a mipmap min filter).
         void generate_mipmap() noexcept;
 
+        // Generates the mip chain with a compute shader instead,
+        // see glpp::MipDownsampler; also usable for framebuffer attachments.
+        //
+        // Throws glpp::Error, glpp::ShaderCompilationError
+        void generate_mipmap(MipDownsampler& downsampler, MipReduction reduction)
+            requires is_2d;
+
         void bind(SamplerUnit const sampler_unit = {}) const noexcept
         {
             glActiveTexture(GL_TEXTURE0 + sampler_unit.index);
-            glBindTexture(GL_TEXTURE_2D, id());
+            glBindTexture(target, id());
         }
 
         static void unbind(SamplerUnit const sampler_unit = {}) noexcept
         {
             glActiveTexture(GL_TEXTURE0 + sampler_unit.index);
-            glBindTexture(GL_TEXTURE_2D, nullid);
+            glBindTexture(target, nullid);
         }
 
-        [[nodiscard]] auto id() const noexcept -> Id { return id_.get(); }
-
-        [[nodiscard]] auto width() const noexcept -> Size { return width_; }
-
-        [[nodiscard]] auto height() const noexcept -> Size { return height_; }
-
-      private:
-        struct Deleter
+        // Number of layers (layer-faces for cube map arrays),
+        // or depth slices for 3D textures.
+        [[nodiscard]] auto depth() const noexcept -> Size
+            requires is_layered
         {
-            void operator()(UInt32 size, Id* data) const noexcept;
-        };
+            return depth_;
+        }
 
-        UniqueIdArray<1, Deleter> id_{glGenTextures};
-        Size width_ = {};
-        Size height_ = {};
+      private:
+        Size depth_ = {};
 
         void do_load(
+            Enum image_target,
             Data data,
+            Size depth,
             InternalFormat internal_format,
             Int32 level) noexcept;
 
-        static void do_generate_mipmap() noexcept;
-
-        static void do_set_filter(Filter filter) noexcept;
-
-        static void do_set_wrap_behaviour(WrapBehaviour wrap_behaviour) noexcept;
-
-        static void do_set_swizzle(SwizzleMask mask) noexcept;
+        void do_set_parameters(
+            Filter filter,
+            WrapBehaviour wrap_behaviour,
+            SwizzleMask swizzle) noexcept;
     };
 
+    extern template class BasicTexture<TextureType::texture_2d>;
+    extern template class BasicTexture<TextureType::texture_2d_array>;
+    extern template class BasicTexture<TextureType::texture_3d>;
+    extern template class BasicTexture<TextureType::cube_map>;
+    extern template class BasicTexture<TextureType::cube_map_array>;
+
+    using Texture = BasicTexture<TextureType::texture_2d>;
+    using Texture2DArray = BasicTexture<TextureType::texture_2d_array>;
+    using Texture3D = BasicTexture<TextureType::texture_3d>;
+    using CubeMapTexture = BasicTexture<TextureType::cube_map>;
+    using CubeMapArrayTexture = BasicTexture<TextureType::cube_map_array>;
 }  // namespace glpp
\ No newline at end of file
@@ -0,0 +1 @@
+#include "glpp/texture_streamer.hpp"
@@ -0,0 +1,294 @@
+#pragma once
+
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <glad/glad.h>
+#include "glpp/buffer.hpp"
+#include "glpp/primitive_types.hpp"
+#include "glpp/scoped_bind.hpp"
+#include "glpp/sync.hpp"
+#include "glpp/texture.hpp"
+
+namespace glpp
+{
+    // Streams frames into a texture through a ring of persistently mapped
+    // pixel unpack buffers. Producers (on any thread) write frames straight
+    // into buffer memory; the GL thread only issues the buffer to texture
+    // copy, which the driver performs asynchronously.
+    // Latest frame wins: submitted frames that were not uploaded yet
+    // are dropped when a newer one arrives or a producer needs a buffer.
+    //
+    // Frame rows are padded to the default unpack alignment of 4 bytes,
+    // see row_stride().
+    template <typename T>
+    class TextureStreamer
+    {
+      public:
+        class Frame
+        {
+          public:
+            Frame(Frame const&) = delete;
+
+            Frame(Frame&& other) noexcept
+              : streamer_{other.streamer_}
+              , slot_{std::exchange(other.slot_, invalid_slot)}
+              , data_{other.data_}
+            {
+            }
+
+            // Discards the frame unless it was submitted.
+            ~Frame() noexcept
+            {
+                if (slot_ != invalid_slot)
+                {
+                    streamer_->release(slot_);
+                }
+            }
+
+            auto operator=(Frame const&) = delete;
+            auto operator=(Frame&&) = delete;
+
+            [[nodiscard]] auto data() const noexcept -> std::span<T> { return data_; }
+
+          private:
+            friend class TextureStreamer;
+
+            static constexpr auto invalid_slot = static_cast<std::size_t>(-1);
+
+            TextureStreamer* streamer_;
+            std::size_t slot_;
+            std::span<T> data_;
+
+            Frame(TextureStreamer& streamer, std::size_t const slot, std::span<T> const data) noexcept
+              : streamer_{&streamer}, slot_{slot}, data_{data} {}
+        };
+
+        // The texture has to be loaded with a size of at least
+        // width + x_offset by height + y_offset.
+        TextureStreamer(
+            Texture& texture,
+            Size const width,
+            Size const height,
+            Texture::BasicFormat const format,
+            std::size_t const ring_size = 3,
+            Int32 const x_offset = 0,
+            Int32 const y_offset = 0)
+          : texture_{texture}
+          , width_{width}
+          , height_{height}
+          , format_{format}
+          , x_offset_{x_offset}
+          , y_offset_{y_offset}
+          , row_stride_{aligned_row_stride(width, format)}
+          , frame_size_{row_stride_ * static_cast<std::size_t>(height)}
+          , buffer_{static_cast<std::ptrdiff_t>(frame_size_ * ring_size), MapAccess::write}
+          , slots_(ring_size)
+        {
+            assert(ring_size > 0);
+        }
+
+        TextureStreamer(TextureStreamer const&) = delete;
+        TextureStreamer(TextureStreamer&&) = delete;
+
+        auto operator=(TextureStreamer const&) = delete;
+        auto operator=(TextureStreamer&&) = delete;
+
+        // Producer side, callable from any thread.
+        // Frames that are not passed to submit() are discarded when
+        // destroyed; the streamer has to outlive them.
+        // Returns std::nullopt if every buffer is being written or uploaded.
+        [[nodiscard]] auto try_acquire() -> std::optional<Frame>
+        {
+            auto const lock = std::lock_guard{mutex_};
+
+            if (auto const slot = find_writable_slot())
+            {
+                return take_slot(*slot);
+            }
+            return std::nullopt;
+        }
+
+        // Producer side, callable from any thread.
+        // Blocks until upload() releases a buffer.
+        [[nodiscard]] auto acquire() -> Frame
+        {
+            auto lock = std::unique_lock{mutex_};
+
+            auto slot = std::optional<std::size_t>{};
+            released_.wait(lock, [&] { return (slot = find_writable_slot()).has_value(); });
+
+            return take_slot(*slot);
+        }
+
+        void submit(Frame frame)
+        {
+            auto const lock = std::lock_guard{mutex_};
+
+            auto& slot = slots_[std::exchange(frame.slot_, Frame::invalid_slot)];
+            slot.state = SlotState::ready;
+            slot.sequence = next_sequence_++;
+        }
+
+        void discard(Frame frame) { release(std::exchange(frame.slot_, Frame::invalid_slot)); }
+
+        // GL thread side: releases buffers whose copy has completed
+        // and uploads the newest submitted frame, if any.
+        // Returns whether a frame was uploaded.
+        auto upload() -> bool
+        {
+            auto newest = std::optional<std::size_t>{};
+            {
+                auto const lock = std::lock_guard{mutex_};
+
+                for (auto i = std::size_t{0}; i < slots_.size(); ++i)
+                {
+                    auto& slot = slots_[i];
+                    if (slot.state == SlotState::uploading && slot.fence->is_signaled())
+                    {
+                        slot.fence.reset();
+                        slot.state = SlotState::free;
+                    }
+                    else if (slot.state == SlotState::ready
+                             && (!newest || slot.sequence > slots_[*newest].sequence))
+                    {
+                        newest = i;
+                    }
+                }
+
+                for (auto i = std::size_t{0}; i < slots_.size(); ++i)
+                {
+                    if (slots_[i].state == SlotState::ready && i != newest)
+                    {
+                        slots_[i].state = SlotState::free;
+                    }
+                }
+
+                if (newest)
+                {
+                    slots_[*newest].state = SlotState::uploading;
+                }
+            }
+            released_.notify_all();
+
+            if (!newest)
+            {
+                return false;
+            }
+
+            // With an unpack buffer bound, the data pointer is an offset into it.
+            auto const offset = *newest * frame_size_ * sizeof(T);
+            {
+                auto const binding = ScopedBind{buffer_};
+                texture_.update(
+                    Texture::Data{
+                        width_,
+                        height_,
+                        format_,
+                        reinterpret_cast<T const*>(offset),
+                    },
+                    x_offset_,
+                    y_offset_);
+            }
+
+            // Only the GL thread touches uploading slots.
+            slots_[*newest].fence.emplace();
+
+            return true;
+        }
+
+        [[nodiscard]] auto width() const noexcept -> Size { return width_; }
+
+        [[nodiscard]] auto height() const noexcept -> Size { return height_; }
+
+        // Distance between frame rows, in elements.
+        [[nodiscard]] auto row_stride() const noexcept -> std::size_t { return row_stride_; }
+
+      private:
+        enum class SlotState
+        {
+            free,
+            writing,
+            ready,
+            uploading,
+        };
+
+        struct Slot
+        {
+            SlotState state = SlotState::free;
+            std::size_t sequence = 0;
+            std::optional<Fence> fence;
+        };
+
+        Texture& texture_;
+        Size width_;
+        Size height_;
+        Texture::BasicFormat format_;
+        Int32 x_offset_;
+        Int32 y_offset_;
+        std::size_t row_stride_;
+        std::size_t frame_size_;
+        PixelUnpackBuffer<T> buffer_;
+
+        std::mutex mutex_;
+        std::condition_variable released_;
+        std::vector<Slot> slots_;
+        std::size_t next_sequence_ = 0;
+
+        [[nodiscard]] static auto aligned_row_stride(
+            Size const width,
+            Texture::BasicFormat const format) noexcept
+            -> std::size_t
+        {
+            constexpr auto alignment = std::size_t{4};
+
+            auto const row_size = static_cast<std::size_t>(width)
+                                  * static_cast<std::size_t>(Texture::component_count(format))
+                                  * sizeof(T);
+            auto const aligned_size = (row_size + alignment - 1) / alignment * alignment;
+
+            return (aligned_size + sizeof(T) - 1) / sizeof(T);
+        }
+
+        // Prefers free buffers, then drops the oldest unuploaded frame.
+        [[nodiscard]] auto find_writable_slot() const -> std::optional<std::size_t>
+        {
+            auto oldest_ready = std::optional<std::size_t>{};
+            for (auto i = std::size_t{0}; i < slots_.size(); ++i)
+            {
+                if (slots_[i].state == SlotState::free)
+                {
+                    return i;
+                }
+                if (slots_[i].state == SlotState::ready
+                    && (!oldest_ready || slots_[i].sequence < slots_[*oldest_ready].sequence))
+                {
+                    oldest_ready = i;
+                }
+            }
+            return oldest_ready;
+        }
+
+        [[nodiscard]] auto take_slot(std::size_t const slot) -> Frame
+        {
+            slots_[slot].state = SlotState::writing;
+
+            return Frame{*this, slot, buffer_.mapping().subspan(slot * frame_size_, frame_size_)};
+        }
+
+        void release(std::size_t const slot) noexcept
+        {
+            {
+                auto const lock = std::lock_guard{mutex_};
+                slots_[slot].state = SlotState::free;
+            }
+            released_.notify_one();
+        }
+    };
+}  // namespace glpp
@@ -0,0 +1,194 @@
+#include "glpp/thread_pool.hpp"
+
+#include <algorithm>
+#include <exception>
+
+namespace
+{
+    // Index of the queue owned by the current worker thread.
+    thread_local auto current_worker = static_cast<std::size_t>(-1);
+    thread_local auto const* current_pool = static_cast<glpp::ThreadPool const*>(nullptr);
+}  // namespace
+
+namespace glpp
+{
+    ThreadPool::ThreadPool(std::size_t thread_count)
+    {
+        if (thread_count == 0)
+        {
+            thread_count = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        queues_.reserve(thread_count);
+        for (auto i = std::size_t{0}; i < thread_count; ++i)
+        {
+            queues_.push_back(std::make_unique<Queue>());
+        }
+
+        threads_.reserve(thread_count);
+        for (auto i = std::size_t{0}; i < thread_count; ++i)
+        {
+            threads_.emplace_back([this, i] { work(i); });
+        }
+    }
+
+    ThreadPool::~ThreadPool() noexcept
+    {
+        {
+            auto const lock = std::lock_guard{sleep_mutex_};
+            stopping_ = true;
+        }
+        wake_.notify_all();
+
+        for (auto& thread : threads_)
+        {
+            thread.join();
+        }
+    }
+
+    void ThreadPool::submit(std::function<void()> task)
+    {
+        // Workers push to their own queue, keeping related work local.
+        auto const queue = current_pool == this
+                               ? current_worker
+                               : next_queue_++ % queues_.size();
+        // Counted before the push, so that a worker popping the task
+        // right away never decrements the count below zero.
+        {
+            auto const lock = std::lock_guard{sleep_mutex_};
+            ++pending_;
+        }
+        {
+            auto const lock = std::lock_guard{queues_[queue]->mutex};
+            queues_[queue]->tasks.push_back(std::move(task));
+        }
+        wake_.notify_one();
+    }
+
+    void ThreadPool::parallel_for(
+        std::size_t const count,
+        std::function<void(std::size_t begin, std::size_t end)> const& fn)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        // A few chunks per thread lets stealing even out uneven chunks.
+        auto const chunk_count = std::min(count, thread_count() * 4);
+        auto const chunk_size = (count + chunk_count - 1) / chunk_count;
+
+        auto remaining = std::atomic<std::size_t>{chunk_count};
+        auto error = std::exception_ptr{};
+        auto done_mutex = std::mutex{};
+        auto done = std::condition_variable{};
+
+        for (auto chunk = std::size_t{0}; chunk < chunk_count; ++chunk)
+        {
+            submit([&, chunk] {
+                auto const begin = std::min(count, chunk * chunk_size);
+                auto const end = std::min(count, begin + chunk_size);
+                try
+                {
+                    if (begin < end)
+                    {
+                        fn(begin, end);
+                    }
+                }
+                catch (...)
+                {
+                    auto const lock = std::lock_guard{done_mutex};
+                    if (!error)
+                    {
+                        error = std::current_exception();
+                    }
+                }
+
+                auto const lock = std::lock_guard{done_mutex};
+                if (--remaining == 0)
+                {
+                    done.notify_all();
+                }
+            });
+        }
+
+        while (remaining > 0)
+        {
+            if (!run_pending_task())
+            {
+                auto lock = std::unique_lock{done_mutex};
+                done.wait(lock, [&] { return remaining == 0; });
+            }
+        }
+
+        // The last task may still be releasing the mutex.
+        auto const lock = std::lock_guard{done_mutex};
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    auto ThreadPool::pop_task(std::size_t const queue) -> std::function<void()>
+    {
+        auto const own = current_pool == this && queue == current_worker;
+        auto const lock = std::lock_guard{queues_[queue]->mutex};
+        auto& tasks = queues_[queue]->tasks;
+
+        if (tasks.empty())
+        {
+            return {};
+        }
+
+        // Owners work LIFO for locality, thieves take the oldest task.
+        auto task = std::function<void()>{};
+        if (own)
+        {
+            task = std::move(tasks.back());
+            tasks.pop_back();
+        }
+        else
+        {
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        --pending_;
+
+        return task;
+    }
+
+    auto ThreadPool::run_pending_task() -> bool
+    {
+        auto const first = current_pool == this ? current_worker : 0;
+        for (auto i = std::size_t{0}; i < queues_.size(); ++i)
+        {
+            if (auto task = pop_task((first + i) % queues_.size()))
+            {
+                task();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ThreadPool::work(std::size_t const index)
+    {
+        current_worker = index;
+        current_pool = this;
+
+        while (true)
+        {
+            if (run_pending_task())
+            {
+                continue;
+            }
+
+            auto lock = std::unique_lock{sleep_mutex_};
+            wake_.wait(lock, [&] { return pending_ > 0 || stopping_; });
+            if (stopping_ && pending_ == 0)
+            {
+                return;
+            }
+        }
+    }
+}  // namespace glpp
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace glpp
+{
+    // Work-stealing thread pool for CPU side asset processing.
+    // Every worker owns a task queue; idle workers steal from the others.
+    class ThreadPool
+    {
+      public:
+        // 0 threads means one per hardware thread.
+        explicit ThreadPool(std::size_t thread_count = 0);
+
+        ThreadPool(ThreadPool const&) = delete;
+        ThreadPool(ThreadPool&&) = delete;
+
+        // Finishes all submitted tasks before joining the workers.
+        ~ThreadPool() noexcept;
+
+        auto operator=(ThreadPool const&) -> ThreadPool& = delete;
+        auto operator=(ThreadPool&&) -> ThreadPool& = delete;
+
+        // Tasks must not throw.
+        void submit(std::function<void()> task);
+
+        // Calls fn(begin, end) for consecutive chunks of [0, count)
+        // and blocks until all are done; the calling thread helps out,
+        // so this can also be used from inside a task.
+        //
+        // Rethrows the first exception thrown by fn.
+        void parallel_for(
+            std::size_t count,
+            std::function<void(std::size_t begin, std::size_t end)> const& fn);
+
+        [[nodiscard]] auto thread_count() const noexcept -> std::size_t
+        {
+            return threads_.size();
+        }
+
+      private:
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::unique_ptr<Queue>> queues_;
+        std::vector<std::thread> threads_;
+        std::mutex sleep_mutex_;
+        std::condition_variable wake_;
+        std::atomic<std::size_t> pending_ = 0;
+        std::atomic<std::size_t> next_queue_ = 0;
+        bool stopping_ = false;
+
+        [[nodiscard]] auto pop_task(std::size_t queue) -> std::function<void()>;
+
+        [[nodiscard]] auto run_pending_task() -> bool;
+
+        void work(std::size_t index);
+    };
+}  // namespace glpp
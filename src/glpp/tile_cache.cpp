@@ -0,0 +1,222 @@
+#include "glpp/tile_cache.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace
+{
+    using glpp::Texture;
+
+    [[nodiscard]] auto sized_format_for(Texture::BasicFormat const format) noexcept
+        -> Texture::SizedInternalFormat
+    {
+        switch (format)
+        {
+            case Texture::BasicFormat::r:
+                return Texture::SizedInternalFormat::r8;
+            case Texture::BasicFormat::rg:
+                return Texture::SizedInternalFormat::rg8;
+            case Texture::BasicFormat::rgb:
+            case Texture::BasicFormat::bgr:
+                return Texture::SizedInternalFormat::rgb8;
+            default:
+                return Texture::SizedInternalFormat::rgba8;
+        }
+    }
+}  // namespace
+
+namespace glpp
+{
+    TileCache::TileCache(TilePyramid const& pyramid, TileCacheOptions const options)
+      : TileCache{
+          pyramid.info(),
+          [&pyramid](TileId const tile) { return pyramid.tile(tile); },
+          options,
+      }
+    {
+    }
+
+    TileCache::TileCache(
+        TilePyramidInfo const& info,
+        TileLoader loader,
+        TileCacheOptions const options)
+      : info_{info}
+      , loader_{std::move(loader)}
+      , options_{options}
+      , texture_{
+            Texture::Data{info.stored_tile_size(), info.stored_tile_size(), info.format},
+            options.capacity,
+            sized_format_for(info.format),
+            Texture::Filter{Texture::BasicFilterType::linear, Texture::BasicFilterType::linear},
+            Texture::WrapBehaviour{
+                Texture::WrapBehaviourType::clamp_to_edge,
+                Texture::WrapBehaviourType::clamp_to_edge,
+                Texture::WrapBehaviourType::clamp_to_edge,
+            },
+        }
+      , entries_(static_cast<std::size_t>(info.level_count) + info.tile_count(), 0u)
+    {
+        for (auto level = Int32{0}; level < info_.level_count; ++level)
+        {
+            entries_[static_cast<std::size_t>(level)] = static_cast<UInt32>(entry({level, 0, 0}));
+        }
+
+        free_layers_.reserve(static_cast<std::size_t>(options_.capacity));
+        for (auto layer = options_.capacity - 1; layer >= 0; --layer)
+        {
+            free_layers_.push_back(layer);
+        }
+
+        index_table_.buffer_data(entries_);
+    }
+
+    auto TileCache::level_for(TileViewport const& viewport) const noexcept -> Int32
+    {
+        auto const level = std::floor(std::log2(std::max(viewport.texels_per_pixel, 1.0)));
+
+        return std::clamp(static_cast<Int32>(level), 0, info_.level_count - 1);
+    }
+
+    auto TileCache::update(TileViewport const& viewport) -> std::size_t
+    {
+        ++frame_;
+
+        auto missing = std::vector<TileId>{};
+        for (auto level = info_.level_count - 1; level >= level_for(viewport); --level)
+        {
+            request_level(viewport, level, missing);
+        }
+
+        auto dirty_begin = entries_.size();
+        auto dirty_end = std::size_t{0};
+        auto uploaded = std::size_t{0};
+        for (auto const tile : missing)
+        {
+            if (uploaded == options_.max_uploads_per_update
+                || !upload(tile, dirty_begin, dirty_end))
+            {
+                break;
+            }
+            ++uploaded;
+        }
+
+        if (dirty_begin < dirty_end)
+        {
+            index_table_.buffer_subdata(
+                std::span<UInt32 const>{entries_}.subspan(dirty_begin, dirty_end - dirty_begin),
+                static_cast<std::ptrdiff_t>(dirty_begin));
+        }
+
+        return missing.size() - uploaded;
+    }
+
+    auto TileCache::layer(TileId const tile) const -> std::optional<Int32>
+    {
+        auto const found = resident_.find(entry(tile));
+        if (found == resident_.end())
+        {
+            return std::nullopt;
+        }
+
+        return found->second.layer;
+    }
+
+    auto TileCache::entry(TileId const tile) const noexcept -> std::size_t
+    {
+        return static_cast<std::size_t>(info_.level_count) + info_.tile_index(tile);
+    }
+
+    void TileCache::request_level(
+        TileViewport const& viewport,
+        Int32 const level,
+        std::vector<TileId>& missing)
+    {
+        // Viewport in tiles of this level.
+        auto const scale = std::ldexp(1.0, -level) / static_cast<double>(info_.tile_size);
+        auto const to_tile = [](double const coordinate, Int32 const count) {
+            return std::clamp(static_cast<Int32>(std::floor(coordinate)), 0, count - 1);
+        };
+        auto const tiles_x = info_.tiles_x(level);
+        auto const tiles_y = info_.tiles_y(level);
+        auto const x_begin = to_tile(viewport.x * scale, tiles_x);
+        auto const y_begin = to_tile(viewport.y * scale, tiles_y);
+        auto const x_end = to_tile((viewport.x + viewport.width) * scale, tiles_x) + 1;
+        auto const y_end = to_tile((viewport.y + viewport.height) * scale, tiles_y) + 1;
+
+        auto const first_missing = missing.size();
+        for (auto y = y_begin; y < y_end; ++y)
+        {
+            for (auto x = x_begin; x < x_end; ++x)
+            {
+                auto const tile = TileId{level, x, y};
+                auto const found = resident_.find(entry(tile));
+                if (found == resident_.end())
+                {
+                    missing.push_back(tile);
+                    continue;
+                }
+
+                found->second.last_used = frame_;
+                lru_.splice(lru_.begin(), lru_, found->second.lru_position);
+            }
+        }
+
+        // Tiles near the centre of the viewport first.
+        auto const centre_x = (viewport.x + viewport.width / 2.0) * scale - 0.5;
+        auto const centre_y = (viewport.y + viewport.height / 2.0) * scale - 0.5;
+        auto const distance = [&](TileId const tile) {
+            return std::hypot(tile.x - centre_x, tile.y - centre_y);
+        };
+        std::sort(
+            missing.begin() + static_cast<std::ptrdiff_t>(first_missing),
+            missing.end(),
+            [&](TileId const lhs, TileId const rhs) { return distance(lhs) < distance(rhs); });
+    }
+
+    auto TileCache::upload(TileId const tile, std::size_t& dirty_begin, std::size_t& dirty_end)
+        -> bool
+    {
+        auto const mark_dirty = [&](std::size_t const index) {
+            dirty_begin = std::min(dirty_begin, index);
+            dirty_end = std::max(dirty_end, index + 1);
+        };
+
+        auto layer = Int32{};
+        if (!free_layers_.empty())
+        {
+            layer = free_layers_.back();
+            free_layers_.pop_back();
+        }
+        else
+        {
+            if (lru_.empty())
+            {
+                return false;
+            }
+
+            auto const evicted = lru_.back();
+            auto const found = resident_.find(evicted);
+            if (found->second.last_used == frame_)
+            {
+                return false;
+            }
+
+            layer = found->second.layer;
+            entries_[evicted] = 0;
+            mark_dirty(evicted);
+            resident_.erase(found);
+            lru_.pop_back();
+        }
+
+        texture_.update(loader_(tile), layer);
+
+        auto const index = entry(tile);
+        entries_[index] = static_cast<UInt32>(layer) + 1;
+        mark_dirty(index);
+        lru_.push_front(index);
+        resident_.emplace(index, Resident{layer, frame_, lru_.begin()});
+
+        return true;
+    }
+}  // namespace glpp
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "glpp/buffer.hpp"
+#include "glpp/primitive_types.hpp"
+#include "glpp/texture.hpp"
+#include "glpp/tile_pyramid.hpp"
+
+namespace glpp
+{
+    // The visible part of a tiled image.
+    struct TileViewport
+    {
+        // Visible rectangle in level 0 texels.
+        double x;
+        double y;
+        double width;
+        double height;
+        // Level 0 texels per screen pixel; 1 shows level 0 at 100%,
+        // 2 and above pick coarser levels.
+        double texels_per_pixel = 1.0;
+    };
+
+    struct TileCacheOptions
+    {
+        // Number of tiles resident on the GPU; bounds the GPU memory to
+        // capacity stored tiles. Should comfortably exceed the tiles
+        // visible at once (for a screen of w by h pixels, about
+        // (w / tile_size + 2) * (h / tile_size + 2) plus the coarsest level).
+        Int32 capacity = 256;
+        // Bounds the upload work of a single update().
+        std::size_t max_uploads_per_update = 16;
+    };
+
+    // Supplies the stored texels of a tile (see glpp::TilePyramidInfo),
+    // e.g. from a glpp::TilePyramid, or by generating tiles lazily.
+    using TileLoader = std::function<Texture::Data(TileId tile)>;
+
+    // Pages the tiles of a tile pyramid into the layers of a texture array,
+    // evicting the least recently used tiles, like a virtual texture.
+    //
+    // The index table lets shaders find resident tiles; it is a shader
+    // storage buffer of unsigned ints:
+    // - entries [0, level_count) hold the index of the first entry of each level,
+    // - each level follows with tiles_x * tiles_y entries in row-major order,
+    //   0 for tiles that are not resident, layer + 1 otherwise.
+    // Tiles of coarser levels are requested as well, so a shader can fall
+    // back to the nearest resident coarser tile while finer ones stream in;
+    // the coarsest level stays resident.
+    class TileCache
+    {
+      public:
+        // The pyramid has to outlive the cache.
+        explicit TileCache(TilePyramid const& pyramid, TileCacheOptions options = {});
+
+        TileCache(TilePyramidInfo const& info, TileLoader loader, TileCacheOptions options = {});
+
+        // The level the viewport is shown at.
+        [[nodiscard]] auto level_for(TileViewport const& viewport) const noexcept -> Int32;
+
+        // Requests the tiles covering the viewport, uploads up to
+        // max_uploads_per_update missing ones (coarse levels and tiles
+        // near the centre first) and updates the index table.
+        // Returns the number of requested tiles that are still missing;
+        // keep updating (and redrawing) while it is non-zero.
+        auto update(TileViewport const& viewport) -> std::size_t;
+
+        // Layer of a resident tile.
+        [[nodiscard]] auto layer(TileId tile) const -> std::optional<Int32>;
+
+        [[nodiscard]] auto resident_count() const noexcept -> std::size_t { return resident_.size(); }
+
+        [[nodiscard]] auto info() const noexcept -> TilePyramidInfo const& { return info_; }
+
+        [[nodiscard]] auto texture() const noexcept -> Texture2DArray const& { return texture_; }
+
+        [[nodiscard]] auto index_table() const noexcept
+            -> DynamicBuffer<UInt32, BufferType::shader_storage_buffer> const&
+        {
+            return index_table_;
+        }
+
+      private:
+        struct Resident
+        {
+            Int32 layer;
+            std::uint64_t last_used;
+            std::list<std::size_t>::iterator lru_position;
+        };
+
+        TilePyramidInfo info_;
+        TileLoader loader_;
+        TileCacheOptions options_;
+        Texture2DArray texture_;
+        DynamicBuffer<UInt32, BufferType::shader_storage_buffer> index_table_;
+        std::vector<UInt32> entries_;
+        // Keyed by table entry; the least recently used tile is at the back.
+        std::unordered_map<std::size_t, Resident> resident_;
+        std::list<std::size_t> lru_;
+        std::vector<Int32> free_layers_;
+        std::uint64_t frame_ = 0;
+
+        [[nodiscard]] auto entry(TileId tile) const noexcept -> std::size_t;
+
+        void request_level(
+            TileViewport const& viewport,
+            Int32 level,
+            std::vector<TileId>& missing);
+
+        // Returns false if every layer holds a tile requested this update.
+        [[nodiscard]] auto upload(TileId tile, std::size_t& dirty_begin, std::size_t& dirty_end) -> bool;
+    };
+}  // namespace glpp
@@ -0,0 +1,443 @@
+#include "glpp/tile_pyramid.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+#include "glpp/error.hpp"
+
+namespace
+{
+    using glpp::Int32;
+    using glpp::Size;
+    using glpp::TilePyramidInfo;
+    using glpp::UInt8;
+
+    // Header fields are little endian 32 bit integers following the magic,
+    // as is every supported platform; tiles follow at header_size.
+    constexpr auto magic = std::array<char, 8>{'G', 'L', 'P', 'P', 'T', 'I', 'L', 'E'};
+    constexpr auto version = std::uint32_t{1};
+    constexpr auto header_size = std::size_t{64};
+
+    // Keep the tile arithmetic within 64 bits, also for corrupt headers.
+    constexpr auto max_image_size = Size{1} << 30;
+    constexpr auto max_tile_size = Size{1} << 15;
+
+    enum HeaderField : std::size_t
+    {
+        version_field,
+        width_field,
+        height_field,
+        tile_size_field,
+        border_field,
+        format_field,
+        level_count_field,
+        field_count,
+    };
+
+    [[nodiscard]] auto is_valid_layout(
+        Size const width,
+        Size const height,
+        Size const tile_size,
+        Size const border) noexcept
+        -> bool
+    {
+        return width > 0 && width <= max_image_size
+               && height > 0 && height <= max_image_size
+               && tile_size > 0 && tile_size <= max_tile_size
+               && border >= 0 && border <= tile_size;
+    }
+
+    [[nodiscard]] auto level_count_for(Size width, Size height, Size const tile_size) noexcept
+        -> Int32
+    {
+        auto level_count = Int32{1};
+        while (width > tile_size || height > tile_size)
+        {
+            width = (width + 1) / 2;
+            height = (height + 1) / 2;
+            ++level_count;
+        }
+        return level_count;
+    }
+
+    [[nodiscard]] auto is_color_format(glpp::Texture::BasicFormat const format) noexcept -> bool
+    {
+        switch (format)
+        {
+            case glpp::Texture::BasicFormat::rgba:
+            case glpp::Texture::BasicFormat::bgra:
+            case glpp::Texture::BasicFormat::rgb:
+            case glpp::Texture::BasicFormat::bgr:
+            case glpp::Texture::BasicFormat::rg:
+            case glpp::Texture::BasicFormat::r:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    [[nodiscard]] auto pixel_size(TilePyramidInfo const& info) noexcept -> std::size_t
+    {
+        return static_cast<std::size_t>(glpp::Texture::component_count(info.format));
+    }
+
+    // Supplies the texels of a level kept as packed rows, like a glpp::TileSource.
+    [[nodiscard]] auto packed_source(std::vector<UInt8> const& pixels, Size const width, std::size_t const texel)
+        -> glpp::TileSource
+    {
+        return [&pixels, width, texel](Int32 const x,
+                                       Int32 const y,
+                                       Size const region_width,
+                                       Size const region_height,
+                                       std::span<UInt8> const out) {
+            auto const row_size = static_cast<std::size_t>(region_width) * texel;
+            for (auto row = Int32{0}; row < region_height; ++row)
+            {
+                std::memcpy(
+                    out.data() + static_cast<std::size_t>(row) * row_size,
+                    pixels.data()
+                        + (static_cast<std::size_t>(y + row) * static_cast<std::size_t>(width) + static_cast<std::size_t>(x))
+                              * texel,
+                    row_size);
+            }
+        };
+    }
+
+    // Box filters a level from the texels of the level below, which below
+    // supplies like a glpp::TileSource; returns the level as packed rows.
+    // Odd edges of the level below repeat their last texel.
+    [[nodiscard]] auto downsample_level(
+        TilePyramidInfo const& info,
+        Int32 const level,
+        glpp::TileSource const& below,
+        glpp::ThreadPool& pool)
+        -> std::vector<UInt8>
+    {
+        auto const texel = pixel_size(info);
+        auto const width = info.level_width(level);
+        auto const below_width = info.level_width(level - 1);
+        auto const below_height = info.level_height(level - 1);
+
+        auto const height = static_cast<std::size_t>(info.level_height(level));
+
+        auto pixels = std::vector<UInt8>(static_cast<std::size_t>(width) * height * texel);
+        pool.parallel_for(height, [&](std::size_t const begin, std::size_t const end) {
+            auto rows = std::vector<UInt8>(static_cast<std::size_t>(below_width) * 2 * texel);
+            for (auto y = static_cast<Int32>(begin); y < static_cast<Int32>(end); ++y)
+            {
+                auto const row_count = std::min(Size{2}, below_height - y * 2);
+                below(
+                    0,
+                    y * 2,
+                    below_width,
+                    row_count,
+                    std::span{rows}.first(static_cast<std::size_t>(below_width * row_count) * texel));
+
+                auto const at = [&](Int32 const i, Int32 const j, std::size_t const c) -> unsigned {
+                    auto const clamped_i = std::min(i, below_width - 1);
+                    auto const clamped_j = std::min(j, row_count - 1);
+                    return rows[static_cast<std::size_t>(clamped_j * below_width + clamped_i) * texel + c];
+                };
+
+                auto* const out = pixels.data() + static_cast<std::size_t>(y) * static_cast<std::size_t>(width) * texel;
+                for (auto i = Int32{0}; i < width; ++i)
+                {
+                    for (auto c = std::size_t{0}; c < texel; ++c)
+                    {
+                        auto const sum = at(i * 2, 0, c) + at(i * 2 + 1, 0, c) + at(i * 2, 1, c) + at(i * 2 + 1, 1, c);
+                        out[static_cast<std::size_t>(i) * texel + c] = static_cast<UInt8>((sum + 2) / 4);
+                    }
+                }
+            }
+        });
+        return pixels;
+    }
+
+    // Writes the tiles of a level, a row of tiles at a time;
+    // source supplies texels of the level like a glpp::TileSource.
+    void write_level(
+        std::ofstream& file,
+        TilePyramidInfo const& info,
+        Int32 const level,
+        glpp::TileSource const& source,
+        glpp::ThreadPool& pool)
+    {
+        auto const texel = pixel_size(info);
+        auto const stored = info.stored_tile_size();
+        auto const level_width = info.level_width(level);
+        auto const level_height = info.level_height(level);
+        auto const tiles_x = static_cast<std::size_t>(info.tiles_x(level));
+
+        auto row = std::vector<UInt8>(tiles_x * info.tile_bytes());
+        for (auto tile_y = Int32{0}; tile_y < info.tiles_y(level); ++tile_y)
+        {
+            pool.parallel_for(tiles_x, [&](std::size_t const begin, std::size_t const end) {
+                auto region = std::vector<UInt8>{};
+                for (auto tile_x = begin; tile_x < end; ++tile_x)
+                {
+                    // The stored tile clipped to the level; texels outside
+                    // repeat the edge of the level.
+                    auto const x0 = std::max(static_cast<Int32>(tile_x) * info.tile_size - info.border, Int32{0});
+                    auto const y0 = std::max(tile_y * info.tile_size - info.border, Int32{0});
+                    auto const x1 = std::min(static_cast<Int32>(tile_x + 1) * info.tile_size + info.border, level_width);
+                    auto const y1 = std::min((tile_y + 1) * info.tile_size + info.border, level_height);
+
+                    region.resize(static_cast<std::size_t>((x1 - x0) * (y1 - y0)) * texel);
+                    source(x0, y0, x1 - x0, y1 - y0, region);
+
+                    auto* const tile = row.data() + tile_x * info.tile_bytes();
+                    for (auto j = Int32{0}; j < stored; ++j)
+                    {
+                        auto const region_y = std::clamp(tile_y * info.tile_size - info.border + j, y0, y1 - 1) - y0;
+                        for (auto i = Int32{0}; i < stored; ++i)
+                        {
+                            auto const region_x = std::clamp(
+                                                      static_cast<Int32>(tile_x) * info.tile_size - info.border + i,
+                                                      x0,
+                                                      x1 - 1)
+                                                  - x0;
+                            std::memcpy(
+                                tile + static_cast<std::size_t>(j * stored + i) * texel,
+                                region.data() + static_cast<std::size_t>(region_y * (x1 - x0) + region_x) * texel,
+                                texel);
+                        }
+                    }
+                }
+            });
+
+            file.write(reinterpret_cast<char const*>(row.data()), static_cast<std::streamsize>(row.size()));
+        }
+    }
+
+    [[nodiscard]] auto read_header_field(std::span<std::byte const> const file, HeaderField const field)
+        -> std::uint32_t
+    {
+        auto value = std::uint32_t{};
+        std::memcpy(&value, file.data() + magic.size() + field * sizeof(value), sizeof(value));
+        return value;
+    }
+}  // namespace
+
+namespace glpp
+{
+    auto TilePyramidInfo::level_width(Int32 const level) const noexcept -> Size
+    {
+        return std::max(Size{1}, static_cast<Size>((static_cast<std::int64_t>(width) + (std::int64_t{1} << level) - 1) >> level));
+    }
+
+    auto TilePyramidInfo::level_height(Int32 const level) const noexcept -> Size
+    {
+        return std::max(Size{1}, static_cast<Size>((static_cast<std::int64_t>(height) + (std::int64_t{1} << level) - 1) >> level));
+    }
+
+    auto TilePyramidInfo::tiles_x(Int32 const level) const noexcept -> Int32
+    {
+        return (level_width(level) + tile_size - 1) / tile_size;
+    }
+
+    auto TilePyramidInfo::tiles_y(Int32 const level) const noexcept -> Int32
+    {
+        return (level_height(level) + tile_size - 1) / tile_size;
+    }
+
+    auto TilePyramidInfo::tile_index(TileId const tile) const noexcept -> std::size_t
+    {
+        auto index = std::size_t{0};
+        for (auto level = Int32{0}; level < tile.level; ++level)
+        {
+            index += static_cast<std::size_t>(tiles_x(level)) * static_cast<std::size_t>(tiles_y(level));
+        }
+        return index
+               + static_cast<std::size_t>(tile.y) * static_cast<std::size_t>(tiles_x(tile.level))
+               + static_cast<std::size_t>(tile.x);
+    }
+
+    auto TilePyramidInfo::tile_count() const noexcept -> std::size_t
+    {
+        return tile_index({level_count, 0, 0});
+    }
+
+    auto TilePyramidInfo::tile_bytes() const noexcept -> std::size_t
+    {
+        auto const side = static_cast<std::size_t>(stored_tile_size());
+        return side * side * pixel_size(*this);
+    }
+
+    void build_tile_pyramid(
+        std::filesystem::path const& path,
+        Size const width,
+        Size const height,
+        Texture::BasicFormat const format,
+        TileSource const& source,
+        ThreadPool& pool,
+        TilePyramidOptions const options)
+    {
+        if (!is_valid_layout(width, height, options.tile_size, options.border))
+        {
+            throw Error{fmt::format(
+                "Tile pyramids require a non-empty image of at most {0} texels per side, "
+                "a tile size of at most {1} and a border no larger than the tile size",
+                max_image_size,
+                max_tile_size)};
+        }
+        if (!is_color_format(format))
+        {
+            throw Error{"Tile pyramids require 8 bit color data"};
+        }
+
+        auto const info = TilePyramidInfo{
+            width,
+            height,
+            options.tile_size,
+            options.border,
+            format,
+            level_count_for(width, height, options.tile_size),
+        };
+
+        auto file = std::ofstream{path, std::ios::binary | std::ios::trunc};
+        if (!file)
+        {
+            throw Error{fmt::format("Failed to create tile pyramid '{0}'", path)};
+        }
+
+        auto header = std::array<char, header_size>{};
+        std::memcpy(header.data(), magic.data(), magic.size());
+        auto const fields = std::array<std::uint32_t, field_count>{
+            version,
+            static_cast<std::uint32_t>(info.width),
+            static_cast<std::uint32_t>(info.height),
+            static_cast<std::uint32_t>(info.tile_size),
+            static_cast<std::uint32_t>(info.border),
+            static_cast<std::uint32_t>(info.format),
+            static_cast<std::uint32_t>(info.level_count),
+        };
+        std::memcpy(header.data() + magic.size(), fields.data(), sizeof(fields));
+        file.write(header.data(), header.size());
+
+        write_level(file, info, 0, source, pool);
+
+        // Level 1 is filtered from the source again; each further level
+        // from the level below, which stays in memory rather than being
+        // read back from the file still open for writing.
+        auto const texel = pixel_size(info);
+        auto below = std::vector<UInt8>{};
+        for (auto level = Int32{1}; level < info.level_count; ++level)
+        {
+            auto pixels = level == 1
+                              ? downsample_level(info, level, source, pool)
+                              : downsample_level(info, level, packed_source(below, info.level_width(level - 1), texel), pool);
+            write_level(file, info, level, packed_source(pixels, info.level_width(level), texel), pool);
+            below = std::move(pixels);
+        }
+
+        file.close();
+        if (!file)
+        {
+            throw Error{fmt::format("Failed to write tile pyramid '{0}'", path)};
+        }
+    }
+
+    void build_tile_pyramid(
+        std::filesystem::path const& path,
+        Texture::Data const image,
+        ThreadPool& pool,
+        TilePyramidOptions const options)
+    {
+        if (image.data.enumerator() != GL_UNSIGNED_BYTE || !image.data)
+        {
+            throw Error{"Tile pyramids require 8 bit color data"};
+        }
+
+        auto const texel = static_cast<std::size_t>(Texture::component_count(image.format));
+        auto const stride = image.row_stride(texel);
+        auto const* const pixels = static_cast<UInt8 const*>(image.data.get()) + image.pixel_offset(texel);
+
+        auto const source = [&](Int32 const x,
+                                Int32 const y,
+                                Size const width,
+                                Size const height,
+                                std::span<UInt8> const out) {
+            auto const row_size = static_cast<std::size_t>(width) * texel;
+            for (auto row = Int32{0}; row < height; ++row)
+            {
+                std::memcpy(
+                    out.data() + static_cast<std::size_t>(row) * row_size,
+                    pixels + static_cast<std::size_t>(y + row) * stride + static_cast<std::size_t>(x) * texel,
+                    row_size);
+            }
+        };
+
+        build_tile_pyramid(path, image.width, image.height, image.format, source, pool, options);
+    }
+
+    TilePyramid::TilePyramid(std::filesystem::path const& path)
+      : file_{path}
+    {
+        auto const fail = [&](std::string_view const reason) {
+            throw TextureLoadError{fmt::format("In file '{0}': {1}", path, reason)};
+        };
+
+        auto const data = file_.data();
+        if (data.size() < header_size || std::memcmp(data.data(), magic.data(), magic.size()) != 0)
+        {
+            fail("Not a tile pyramid");
+        }
+        if (read_header_field(data, version_field) != version)
+        {
+            fail("Unsupported tile pyramid version");
+        }
+
+        info_ = TilePyramidInfo{
+            static_cast<Size>(read_header_field(data, width_field)),
+            static_cast<Size>(read_header_field(data, height_field)),
+            static_cast<Size>(read_header_field(data, tile_size_field)),
+            static_cast<Size>(read_header_field(data, border_field)),
+            static_cast<Texture::BasicFormat>(read_header_field(data, format_field)),
+            static_cast<Int32>(read_header_field(data, level_count_field)),
+        };
+
+        // Fields are read as unsigned, so out of range values wrap to negative sizes.
+        if (!is_valid_layout(info_.width, info_.height, info_.tile_size, info_.border)
+            || !is_color_format(info_.format)
+            || info_.level_count != level_count_for(info_.width, info_.height, info_.tile_size))
+        {
+            fail("Corrupted tile pyramid header");
+        }
+
+        // With the layout bounded, these fit 64 bits; dividing instead of
+        // multiplying keeps the comparison from overflowing.
+        auto tile_count = std::uint64_t{0};
+        for (auto level = Int32{0}; level < info_.level_count; ++level)
+        {
+            tile_count += static_cast<std::uint64_t>(info_.tiles_x(level))
+                          * static_cast<std::uint64_t>(info_.tiles_y(level));
+        }
+        auto const stored = static_cast<std::uint64_t>(info_.stored_tile_size());
+        auto const tile_bytes = stored * stored * pixel_size(info_);
+        if (tile_count > (data.size() - header_size) / tile_bytes)
+        {
+            fail("Truncated tile pyramid");
+        }
+    }
+
+    auto TilePyramid::tile(TileId const tile) const noexcept -> Texture::Data
+    {
+        auto const* const pixels = reinterpret_cast<UInt8 const*>(file_.data().data() + header_size)
+                                   + info_.tile_index(tile) * info_.tile_bytes();
+
+        return Texture::Data{
+            info_.stored_tile_size(),
+            info_.stored_tile_size(),
+            info_.format,
+            pixels,
+            Texture::UnpackLayout{.alignment = 1},
+        };
+    }
+}  // namespace glpp
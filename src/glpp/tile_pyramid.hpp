@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <span>
+
+#include "glpp/mapped_file.hpp"
+#include "glpp/primitive_types.hpp"
+#include "glpp/texture.hpp"
+#include "glpp/thread_pool.hpp"
+
+namespace glpp
+{
+    struct TileId
+    {
+        Int32 level;
+        Int32 x;
+        Int32 y;
+
+        [[nodiscard]] friend auto operator==(TileId const&, TileId const&) noexcept -> bool = default;
+    };
+
+    // Layout of a tile pyramid: level 0 is the full image, every further
+    // level halves it (rounding up) until it fits a single tile.
+    // Tiles are stored with a border of texels repeated from their
+    // neighbours (or the image edge), so that they can be filtered
+    // linearly on their own.
+    struct TilePyramidInfo
+    {
+        Size width;
+        Size height;
+        Size tile_size;
+        Size border;
+        // 8 bit components.
+        Texture::BasicFormat format;
+        Int32 level_count;
+
+        [[nodiscard]] auto level_width(Int32 level) const noexcept -> Size;
+
+        [[nodiscard]] auto level_height(Int32 level) const noexcept -> Size;
+
+        [[nodiscard]] auto tiles_x(Int32 level) const noexcept -> Int32;
+
+        [[nodiscard]] auto tiles_y(Int32 level) const noexcept -> Int32;
+
+        // Index of the tile among all tiles of all levels, level 0 first,
+        // row-major within a level.
+        [[nodiscard]] auto tile_index(TileId tile) const noexcept -> std::size_t;
+
+        [[nodiscard]] auto tile_count() const noexcept -> std::size_t;
+
+        // Side of a stored tile, including the border.
+        [[nodiscard]] auto stored_tile_size() const noexcept -> Size
+        {
+            return tile_size + 2 * border;
+        }
+
+        // Stored tiles are tightly packed (unpack alignment 1).
+        [[nodiscard]] auto tile_bytes() const noexcept -> std::size_t;
+    };
+
+    struct TilePyramidOptions
+    {
+        Size tile_size = 256;
+        Size border = 1;
+    };
+
+    // Fills pixels with the width by height rectangle at x, y of the
+    // level 0 image, as tightly packed rows. Called from pool threads.
+    using TileSource = std::function<void(
+        Int32 x,
+        Int32 y,
+        Size width,
+        Size height,
+        std::span<UInt8> pixels)>;
+
+    // Builds a tile pyramid file offline. Level 0 tiles are read from
+    // the source, each further level is box filtered from the level
+    // below, level 1 from the source; so besides a row of tiles, memory
+    // holds two levels from level 1 up, about a quarter of the image.
+    // The tiles of a row are built in parallel on the pool.
+    //
+    // Throws glpp::Error, std::filesystem::filesystem_error
+    void build_tile_pyramid(
+        std::filesystem::path const& path,
+        Size width,
+        Size height,
+        Texture::BasicFormat format,
+        TileSource const& source,
+        ThreadPool& pool,
+        TilePyramidOptions options = {});
+
+    // Builds the pyramid of an 8 bit image in memory.
+    //
+    // Throws glpp::Error, std::filesystem::filesystem_error
+    void build_tile_pyramid(
+        std::filesystem::path const& path,
+        Texture::Data image,
+        ThreadPool& pool,
+        TilePyramidOptions options = {});
+
+    // A memory-mapped tile pyramid file; tiles are paged in
+    // by the OS as they are accessed.
+    class TilePyramid
+    {
+      public:
+        // Throws glpp::TextureLoadError, std::filesystem::filesystem_error
+        explicit TilePyramid(std::filesystem::path const& path);
+
+        [[nodiscard]] auto info() const noexcept -> TilePyramidInfo const& { return info_; }
+
+        // Ready to be uploaded, pointing into the mapping.
+        [[nodiscard]] auto tile(TileId tile) const noexcept -> Texture::Data;
+
+      private:
+        MappedFile file_;
+        TilePyramidInfo info_;
+    };
+}  // namespace glpp
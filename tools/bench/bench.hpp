@@ -0,0 +1,40 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace glpp::bench
+{
+    // The fastest of several runs of fn, in milliseconds;
+    // the minimum filters out scheduling noise.
+    template <typename Fn>
+    [[nodiscard]] auto best_time_ms(Fn&& fn, int const runs = 5) -> double
+    {
+        auto best = std::numeric_limits<double>::infinity();
+        for (auto run = 0; run < runs; ++run)
+        {
+            auto const begin = std::chrono::steady_clock::now();
+            fn();
+            auto const end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::milli>(end - begin).count());
+        }
+
+        return best;
+    }
+
+    template <typename T>
+    inline T volatile sink = T{};
+
+    // Keeps the compiler from dropping the computation of a value.
+    template <typename T>
+    void keep(T const& value) noexcept
+    {
+        sink<T> = value;
+    }
+
+    void run_pixel_conversion_bench();
+    void run_program_reflection_bench();
+    void run_shader_scan_bench();
+    void run_shader_source_cache_bench();
+}  // namespace glpp::bench
@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#include "bench.hpp"
+
+namespace
+{
+    struct Benchmark
+    {
+        std::string_view name;
+        void (*run)();
+    };
+
+    constexpr auto benchmarks = std::array{
+        Benchmark{"pixel_conversion", glpp::bench::run_pixel_conversion_bench},
+        Benchmark{"program_reflection", glpp::bench::run_program_reflection_bench},
+        Benchmark{"shader_scan", glpp::bench::run_shader_scan_bench},
+        Benchmark{"shader_source_cache", glpp::bench::run_shader_source_cache_bench},
+    };
+
+    constexpr auto usage = std::string_view{
+        "Usage: glpp_bench [benchmark]...\n"
+        "Runs the named benchmarks, or all of them. Benchmarks:\n",
+    };
+}  // namespace
+
+auto main(int const argc, char const* const* const argv) noexcept -> int
+{
+    auto const arguments = std::vector<std::string_view>(argv + 1, argv + argc);
+    if (!arguments.empty() && arguments[0] == "--help")
+    {
+        std::cerr << usage;
+        for (auto const& benchmark : benchmarks)
+        {
+            std::cerr << "  " << benchmark.name << "\n";
+        }
+        return 1;
+    }
+
+    for (auto const& argument : arguments)
+    {
+        if (std::ranges::find(benchmarks, argument, &Benchmark::name) == benchmarks.end())
+        {
+            std::cerr << "Unknown benchmark " << argument << "\n";
+            return 1;
+        }
+    }
+
+    try
+    {
+        for (auto const& benchmark : benchmarks)
+        {
+            if (arguments.empty() || std::ranges::find(arguments, benchmark.name) != arguments.end())
+            {
+                benchmark.run();
+            }
+        }
+    }
+    catch (std::exception const& error)
+    {
+        std::cerr << error.what() << "\n";
+        return 2;
+    }
+
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <glpp/pixel_conversion.hpp>
+#include "bench.hpp"
+
+namespace
+{
+    // A 3840 by 2160 frame.
+    constexpr auto pixel_count = std::size_t{3840 * 2160};
+
+    constexpr auto levels = std::array{
+        std::pair{glpp::SimdLevel::scalar, std::string_view{"scalar"}},
+        std::pair{glpp::SimdLevel::sse4_1, std::string_view{"sse4.1"}},
+        std::pair{glpp::SimdLevel::avx2, std::string_view{"avx2"}},
+        std::pair{glpp::SimdLevel::avx512, std::string_view{"avx512"}},
+        std::pair{glpp::SimdLevel::neon, std::string_view{"neon"}},
+    };
+}  // namespace
+
+namespace glpp::bench
+{
+    void run_pixel_conversion_bench()
+    {
+        auto rgb = std::vector<UInt8>(pixel_count * 3);
+        auto rgba = std::vector<UInt8>(pixel_count * 4);
+        auto rgba_out = std::vector<UInt8>(pixel_count * 4);
+        auto unorm16 = std::vector<UInt16>(pixel_count * 4);
+        auto floats = std::vector<Float32>(pixel_count * 4);
+        auto halves = std::vector<UInt16>(pixel_count * 4);
+        for (auto i = std::size_t{0}; i < rgba.size(); ++i)
+        {
+            rgba[i] = static_cast<UInt8>(i * 7);
+            unorm16[i] = static_cast<UInt16>(i * 2654435761u);
+            floats[i] = static_cast<Float32>(i % 1000) * 0.37f - 100.0f;
+        }
+        for (auto i = std::size_t{0}; i < rgb.size(); ++i)
+        {
+            rgb[i] = static_cast<UInt8>(i * 13);
+        }
+
+        fmt::print("pixel conversion, 3840x2160 frames (ms)\n");
+        fmt::print("{0:<8} {1:>9} {2:>9} {3:>9} {4:>9} {5:>9}\n", "", "rgb>rgba", "swap", "premul", "u16>u8", "half");
+
+        auto const detected = simd_level();
+        for (auto const& [level, name] : levels)
+        {
+            if (set_simd_level(level) != level)
+            {
+                continue;
+            }
+
+            auto const times = std::array{
+                best_time_ms([&] { rgb_to_rgba(rgb, rgba_out); }),
+                best_time_ms([&] { swap_red_blue(rgba, rgba_out); }),
+                best_time_ms([&] { premultiply_alpha(rgba, rgba_out); }),
+                best_time_ms([&] { unorm16_to_unorm8(unorm16, rgba_out); }),
+                best_time_ms([&] { float_to_half(floats, halves); }),
+            };
+            keep(rgba_out[pixel_count]);
+            keep(halves[pixel_count]);
+
+            fmt::print(
+                "{0:<8} {1:>9.2f} {2:>9.2f} {3:>9.2f} {4:>9.2f} {5:>9.2f}\n",
+                name,
+                times[0],
+                times[1],
+                times[2],
+                times[3],
+                times[4]);
+        }
+        set_simd_level(detected);
+    }
+}  // namespace glpp::bench
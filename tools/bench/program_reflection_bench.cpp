@@ -0,0 +1,80 @@
+#include <string>
+
+#include <fmt/format.h>
+#include <glpp/headless/headless_context.hpp>
+#include <glpp/shader_program.hpp>
+#include "bench.hpp"
+
+namespace
+{
+    constexpr auto lookup_count = 1000000;
+
+    constexpr auto vertex_source = R"(#version 450 core
+layout(location = 0) in vec3 position;
+uniform mat4 model;
+uniform mat4 view_projection;
+uniform vec4 offsets[8];
+void main()
+{
+    gl_Position = view_projection * model * vec4(position + offsets[gl_VertexID % 8].xyz, 1.0);
+}
+)";
+
+    constexpr auto fragment_source = R"(#version 450 core
+struct Light
+{
+    vec3 color;
+    float power;
+};
+uniform Light lights[4];
+uniform vec4 tint;
+out vec4 color;
+void main()
+{
+    color = tint * vec4(lights[3].color * lights[1].power, 1.0);
+}
+)";
+}  // namespace
+
+namespace glpp::bench
+{
+    void run_program_reflection_bench()
+    {
+        auto const context = headless::HeadlessContext{};
+        Shader const shaders[] = {
+            Shader{ShaderType::vertex_shader, std::string{vertex_source}},
+            Shader{ShaderType::fragment_shader, std::string{fragment_source}},
+        };
+        auto const program = ShaderProgram{shaders};
+        auto const runtime_name = std::string{"lights[1].power"};
+
+        fmt::print("uniform location lookup, {0} lookups (ms)\n", lookup_count);
+        fmt::print(
+            "{0:<24} {1:>9.2f}\n",
+            "reflection, literal",
+            best_time_ms([&] {
+                for (auto i = 0; i < lookup_count; ++i)
+                {
+                    keep(program.uniform_location("tint")->value);
+                }
+            }));
+        fmt::print(
+            "{0:<24} {1:>9.2f}\n",
+            "reflection, element",
+            best_time_ms([&] {
+                for (auto i = 0; i < lookup_count; ++i)
+                {
+                    keep(program.uniform_location(runtime_name)->value);
+                }
+            }));
+        fmt::print(
+            "{0:<24} {1:>9.2f}\n",
+            "glGetUniformLocation",
+            best_time_ms([&] {
+                for (auto i = 0; i < lookup_count; ++i)
+                {
+                    keep(glGetUniformLocation(program.id(), "tint"));
+                }
+            }));
+    }
+}  // namespace glpp::bench
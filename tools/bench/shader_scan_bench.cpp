@@ -0,0 +1,89 @@
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <glpp/embedded_shader_filesystem.hpp>
+#include <glpp/shader_source_cache.hpp>
+#include "bench.hpp"
+
+namespace
+{
+    constexpr auto file_count = 10000;
+    constexpr auto file_lines = 40;
+    constexpr auto file_includes = 4;
+
+    // The scan read_shader_source_file() replaced: a line at a time,
+    // with a string stream per line to split off the first token.
+    [[nodiscard]] auto scan_by_line(std::istream& file) -> glpp::ShaderSourceFile
+    {
+        auto source_file = glpp::ShaderSourceFile{};
+        auto line = std::string{};
+        auto token = std::string{};
+        auto line_no = 1;
+        while (std::getline(file, line))
+        {
+            auto line_stream = std::istringstream{line};
+            if (line_stream >> token && token == "#include" && line_stream >> token)
+            {
+                source_file.includes.push_back(glpp::ShaderInclude{token.substr(1, token.size() - 2), line_no});
+                line.clear();
+            }
+
+            source_file.fragment += line;
+            source_file.fragment += "\n";
+            ++line_no;
+        }
+
+        return source_file;
+    }
+}  // namespace
+
+namespace glpp::bench
+{
+    void run_shader_scan_bench()
+    {
+        auto paths = std::vector<std::string>{};
+        auto contents = std::vector<std::string>{};
+        for (auto file = 0; file < file_count; ++file)
+        {
+            auto& text = contents.emplace_back();
+            for (auto include = 0; include < file_includes; ++include)
+            {
+                text += fmt::format("#include \"common{0}.glsl\"\n", include);
+            }
+            for (auto line = file_includes; line < file_lines; ++line)
+            {
+                text += fmt::format("    float value{0} = texture(source, uv + vec2({0}.0)).r;\n", line);
+            }
+            paths.push_back(fmt::format("shader{0}.glsl", file));
+        }
+
+        auto files = std::vector<EmbeddedShaderFile>{};
+        for (auto file = std::size_t{0}; file < paths.size(); ++file)
+        {
+            files.push_back(EmbeddedShaderFile{paths[file], contents[file]});
+        }
+        auto const filesystem = EmbeddedShaderFilesystem{files};
+
+        fmt::print("shader include scan, {0} files of {1} lines (ms)\n", file_count, file_lines);
+        fmt::print(
+            "{0:<12} {1:>9.2f}\n",
+            "by line",
+            best_time_ms([&] {
+                for (auto const& path : paths)
+                {
+                    keep(scan_by_line(*filesystem.open(path)).fragment.size());
+                }
+            }));
+        fmt::print(
+            "{0:<12} {1:>9.2f}\n",
+            "whole file",
+            best_time_ms([&] {
+                for (auto const& path : paths)
+                {
+                    keep(read_shader_source_file(path, filesystem).fragment.size());
+                }
+            }));
+    }
+}  // namespace glpp::bench
@@ -0,0 +1,126 @@
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <fmt/format.h>
+#include <glpp/load_shader.hpp>
+#include <glpp/shader_source_cache.hpp>
+#include "bench.hpp"
+
+namespace
+{
+    constexpr auto shader_count = 1000;
+    constexpr auto include_count = 50;
+    constexpr auto header_lines = 40;
+
+    // Removed with its contents when destroyed.
+    class TemporaryDirectory
+    {
+      public:
+        TemporaryDirectory()
+          : path_{std::filesystem::temp_directory_path() / "glpp_bench_shader_sources"}
+        {
+            std::filesystem::remove_all(path_);
+            std::filesystem::create_directories(path_ / "include");
+        }
+
+        TemporaryDirectory(TemporaryDirectory const&) = delete;
+        auto operator=(TemporaryDirectory const&) -> TemporaryDirectory& = delete;
+
+        ~TemporaryDirectory() noexcept
+        {
+            auto error = std::error_code{};
+            std::filesystem::remove_all(path_, error);
+        }
+
+        [[nodiscard]] auto path() const noexcept -> std::filesystem::path const& { return path_; }
+
+      private:
+        std::filesystem::path path_;
+    };
+
+    void write_file(std::filesystem::path const& path, std::string const& contents)
+    {
+        auto file = std::ofstream{path, std::ios::binary | std::ios::trunc};
+        file << contents;
+    }
+
+    // Every shader includes all the headers.
+    [[nodiscard]] auto write_tree(std::filesystem::path const& root)
+        -> std::vector<std::filesystem::path>
+    {
+        for (auto header = 0; header < include_count; ++header)
+        {
+            auto contents = std::string{};
+            for (auto line = 0; line < header_lines; ++line)
+            {
+                contents += fmt::format("float header{0}_{1}(float x) {{ return x * {1}.0; }}\n", header, line);
+            }
+            write_file(root / "include" / fmt::format("header{0}.glsl", header), contents);
+        }
+
+        auto shaders = std::vector<std::filesystem::path>{};
+        for (auto shader = 0; shader < shader_count; ++shader)
+        {
+            auto contents = std::string{};
+            for (auto header = 0; header < include_count; ++header)
+            {
+                contents += fmt::format("#include \"header{0}.glsl\"\n", header);
+            }
+            contents += fmt::format("out vec4 color;\nvoid main() {{ color = vec4({0}.0); }}\n", shader);
+
+            shaders.push_back(root / fmt::format("shader{0}.frag", shader));
+            write_file(shaders.back(), contents);
+        }
+
+        return shaders;
+    }
+}  // namespace
+
+namespace glpp::bench
+{
+    void run_shader_source_cache_bench()
+    {
+        auto const directory = TemporaryDirectory{};
+        auto const shaders = write_tree(directory.path());
+        auto const include_directories = std::vector{directory.path() / "include"};
+        auto const version = GlslVersion{};
+
+        auto const resolve_all = [&](ShaderSourceCache* const cache) {
+            auto size = std::size_t{0};
+            for (auto const& shader : shaders)
+            {
+                auto const sources = resolve_shader_sources(
+                    version,
+                    std::span{&shader, 1},
+                    include_directories,
+                    {},
+                    DefaultShaderFilesystem{},
+                    cache);
+                size += sources.back().size();
+            }
+            keep(size);
+        };
+
+        auto warm_cache = ShaderSourceCache{};
+        resolve_all(&warm_cache);
+
+        fmt::print(
+            "shader source cache, {0} shaders x {1} includes (ms)\n",
+            shader_count,
+            include_count);
+        fmt::print("{0:<12} {1:>9.2f}\n", "uncached", best_time_ms([&] { resolve_all(nullptr); }, 3));
+        fmt::print(
+            "{0:<12} {1:>9.2f}\n",
+            "cold cache",
+            best_time_ms(
+                [&] {
+                    auto cache = ShaderSourceCache{};
+                    resolve_all(&cache);
+                },
+                3));
+        fmt::print("{0:<12} {1:>9.2f}\n", "warm cache", best_time_ms([&] { resolve_all(&warm_cache); }, 3));
+    }
+}  // namespace glpp::bench
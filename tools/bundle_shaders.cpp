@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <glpp/config/config.hpp>
+#include <glpp/shader_bundle.hpp>
+#include <glpp/shader_source_cache.hpp>
+#include <nlohmann/json.hpp>
+
+namespace
+{
+    constexpr auto usage = std::string_view{
+        "Usage: glpp_bundle_shaders <output> [--depfile <depfile>] <program config>...\n"
+        "Resolves the sources of each shader program config and writes them\n"
+        "into a shader bundle; programs are named after their config files.\n",
+    };
+
+    // Escapes a path for a Makefile style depfile.
+    [[nodiscard]] auto escape(std::string const& path) -> std::string
+    {
+        auto escaped = std::string{};
+        for (auto const c : path)
+        {
+            if (c == ' ' || c == '#')
+            {
+                escaped += '\\';
+            }
+            else if (c == '$')
+            {
+                escaped += '$';
+            }
+            escaped += c;
+        }
+
+        return escaped;
+    }
+
+    void write_depfile(
+        std::filesystem::path const& depfile,
+        std::filesystem::path const& output,
+        std::vector<std::filesystem::path> dependencies)
+    {
+        std::ranges::sort(dependencies);
+        dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+
+        auto file = std::ofstream{depfile};
+        file << escape(output.generic_string()) << ":";
+        for (auto const& dependency : dependencies)
+        {
+            file << " \\\n  " << escape(dependency.generic_string());
+        }
+        file << "\n";
+
+        if (!file)
+        {
+            throw std::runtime_error{"Failed to write depfile " + depfile.string()};
+        }
+    }
+}  // namespace
+
+auto main(int const argc, char const* const* const argv) noexcept -> int
+{
+    auto const arguments = std::vector<std::string_view>(argv + 1, argv + argc);
+    if (arguments.empty() || arguments[0] == "--help")
+    {
+        std::cerr << usage;
+        return 1;
+    }
+
+    auto const output = std::filesystem::path{arguments[0]};
+    auto depfile = std::optional<std::filesystem::path>{};
+    auto configs = std::vector<std::filesystem::path>{};
+    for (auto i = std::size_t{1}; i < arguments.size(); ++i)
+    {
+        if (arguments[i] == "--depfile" && i + 1 < arguments.size())
+        {
+            depfile = arguments[++i];
+        }
+        else
+        {
+            configs.emplace_back(arguments[i]);
+        }
+    }
+
+    try
+    {
+        // Include files shared between programs are parsed once.
+        auto source_cache = glpp::ShaderSourceCache{};
+        auto dependencies = std::vector<std::filesystem::path>{};
+        auto programs = std::vector<glpp::ShaderBundleProgram>{};
+
+        for (auto const& config_path : configs)
+        {
+            auto config_file = std::ifstream{config_path};
+            if (!config_file.is_open())
+            {
+                std::cerr << "Could not open shader config " << config_path << "\n";
+                return 1;
+            }
+            auto const config = nlohmann::json::parse(config_file)
+                                    .get<glpp::config::ShaderProgramConfig>();
+
+            dependencies.push_back(std::filesystem::canonical(config_path));
+            programs.push_back(glpp::ShaderBundleProgram{
+                config_path.stem().string(),
+                glpp::config::resolve_program_sources(
+                    config,
+                    glpp::DefaultShaderFilesystem{},
+                    &source_cache,
+                    &dependencies),
+            });
+        }
+
+        glpp::write_shader_bundle(output, programs);
+        if (depfile)
+        {
+            write_depfile(*depfile, output, std::move(dependencies));
+        }
+    }
+    catch (std::exception const& error)
+    {
+        std::cerr << error.what() << "\n";
+        return 2;
+    }
+
+    return 0;
+}